@@ -0,0 +1,499 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics.h"
+#include "trace.h"
+#include "tracking.h"
+
+#ifndef BENCH_BUILD_TYPE
+#define BENCH_BUILD_TYPE "unknown"
+#endif
+
+// Minimal benchmark harness in the spirit of Google Benchmark:
+//
+//   static void BM_Thing(bench::State& state) {
+//       auto input = makeInput(state.range(0));
+//       for (auto _ : state)
+//           bench::doNotOptimize(process(input));
+//   }
+//   BENCHMARK(BM_Thing)->range(8, 4096);
+//
+// Results print as a table, or as JSON in Google Benchmark's layout with
+// --format=json; --out=<file> additionally writes the JSON to a file so a
+// run can be archived and compared against a later one. In a
+// POLINOM_METRICS build, --metrics=<file> writes the counters and latency
+// histograms gathered over the whole run as JSON. --trace=<file> records
+// trace spans during the run and writes them as a Chrome trace; the ring
+// buffers keep only the most recent spans of each thread.
+// --allocations=<file> routes the default pmr resource through a
+// TrackingResource for the run and writes its per-operation report (which
+// is only broken down by operation in a POLINOM_METRICS build).
+namespace bench {
+
+// Forces `value` to be computed and treats its memory as read. Publishing
+// only the address would let the compiler skip computing a temporary that
+// nothing reads.
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+class State {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<int64_t> args;
+    uint64_t maxIterations;
+    Clock::time_point started;
+    double elapsed = 0.0;
+    bool running = false;
+    int64_t bytes = 0;
+    int64_t items = 0;
+
+public:
+    std::map<std::string, double> counters;
+
+    State(std::vector<int64_t> arguments, uint64_t iterations)
+        : args(std::move(arguments)), maxIterations(iterations) {}
+
+    int64_t range(size_t index = 0) const {
+        if (index >= args.size()) {
+            std::cerr << "bench: benchmark argument " << index << " was not registered" << std::endl;
+            std::abort();
+        }
+        return args[index];
+    }
+
+    uint64_t iterations() const { return maxIterations; }
+    double seconds() const { return elapsed; }
+    int64_t bytesProcessed() const { return bytes; }
+    int64_t itemsProcessed() const { return items; }
+
+    void setBytesProcessed(int64_t n) { bytes = n; }
+    void setItemsProcessed(int64_t n) { items = n; }
+
+    void pauseTiming() {
+        if (running) {
+            elapsed += std::chrono::duration<double>(Clock::now() - started).count();
+            running = false;
+        }
+    }
+
+    void resumeTiming() {
+        if (!running) {
+            started = Clock::now();
+            running = true;
+        }
+    }
+
+    // The user-provided destructor makes `for (auto _ : state)` count as a
+    // use of `_`, so the loops compile cleanly under -Wunused.
+    struct Value {
+        ~Value() {}
+    };
+
+    class Iterator {
+        State* state;
+        uint64_t left;
+
+    public:
+        Iterator(State* s, uint64_t n) : state(s), left(n) {}
+
+        Value operator*() const { return Value(); }
+
+        Iterator& operator++() {
+            --left;
+            return *this;
+        }
+
+        bool operator!=(const Iterator&) const {
+            if (left != 0)
+                return true;
+            state->pauseTiming();
+            return false;
+        }
+    };
+
+    Iterator begin() {
+        resumeTiming();
+        return Iterator(this, maxIterations);
+    }
+
+    Iterator end() { return Iterator(this, 0); }
+};
+
+class Benchmark {
+    std::string benchName;
+    std::function<void(State&)> body;
+    std::vector<std::vector<int64_t>> argSets;
+
+public:
+    Benchmark(std::string name, std::function<void(State&)> fn) : benchName(std::move(name)), body(std::move(fn)) {}
+
+    Benchmark* arg(int64_t a) {
+        argSets.push_back({ a });
+        return this;
+    }
+
+    Benchmark* args(std::vector<int64_t> a) {
+        argSets.push_back(std::move(a));
+        return this;
+    }
+
+    // lo, lo*multiplier, ..., hi (hi always included).
+    Benchmark* range(int64_t lo, int64_t hi, int64_t multiplier = 8) {
+        for (int64_t a = lo; a < hi; a *= multiplier)
+            argSets.push_back({ a });
+        argSets.push_back({ hi });
+        return this;
+    }
+
+    Benchmark* denseRange(int64_t lo, int64_t hi, int64_t step = 1) {
+        for (int64_t a = lo; a <= hi; a += step)
+            argSets.push_back({ a });
+        return this;
+    }
+
+    // Lets a helper register a custom grid of argument sets.
+    Benchmark* apply(void (*fn)(Benchmark*)) {
+        fn(this);
+        return this;
+    }
+
+    const std::string& name() const { return benchName; }
+    const std::vector<std::vector<int64_t>>& argumentSets() const { return argSets; }
+    void run(State& state) const { body(state); }
+};
+
+inline std::vector<std::unique_ptr<Benchmark>>& registry() {
+    static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+    return benchmarks;
+}
+
+inline Benchmark* registerBenchmark(const std::string& name, std::function<void(State&)> fn) {
+    registry().push_back(std::make_unique<Benchmark>(name, std::move(fn)));
+    return registry().back().get();
+}
+
+inline std::string instanceName(const Benchmark& b, const std::vector<int64_t>& args) {
+    std::string name = b.name();
+    for (int64_t a : args)
+        name += "/" + std::to_string(a);
+    return name;
+}
+
+inline State runInstance(const Benchmark& b, const std::vector<int64_t>& args, double minTime) {
+    uint64_t iterations = 1;
+    for (;;) {
+        State state(args, iterations);
+        b.run(state);
+        if (state.seconds() >= minTime || iterations >= (uint64_t(1) << 40))
+            return state;
+        double scale = state.seconds() > 0.0 ? 1.4 * minTime / state.seconds() : 10.0;
+        if (scale > 10.0) scale = 10.0;
+        if (scale < 2.0) scale = 2.0;
+        iterations = static_cast<uint64_t>(iterations * scale);
+    }
+}
+
+struct Result {
+    std::string name;       // with an aggregate suffix, e.g. "BM_Add/8_mean"
+    std::string runName;    // the instance the result belongs to
+    std::string aggregate;  // "mean", "median", "stddev" or empty for a run
+    int repetitions = 1;
+    int repetitionIndex = 0;
+    uint64_t iterations = 0;
+    double realTime = 0.0;  // ns per iteration
+    double bytesPerSecond = 0.0;
+    double itemsPerSecond = 0.0;
+    std::map<std::string, double> counters;
+};
+
+inline Result makeResult(const std::string& name, const State& s) {
+    Result r;
+    r.name = r.runName = name;
+    r.iterations = s.iterations();
+    r.realTime = s.seconds() / s.iterations() * 1e9;
+    if (s.bytesProcessed() > 0)
+        r.bytesPerSecond = s.bytesProcessed() / s.seconds();
+    if (s.itemsProcessed() > 0)
+        r.itemsPerSecond = s.itemsProcessed() / s.seconds();
+    r.counters = s.counters;
+    return r;
+}
+
+// Mean, median and sample standard deviation of every field over the
+// repetitions of one instance.
+inline std::vector<Result> aggregateResults(const std::vector<Result>& runs) {
+    auto statistic = [&](const std::string& kind, auto field) {
+        std::vector<double> v;
+        for (const Result& r : runs)
+            v.push_back(field(r));
+        double mean = 0.0;
+        for (double x : v)
+            mean += x / v.size();
+        if (kind == "mean")
+            return mean;
+        if (kind == "median") {
+            std::sort(v.begin(), v.end());
+            return v.size() % 2 ? v[v.size() / 2] : (v[v.size() / 2 - 1] + v[v.size() / 2]) / 2;
+        }
+        double sq = 0.0;
+        for (double x : v)
+            sq += (x - mean) * (x - mean);
+        return v.size() > 1 ? std::sqrt(sq / (v.size() - 1)) : 0.0;
+    };
+    std::vector<Result> out;
+    for (const char* kind : { "mean", "median", "stddev" }) {
+        Result a;
+        a.runName = runs.front().runName;
+        a.name = a.runName + "_" + kind;
+        a.aggregate = kind;
+        a.repetitions = static_cast<int>(runs.size());
+        a.iterations = runs.front().iterations;
+        a.realTime = statistic(kind, [](const Result& r) { return r.realTime; });
+        a.bytesPerSecond = statistic(kind, [](const Result& r) { return r.bytesPerSecond; });
+        a.itemsPerSecond = statistic(kind, [](const Result& r) { return r.itemsPerSecond; });
+        for (const auto& c : runs.front().counters)
+            a.counters[c.first] = statistic(kind, [&](const Result& r) { return r.counters.at(c.first); });
+        out.push_back(a);
+    }
+    return out;
+}
+
+inline void printHeader(std::ostream& out) {
+    out << std::left << std::setw(48) << "Benchmark" << std::right
+        << std::setw(17) << "Time" << std::setw(12) << "Iterations" << std::endl;
+}
+
+inline void printResult(std::ostream& out, const Result& r) {
+    out << std::left << std::setw(48) << r.name << std::right
+        << std::setw(14) << std::fixed << std::setprecision(1) << r.realTime << " ns"
+        << std::setw(12) << r.iterations;
+    if (r.bytesPerSecond > 0)
+        out << "  " << std::setprecision(2) << r.bytesPerSecond / (1 << 20) << " MiB/s";
+    if (r.itemsPerSecond > 0)
+        out << "  " << std::setprecision(2) << r.itemsPerSecond / 1e6 << " M items/s";
+    for (const auto& c : r.counters)
+        out << "  " << c.first << "=" << std::setprecision(3) << c.second;
+    out << std::endl;
+}
+
+inline std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            quoted += '\\';
+        if (static_cast<unsigned char>(c) < 0x20)
+            continue;
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+inline void writeJson(std::ostream& out, const std::vector<Result>& results) {
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    std::ostringstream json;
+    json << std::setprecision(17);
+    json << "{\n  \"context\": {\n"
+        << "    \"date\": " << jsonString(date) << ",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+        << "    \"library_build_type\": " << jsonString(BENCH_BUILD_TYPE) << "\n"
+        << "  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        json << (i ? ",\n" : "\n") << "    {\n"
+            << "      \"name\": " << jsonString(r.name) << ",\n"
+            << "      \"run_name\": " << jsonString(r.runName) << ",\n"
+            << "      \"run_type\": " << (r.aggregate.empty() ? "\"iteration\"" : "\"aggregate\"") << ",\n"
+            << "      \"repetitions\": " << r.repetitions << ",\n";
+        if (r.aggregate.empty())
+            json << "      \"repetition_index\": " << r.repetitionIndex << ",\n";
+        else
+            json << "      \"aggregate_name\": " << jsonString(r.aggregate) << ",\n";
+        json << "      \"iterations\": " << r.iterations << ",\n"
+            << "      \"real_time\": " << r.realTime << ",\n"
+            << "      \"time_unit\": \"ns\"";
+        if (r.bytesPerSecond > 0)
+            json << ",\n      \"bytes_per_second\": " << r.bytesPerSecond;
+        if (r.itemsPerSecond > 0)
+            json << ",\n      \"items_per_second\": " << r.itemsPerSecond;
+        for (const auto& c : r.counters)
+            json << ",\n      " << jsonString(c.first) << ": " << c.second;
+        json << "\n    }";
+    }
+    json << "\n  ]\n}\n";
+    out << json.str();
+}
+
+// True if `name` contains any of the '|'-separated substrings in `filter`.
+inline bool matchesFilter(const std::string& name, const std::string& filter) {
+    size_t start = 0;
+    for (;;) {
+        size_t bar = filter.find('|', start);
+        std::string part = filter.substr(start, bar == std::string::npos ? std::string::npos : bar - start);
+        if (name.find(part) != std::string::npos)
+            return true;
+        if (bar == std::string::npos)
+            return false;
+        start = bar + 1;
+    }
+}
+
+// Flags: --filter=<substring>[|<substring>...] --min_time=<seconds>
+//        --repetitions=<n> --format=console|json --out=<file.json>
+//        --metrics=<file.json> --trace=<file.json> --allocations=<file.txt>
+inline int runBenchmarks(int argc, char** argv) {
+    std::string filter, format = "console", outPath, metricsPath, tracePath, allocationsPath;
+    double minTime = 0.2;
+    int repetitions = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a.rfind("--filter=", 0) == 0)
+            filter = a.substr(9);
+        else if (a.rfind("--min_time=", 0) == 0)
+            minTime = std::atof(a.c_str() + 11);
+        else if (a.rfind("--repetitions=", 0) == 0)
+            repetitions = std::max(1, std::atoi(a.c_str() + 14));
+        else if (a == "--format=console" || a == "--format=json")
+            format = a.substr(9);
+        else if (a.rfind("--out=", 0) == 0)
+            outPath = a.substr(6);
+        else if (a.rfind("--metrics=", 0) == 0)
+            metricsPath = a.substr(10);
+        else if (a.rfind("--trace=", 0) == 0)
+            tracePath = a.substr(8);
+        else if (a.rfind("--allocations=", 0) == 0)
+            allocationsPath = a.substr(14);
+        else {
+            std::cerr << "Unknown flag: " << a << std::endl;
+            return 2;
+        }
+    }
+
+    if (!tracePath.empty())
+        tracing::enable();
+    // Never deleted: blocks handed out during the run, e.g. to function-local
+    // statics, may be freed after this function returns.
+    TrackingResource* tracking = nullptr;
+    if (!allocationsPath.empty()) {
+        tracking = new TrackingResource();
+        std::pmr::set_default_resource(tracking);
+    }
+    bool console = format == "console";
+    if (console)
+        printHeader(std::cout);
+    struct Instance {
+        const Benchmark* benchmark;
+        std::vector<int64_t> args;
+        std::string name;
+        std::vector<Result> runs;
+    };
+    std::vector<Instance> instances;
+    for (const auto& b : registry()) {
+        std::vector<std::vector<int64_t>> sets = b->argumentSets();
+        if (sets.empty())
+            sets.push_back({});
+        for (const auto& args : sets) {
+            std::string name = instanceName(*b, args);
+            if (filter.empty() || matchesFilter(name, filter))
+                instances.push_back(Instance{ b.get(), args, name, {} });
+        }
+    }
+
+    // Repetitions are whole passes over the selected instances, so slow
+    // drift on the machine spreads over every instance's samples instead
+    // of landing on whichever instance happened to run during it.
+    for (int rep = 0; rep < repetitions; ++rep) {
+        for (Instance& inst : instances) {
+            inst.runs.push_back(makeResult(inst.name, runInstance(*inst.benchmark, inst.args, minTime)));
+            inst.runs.back().repetitions = repetitions;
+            inst.runs.back().repetitionIndex = rep;
+            if (console)
+                printResult(std::cout, inst.runs.back());
+        }
+    }
+
+    if (tracking)
+        std::pmr::set_default_resource(tracking->upstreamResource());
+
+    std::vector<Result> results;
+    for (const Instance& inst : instances) {
+        results.insert(results.end(), inst.runs.begin(), inst.runs.end());
+        if (repetitions > 1) {
+            for (const Result& a : aggregateResults(inst.runs)) {
+                results.push_back(a);
+                if (console)
+                    printResult(std::cout, a);
+            }
+        }
+    }
+    if (!console)
+        writeJson(std::cout, results);
+    if (!outPath.empty()) {
+        std::ofstream file(outPath);
+        writeJson(file, results);
+        if (!file) {
+            std::cerr << "Cannot write " << outPath << std::endl;
+            return 1;
+        }
+    }
+    if (!metricsPath.empty()) {
+        if (!POLINOM_METRICS)
+            std::cerr << "Built without POLINOM_METRICS; " << metricsPath << " will hold zeros" << std::endl;
+        std::ofstream file(metricsPath);
+        file << metrics::snapshot().toJson();
+        if (!file) {
+            std::cerr << "Cannot write " << metricsPath << std::endl;
+            return 1;
+        }
+    }
+    if (!tracePath.empty()) {
+        tracing::disable();
+        std::ofstream file(tracePath);
+        tracing::writeChromeTrace(file);
+        if (!file) {
+            std::cerr << "Cannot write " << tracePath << std::endl;
+            return 1;
+        }
+    }
+    if (tracking) {
+        std::ofstream file(allocationsPath);
+        file << tracking->report();
+        if (!file) {
+            std::cerr << "Cannot write " << allocationsPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+}
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+#define BENCHMARK(fn) \
+    static ::bench::Benchmark* BENCH_CONCAT(bench_registration_, __LINE__) = ::bench::registerBenchmark(#fn, fn)
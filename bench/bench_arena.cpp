@@ -0,0 +1,43 @@
+#include "arena.h"
+#include "bench.h"
+
+static const char* const kArenaOperands[] = {
+    "3x^3y^2+2xyz-5z^2+7", "x^2-y^2+4xz", "2.5x+1.5y+0.5z-1", "x^4y^4z^4-x^2+9"
+};
+
+static Polinom evaluateChain(const Polinom* ops) {
+    return (ops[0] * ops[1] + ops[2]) * ops[3] - ops[0] * 2.0;
+}
+
+static void BM_ExpressionGlobalAllocator(bench::State& state) {
+    Polinom ops[4];
+    for (int i = 0; i < 4; ++i)
+        ops[i] = Polinom(kArenaOperands[i]);
+    for (auto _ : state)
+        bench::doNotOptimize(evaluateChain(ops));
+}
+BENCHMARK(BM_ExpressionGlobalAllocator);
+
+static void BM_ExpressionArena(bench::State& state) {
+    PolinomArena arena;
+    for (auto _ : state) {
+        Polinom ops[4] = {
+            Polinom(kArenaOperands[0], arena.resource()), Polinom(kArenaOperands[1], arena.resource()),
+            Polinom(kArenaOperands[2], arena.resource()), Polinom(kArenaOperands[3], arena.resource())
+        };
+        bench::doNotOptimize(evaluateChain(ops));
+        arena.reset();
+    }
+}
+BENCHMARK(BM_ExpressionArena);
+
+static void BM_ExpressionParseGlobalAllocator(bench::State& state) {
+    for (auto _ : state) {
+        Polinom ops[4] = {
+            Polinom(kArenaOperands[0]), Polinom(kArenaOperands[1]),
+            Polinom(kArenaOperands[2]), Polinom(kArenaOperands[3])
+        };
+        bench::doNotOptimize(evaluateChain(ops));
+    }
+}
+BENCHMARK(BM_ExpressionParseGlobalAllocator);
@@ -0,0 +1,42 @@
+#include "modint.h"
+#include "polinom.h"
+#include "rational.h"
+#include "bench.h"
+
+// The same integer product over each coefficient ring: what exactness
+// costs relative to double.
+
+// Every monom with all powers <= maxPower, small integer coefficients.
+template <class C>
+static BasicPolinom<C> cube(int maxPower, int64_t seed) {
+    std::vector<BasicMonom<C>> monoms;
+    for (int x = 0; x <= maxPower; ++x)
+        for (int y = 0; y <= maxPower; ++y)
+            for (int z = 0; z <= maxPower; ++z)
+                monoms.emplace_back(x * 100 + y * 10 + z, C(seed + x - 2 * y + 3 * z));
+    return BasicPolinom<C>(monoms);
+}
+
+template <class C>
+static void multiplyCubes(bench::State& state, int p) {
+    BasicPolinom<C> a = cube<C>(p, 1), b = cube<C>(9 - p, 2);
+    for (auto _ : state)
+        bench::doNotOptimize(a * b);
+    state.setItemsProcessed(static_cast<int64_t>(a.size() * b.size() * state.iterations()));
+}
+
+// /<ring>/<p> multiplies cube(p) by cube(9 - p); ring 0 = double,
+// 1 = ModInt61, 2 = Rational.
+static void BM_MultiplyRing(bench::State& state) {
+    int p = static_cast<int>(state.range(1));
+    switch (state.range(0)) {
+    case 0: multiplyCubes<double>(state, p); break;
+    case 1: multiplyCubes<ModInt61>(state, p); break;
+    default: multiplyCubes<Rational>(state, p); break;
+    }
+}
+BENCHMARK(BM_MultiplyRing)->apply([](bench::Benchmark* b) {
+    for (int64_t p = 1; p <= 4; ++p)
+        for (int64_t ring = 0; ring <= 2; ++ring)
+            b->args({ ring, p });
+});
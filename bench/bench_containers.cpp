@@ -0,0 +1,109 @@
+#include "polinom.h"
+#include "tlist.h"
+#include "bench.h"
+
+// range(0) terms: 4 stays in the inline buffer, 40 spills to the heap.
+static std::vector<Monom> containerTerms(int64_t terms) {
+    std::vector<Monom> monoms;
+    for (int64_t d = 0; d < terms; ++d)
+        monoms.emplace_back(static_cast<int>(d * 23 % 1000), 1.0 + d);
+    return monoms;
+}
+
+static const int kContainerElements = 1000;
+
+static void BM_ListPolinomAppendCopy(bench::State& state) {
+    Polinom p(containerTerms(state.range(0)));
+    for (auto _ : state) {
+        List<Polinom> l;
+        for (int i = 0; i < kContainerElements; ++i) {
+            Polinom item = p;
+            l.append(item);
+        }
+        bench::doNotOptimize(l.size());
+    }
+    state.setItemsProcessed(kContainerElements * state.iterations());
+}
+BENCHMARK(BM_ListPolinomAppendCopy)->arg(4)->arg(40);
+
+static void BM_ListPolinomAppendMove(bench::State& state) {
+    Polinom p(containerTerms(state.range(0)));
+    for (auto _ : state) {
+        List<Polinom> l;
+        for (int i = 0; i < kContainerElements; ++i) {
+            Polinom item = p;
+            l.append(std::move(item));
+        }
+        bench::doNotOptimize(l.size());
+    }
+    state.setItemsProcessed(kContainerElements * state.iterations());
+}
+BENCHMARK(BM_ListPolinomAppendMove)->arg(4)->arg(40);
+
+static void BM_ListPolinomEmplace(bench::State& state) {
+    Polinom p(containerTerms(state.range(0)));
+    for (auto _ : state) {
+        List<Polinom> l;
+        for (int i = 0; i < kContainerElements; ++i)
+            l.emplace_back(p);
+        bench::doNotOptimize(l.size());
+    }
+    state.setItemsProcessed(kContainerElements * state.iterations());
+}
+BENCHMARK(BM_ListPolinomEmplace)->arg(4)->arg(40);
+
+static void BM_ListPolinomInsertFront(bench::State& state) {
+    Polinom p(containerTerms(state.range(0)));
+    for (auto _ : state) {
+        List<Polinom> l;
+        for (int i = 0; i < kContainerElements; ++i) {
+            Polinom item = p;
+            l.insert_front(std::move(item));
+        }
+        bench::doNotOptimize(l.size());
+    }
+    state.setItemsProcessed(kContainerElements * state.iterations());
+}
+BENCHMARK(BM_ListPolinomInsertFront)->arg(4)->arg(40);
+
+// Hand a filled list to a new owner.
+static void BM_ListPolinomTransfer(bench::State& state) {
+    Polinom p(containerTerms(state.range(0)));
+    List<Polinom> l;
+    for (int i = 0; i < kContainerElements; ++i)
+        l.append(p);
+    for (auto _ : state) {
+        List<Polinom> next(std::move(l));
+        bench::doNotOptimize(next.size());
+        l = std::move(next);
+    }
+}
+BENCHMARK(BM_ListPolinomTransfer)->arg(4)->arg(40);
+
+static void BM_QueuePolinomEnqueueCopy(bench::State& state) {
+    Polinom p(containerTerms(state.range(0)));
+    for (auto _ : state) {
+        Queue<Polinom> q;
+        for (int i = 0; i < kContainerElements; ++i) {
+            Polinom item = p;
+            q.enqueue(item);
+        }
+        bench::doNotOptimize(q.getSize());
+    }
+    state.setItemsProcessed(kContainerElements * state.iterations());
+}
+BENCHMARK(BM_QueuePolinomEnqueueCopy)->arg(4)->arg(40);
+
+static void BM_QueuePolinomEnqueueMove(bench::State& state) {
+    Polinom p(containerTerms(state.range(0)));
+    for (auto _ : state) {
+        Queue<Polinom> q;
+        for (int i = 0; i < kContainerElements; ++i) {
+            Polinom item = p;
+            q.enqueue(std::move(item));
+        }
+        bench::doNotOptimize(q.getSize());
+    }
+    state.setItemsProcessed(kContainerElements * state.iterations());
+}
+BENCHMARK(BM_QueuePolinomEnqueueMove)->arg(4)->arg(40);
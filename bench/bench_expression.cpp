@@ -0,0 +1,42 @@
+#include "expression.h"
+#include "bench.h"
+
+static std::map<std::string, Polinom> expressionTable() {
+    std::map<std::string, Polinom> table;
+    const char* names[] = { "a", "b", "c", "d", "e", "f", "g", "h" };
+    for (int k = 0; k < 8; ++k) {
+        std::vector<Monom> monoms;
+        for (int x = 0; x <= 2; ++x)
+            for (int y = 0; y <= 2; ++y)
+                for (int z = 0; z <= 2; ++z)
+                    monoms.emplace_back(x * 100 + y * 10 + z, k + 1.0 + x - 0.5 * y + 0.25 * z);
+        table[names[k]] = Polinom(monoms);
+    }
+    return table;
+}
+
+static const char* kExpression = "a*b + c*d - e*f + g*h";
+
+static void BM_ExpressionSerial(bench::State& state) {
+    auto table = expressionTable();
+    Expression e(kExpression);
+    for (auto _ : state)
+        bench::doNotOptimize(e.evaluate(table));
+}
+BENCHMARK(BM_ExpressionSerial);
+
+static void BM_ExpressionOperators(bench::State& state) {
+    auto t = expressionTable();
+    for (auto _ : state)
+        bench::doNotOptimize(t["a"] * t["b"] + t["c"] * t["d"] - t["e"] * t["f"] + t["g"] * t["h"]);
+}
+BENCHMARK(BM_ExpressionOperators);
+
+static void BM_ExpressionParallel(bench::State& state) {
+    auto table = expressionTable();
+    Expression e(kExpression);
+    TaskScheduler pool(static_cast<unsigned>(state.range(0)));
+    for (auto _ : state)
+        bench::doNotOptimize(e.evaluate(table, pool));
+}
+BENCHMARK(BM_ExpressionParallel)->range(1, 8, 2);
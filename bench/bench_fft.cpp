@@ -0,0 +1,71 @@
+#include "fft.h"
+#include "bench.h"
+#include <random>
+
+// FFT multiplication against the other product kernels, on Polinom shapes
+// (bounded by the 9-per-variable power cap) and on raw convolutions long
+// enough to reach the O(n log n) regime.
+
+// Every monom with all powers <= maxPower, integer coefficients.
+static Polinom fullCube(int maxPower, double seed) {
+    std::vector<Monom> monoms;
+    for (int x = 0; x <= maxPower; ++x)
+        for (int y = 0; y <= maxPower; ++y)
+            for (int z = 0; z <= maxPower; ++z)
+                monoms.emplace_back(x * 100 + y * 10 + z, seed + x - 2 * y + 3 * z);
+    return Polinom(monoms);
+}
+
+// /<kernel>/<p> multiplies fullCube(p) by fullCube(9 - p); kernel 0 = FFT,
+// 1 = Kronecker + Karatsuba, 2 = Polinom::multiply.
+static void BM_MultiplyFftKernels(bench::State& state) {
+    int p = static_cast<int>(state.range(1));
+    Polinom a = fullCube(p, 1.0), b = fullCube(9 - p, 2.0);
+    int64_t kernel = state.range(0);
+    for (auto _ : state) {
+        if (kernel == 0)
+            bench::doNotOptimize(multiplyFft(a, b));
+        else if (kernel == 1)
+            bench::doNotOptimize(multiplyKronecker(a, b));
+        else
+            bench::doNotOptimize(a * b);
+    }
+    state.setItemsProcessed(static_cast<int64_t>(a.size() * b.size() * state.iterations()));
+}
+BENCHMARK(BM_MultiplyFftKernels)->apply([](bench::Benchmark* b) {
+    for (int64_t p = 0; p <= 4; ++p)
+        for (int64_t kernel = 0; kernel <= 2; ++kernel)
+            b->args({ kernel, p });
+});
+
+// Raw n x n convolutions of small integers: /<kernel>/<n>, kernel 0 = FFT,
+// 1 = Karatsuba, 2 = schoolbook.
+static void BM_Convolution(bench::State& state) {
+    size_t n = static_cast<size_t>(state.range(1));
+    std::mt19937 rng(1);
+    std::vector<double> a(n), b(n), out(2 * n - 1);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = static_cast<double>(rng() % 2001) - 1000.0;
+        b[i] = static_cast<double>(rng() % 2001) - 1000.0;
+    }
+    int64_t kernel = state.range(0);
+    for (auto _ : state) {
+        if (kernel == 0) {
+            bench::doNotOptimize(fftConvolve(a, b));
+            continue;
+        }
+        std::fill(out.begin(), out.end(), 0.0);
+        if (kernel == 1)
+            karatsubaMultiply(a.data(), n, b.data(), n, out.data());
+        else
+            schoolbookMultiply(a.data(), n, b.data(), n, out.data());
+        bench::doNotOptimize(out);
+    }
+    state.setItemsProcessed(static_cast<int64_t>(n * n * state.iterations()));
+}
+BENCHMARK(BM_Convolution)->apply([](bench::Benchmark* b) {
+    for (int64_t n : { 64, 256, 1024, 4096, 16384 })
+        for (int64_t kernel = 0; kernel <= 2; ++kernel)
+            if (kernel != 2 || n <= 4096)
+                b->args({ kernel, n });
+});
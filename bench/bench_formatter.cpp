@@ -0,0 +1,62 @@
+#include "formatter.h"
+#include "bench.h"
+#include <random>
+#include <sstream>
+
+static std::vector<Polinom> makeFormatterTable(int64_t rows, int terms) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> degree(0, 999);
+    std::uniform_real_distribution<double> coeff(-1000.0, 1000.0);
+    std::vector<Polinom> table;
+    for (int64_t r = 0; r < rows; ++r) {
+        std::vector<Monom> monoms;
+        for (int i = 0; i < terms; ++i)
+            monoms.emplace_back(degree(rng), coeff(rng));
+        table.emplace_back(std::move(monoms));
+    }
+    return table;
+}
+
+static void BM_FormatStream(bench::State& state) {
+    std::vector<Polinom> table = makeFormatterTable(state.range(0), 16);
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::ostringstream os;
+        for (const auto& p : table)
+            os << p << '\n';
+        bytes = os.str().size();
+        bench::doNotOptimize(bytes);
+    }
+    state.setBytesProcessed(static_cast<int64_t>(bytes * state.iterations()));
+}
+BENCHMARK(BM_FormatStream)->range(1, 1024);
+
+static void BM_FormatToChars(bench::State& state) {
+    std::vector<Polinom> table = makeFormatterTable(state.range(0), 16);
+    PolinomFormatter f;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        f.clear();
+        for (const auto& p : table)
+            f.append(p);
+        bytes = f.size();
+        bench::doNotOptimize(f.str().data());
+    }
+    state.setBytesProcessed(static_cast<int64_t>(bytes * state.iterations()));
+}
+BENCHMARK(BM_FormatToChars)->range(1, 1024);
+
+static void BM_FormatFixedPrecision(bench::State& state) {
+    std::vector<Polinom> table = makeFormatterTable(state.range(0), 16);
+    FormatOptions opts;
+    opts.precision = 6;
+    PolinomFormatter f(opts);
+    for (auto _ : state) {
+        f.clear();
+        for (const auto& p : table)
+            f.append(p);
+        bench::doNotOptimize(f.str().data());
+    }
+    state.setItemsProcessed(static_cast<int64_t>(table.size() * state.iterations()));
+}
+BENCHMARK(BM_FormatFixedPrecision)->range(1, 1024);
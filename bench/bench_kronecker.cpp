@@ -0,0 +1,105 @@
+#include "kronecker.h"
+#include "bench.h"
+#include <random>
+
+// Crossovers between Kronecker substitution + Karatsuba and the term-by-term
+// kernels of Polinom::multiply. Kronecker operands are dense over the packed
+// span, so they pay for every hole in it; the term kernels pay per pair.
+
+// Every monom with all powers <= maxPower.
+static Polinom cube(int maxPower, double seed) {
+    std::vector<Monom> monoms;
+    for (int x = 0; x <= maxPower; ++x)
+        for (int y = 0; y <= maxPower; ++y)
+            for (int z = 0; z <= maxPower; ++z)
+                monoms.emplace_back(x * 100 + y * 10 + z, seed + x - 0.5 * y + 0.25 * z);
+    return Polinom(monoms);
+}
+
+// Univariate z^0..z^degree: the one shape with no holes in the span.
+static Polinom chain(int degree, double seed) {
+    std::vector<Monom> monoms;
+    for (int z = 0; z <= degree; ++z)
+        monoms.emplace_back(z, seed + z);
+    return Polinom(monoms);
+}
+
+// /<kernel>/<p> multiplies cube(p) by cube(9 - p); kernel 0 = Kronecker,
+// 1 = dense, 2 = heap.
+static void BM_MultiplyCubeKernels(bench::State& state) {
+    int p = static_cast<int>(state.range(1));
+    Polinom a = cube(p, 1.0), b = cube(9 - p, 2.0);
+    int64_t kernel = state.range(0);
+    for (auto _ : state) {
+        if (kernel == 0)
+            bench::doNotOptimize(multiplyKronecker(a, b));
+        else
+            bench::doNotOptimize(a.multiply(b, a.getResource(),
+                kernel == 1 ? Polinom::MultiplyStrategy::Dense : Polinom::MultiplyStrategy::Heap));
+    }
+    state.setItemsProcessed(static_cast<int64_t>(a.size() * b.size() * state.iterations()));
+}
+BENCHMARK(BM_MultiplyCubeKernels)->apply([](bench::Benchmark* b) {
+    for (int64_t p = 0; p <= 4; ++p)
+        for (int64_t kernel = 0; kernel <= 2; ++kernel)
+            b->args({ kernel, p });
+});
+
+// Same kernels on cube(p) * cube(p), where the tight layout shrinks the
+// bases to 2p + 1.
+static void BM_MultiplySquareKernels(bench::State& state) {
+    int p = static_cast<int>(state.range(1));
+    Polinom a = cube(p, 1.0), b = cube(p, 2.0);
+    int64_t kernel = state.range(0);
+    for (auto _ : state) {
+        if (kernel == 0)
+            bench::doNotOptimize(multiplyKronecker(a, b));
+        else
+            bench::doNotOptimize(a.multiply(b, a.getResource(),
+                kernel == 1 ? Polinom::MultiplyStrategy::Dense : Polinom::MultiplyStrategy::Heap));
+    }
+    state.setItemsProcessed(static_cast<int64_t>(a.size() * b.size() * state.iterations()));
+}
+BENCHMARK(BM_MultiplySquareKernels)->apply([](bench::Benchmark* b) {
+    for (int64_t p = 1; p <= 4; ++p)
+        for (int64_t kernel = 0; kernel <= 2; ++kernel)
+            b->args({ kernel, p });
+});
+
+static void BM_MultiplyChainKernels(bench::State& state) {
+    Polinom a = chain(4, 1.0), b = chain(5, 2.0);
+    int64_t kernel = state.range(0);
+    for (auto _ : state) {
+        if (kernel == 0)
+            bench::doNotOptimize(multiplyKronecker(a, b));
+        else
+            bench::doNotOptimize(a.multiply(b, a.getResource(),
+                kernel == 1 ? Polinom::MultiplyStrategy::Dense : Polinom::MultiplyStrategy::Heap));
+    }
+}
+BENCHMARK(BM_MultiplyChainKernels)->denseRange(0, 2);
+
+// Raw convolution lengths, for kKaratsubaCutoff: /<karatsuba>/<n>.
+static void BM_Karatsuba(bench::State& state) {
+    size_t n = static_cast<size_t>(state.range(1));
+    std::mt19937 rng(1);
+    std::vector<double> a(n), b(n), out(2 * n - 1);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = rng() % 100 / 10.0;
+        b[i] = rng() % 100 / 10.0;
+    }
+    for (auto _ : state) {
+        std::fill(out.begin(), out.end(), 0.0);
+        if (state.range(0))
+            karatsubaMultiply(a.data(), n, b.data(), n, out.data());
+        else
+            schoolbookMultiply(a.data(), n, b.data(), n, out.data());
+        bench::doNotOptimize(out);
+    }
+    state.setItemsProcessed(static_cast<int64_t>(n * n * state.iterations()));
+}
+BENCHMARK(BM_Karatsuba)->apply([](bench::Benchmark* b) {
+    for (int64_t n : { 16, 32, 64, 128, 256, 512, 1024 })
+        for (int64_t karatsuba = 0; karatsuba <= 1; ++karatsuba)
+            b->args({ karatsuba, n });
+});
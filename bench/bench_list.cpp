@@ -0,0 +1,103 @@
+#include "tlist.h"
+#include "bench.h"
+#include <random>
+
+static void BM_ListIndexedLoop(bench::State& state) {
+    List<int> l;
+    for (int64_t i = 0; i < state.range(0); ++i)
+        l.append(static_cast<int>(i));
+    for (auto _ : state) {
+        for (size_t i = 0; i < l.size(); ++i)
+            bench::doNotOptimize(l[i]);
+    }
+    state.setItemsProcessed(state.range(0) * state.iterations());
+}
+BENCHMARK(BM_ListIndexedLoop)->range(1000, 100000, 10);
+
+static void BM_ListIteratorLoop(bench::State& state) {
+    List<int> l;
+    for (int64_t i = 0; i < state.range(0); ++i)
+        l.append(static_cast<int>(i));
+    for (auto _ : state) {
+        for (int& x : l)
+            bench::doNotOptimize(x);
+    }
+    state.setItemsProcessed(state.range(0) * state.iterations());
+}
+BENCHMARK(BM_ListIteratorLoop)->range(1000, 100000, 10);
+
+static void BM_ListReverseIteratorLoop(bench::State& state) {
+    List<int> l;
+    for (int64_t i = 0; i < state.range(0); ++i)
+        l.append(static_cast<int>(i));
+    for (auto _ : state) {
+        for (auto it = l.crbegin(); it != l.crend(); ++it)
+            bench::doNotOptimize(*it);
+    }
+    state.setItemsProcessed(state.range(0) * state.iterations());
+}
+BENCHMARK(BM_ListReverseIteratorLoop)->range(1000, 100000, 10);
+
+// Build a list of range(0) elements by inserting at random positions.
+static void BM_ListRandomInsert(bench::State& state) {
+    for (auto _ : state) {
+        std::mt19937 rng(1);
+        List<int> l;
+        for (int64_t i = 0; i < state.range(0); ++i)
+            l.insert(static_cast<int>(i), rng() % (l.size() + 1));
+        bench::doNotOptimize(l.size());
+    }
+    state.setItemsProcessed(state.range(0) * state.iterations());
+}
+BENCHMARK(BM_ListRandomInsert)->range(1000, 100000, 10);
+
+static void BM_ListAppend(bench::State& state) {
+    for (auto _ : state) {
+        List<int> l;
+        for (int64_t i = 0; i < state.range(0); ++i)
+            l.append(static_cast<int>(i));
+        bench::doNotOptimize(l.size());
+    }
+    state.setItemsProcessed(state.range(0) * state.iterations());
+}
+BENCHMARK(BM_ListAppend)->range(1000, 100000, 10);
+
+// Build a list of range(0) elements and destroy it again.
+static void BM_ListBuildAndClear(bench::State& state) {
+    for (auto _ : state) {
+        List<int64_t> l;
+        for (int64_t i = 0; i < state.range(0); ++i)
+            l.append(i);
+        bench::doNotOptimize(l[static_cast<size_t>(state.range(0) / 2)]);
+    }
+    state.setItemsProcessed(state.range(0) * state.iterations());
+}
+BENCHMARK(BM_ListBuildAndClear)->range(1 << 10, 1 << 20, 32);
+
+// Interleaved front/back inserts and erases of a steady-size list, which
+// keeps splitting and freeing nodes.
+static void BM_ListChurn(bench::State& state) {
+    List<int> l;
+    for (int64_t i = 0; i < state.range(0); ++i)
+        l.append(static_cast<int>(i));
+    std::mt19937 rng(3);
+    for (auto _ : state) {
+        size_t at = rng() % l.size();
+        l.insert(1, at);
+        l.erase(rng() % l.size());
+    }
+}
+BENCHMARK(BM_ListChurn)->range(1000, 100000, 10);
+
+// Append onto a full last node, then erase it again. Each pair adds and
+// drops a node, which must stay O(log n) rather than rebuild the index.
+static void BM_ListAppendEraseBack(bench::State& state) {
+    List<int> l;
+    while (l.size() < static_cast<size_t>(state.range(0)) || l.size() % 64 != 0)  // 64 ints per node
+        l.append(static_cast<int>(l.size()));
+    for (auto _ : state) {
+        l.append(1);
+        l.erase(l.size() - 1);
+    }
+}
+BENCHMARK(BM_ListAppendEraseBack)->range(1000, 100000, 10);
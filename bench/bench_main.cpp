@@ -0,0 +1,6 @@
+#include "bench.h"
+
+int main(int argc, char** argv)
+{
+  return bench::runBenchmarks(argc, argv);
+}
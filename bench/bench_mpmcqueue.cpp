@@ -0,0 +1,155 @@
+#include "mpmcqueue.h"
+#include "bench.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const int kItemsPerProducer = 50000;
+
+// Baseline: std::deque behind one mutex with condition variables, the
+// obvious way to make Queue<T> thread-safe.
+template<typename T>
+class MutexDequeQueue {
+    std::deque<T> items;
+    size_t limit;
+    bool closed = false;
+    std::mutex lock;
+    std::condition_variable notEmpty, notFull;
+
+public:
+    explicit MutexDequeQueue(size_t capacity) : limit(capacity) {}
+
+    bool push(T value) {
+        std::unique_lock<std::mutex> guard(lock);
+        notFull.wait(guard, [&] { return items.size() < limit || closed; });
+        if (closed)
+            return false;
+        items.push_back(std::move(value));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> guard(lock);
+        notEmpty.wait(guard, [&] { return !items.empty() || closed; });
+        if (items.empty())
+            return false;
+        out = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> guard(lock);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+};
+
+// range(0) producers and as many consumers, each producer pushing
+// kItemsPerProducer integers through a queue of 1024 slots.
+template<typename Queue, typename Push, typename Drain>
+static void runTransfer(bench::State& state, Push push, Drain drain) {
+    int pairs = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        Queue q(1024);
+        std::vector<std::thread> producers, consumers;
+        for (int c = 0; c < pairs; ++c)
+            consumers.emplace_back([&] { bench::doNotOptimize(drain(q)); });
+        for (int p = 0; p < pairs; ++p)
+            producers.emplace_back([&] { push(q); });
+        for (auto& t : producers)
+            t.join();
+        q.close();
+        for (auto& t : consumers)
+            t.join();
+    }
+    state.setItemsProcessed(static_cast<int64_t>(pairs) * kItemsPerProducer * state.iterations());
+}
+
+static void BM_QueueMutexDeque(bench::State& state) {
+    using Q = MutexDequeQueue<int64_t>;
+    runTransfer<Q>(state,
+        [](Q& q) {
+            for (int i = 0; i < kItemsPerProducer; ++i)
+                q.push(i);
+        },
+        [](Q& q) {
+            int64_t v, sum = 0;
+            while (q.pop(v))
+                sum += v;
+            return sum;
+        });
+}
+BENCHMARK(BM_QueueMutexDeque)->range(1, 4, 2);
+
+static void BM_QueueBlockingMPMC(bench::State& state) {
+    using Q = BlockingQueue<int64_t>;
+    runTransfer<Q>(state,
+        [](Q& q) {
+            for (int i = 0; i < kItemsPerProducer; ++i)
+                q.push(i);
+        },
+        [](Q& q) {
+            int64_t v, sum = 0;
+            while (q.pop(v))
+                sum += v;
+            return sum;
+        });
+}
+BENCHMARK(BM_QueueBlockingMPMC)->range(1, 4, 2);
+
+static void BM_QueueBlockingMPMCBatch32(bench::State& state) {
+    using Q = BlockingQueue<int64_t>;
+    runTransfer<Q>(state,
+        [](Q& q) {
+            int64_t chunk[32];
+            for (int i = 0; i < kItemsPerProducer; i += 32) {
+                int n = std::min(32, kItemsPerProducer - i);
+                for (int k = 0; k < n; ++k)
+                    chunk[k] = i + k;
+                q.pushBatch(chunk, static_cast<size_t>(n));
+            }
+        },
+        [](Q& q) {
+            int64_t chunk[32], sum = 0;
+            while (size_t n = q.popBatch(chunk, 32))
+                for (size_t k = 0; k < n; ++k)
+                    sum += chunk[k];
+            return sum;
+        });
+}
+BENCHMARK(BM_QueueBlockingMPMCBatch32)->range(1, 4, 2);
+
+// Single-threaded cost of one push/pop pair, no contention.
+static void BM_QueueUncontendedMPMC(bench::State& state) {
+    MPMCQueue<int64_t> q(1024);
+    int64_t v = 0;
+    for (auto _ : state) {
+        q.tryPush(v);
+        q.tryPop(v);
+    }
+    bench::doNotOptimize(v);
+}
+BENCHMARK(BM_QueueUncontendedMPMC);
+
+static void BM_QueueUncontendedDeque(bench::State& state) {
+    std::deque<int64_t> q;
+    std::mutex lock;
+    int64_t v = 0;
+    for (auto _ : state) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            q.push_back(v);
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        v = q.front();
+        q.pop_front();
+    }
+    bench::doNotOptimize(v);
+}
+BENCHMARK(BM_QueueUncontendedDeque);
@@ -0,0 +1,66 @@
+#include "polinom.h"
+#include "bench.h"
+
+// Every monom with all powers <= maxPower; the product of a (maxPower p) and
+// b (maxPower 9 - p) is the largest product that cannot overflow.
+static Polinom denseCube(int maxPower, double seed) {
+    std::vector<Monom> monoms;
+    for (int x = 0; x <= maxPower; ++x)
+        for (int y = 0; y <= maxPower; ++y)
+            for (int z = 0; z <= maxPower; ++z)
+                monoms.emplace_back(x * 100 + y * 10 + z, seed + x - 0.5 * y + 0.25 * z);
+    return Polinom(monoms);
+}
+
+static void BM_MultiplyDense(bench::State& state) {
+    int p = static_cast<int>(state.range(0));
+    Polinom a = denseCube(p, 1.0), b = denseCube(9 - p, 2.0);
+    for (auto _ : state)
+        bench::doNotOptimize(a * b);
+    state.setItemsProcessed(static_cast<int64_t>(a.size() * b.size() * state.iterations()));
+}
+BENCHMARK(BM_MultiplyDense)->denseRange(0, 4);
+
+static void BM_MultiplyParallel(bench::State& state) {
+    Polinom a = denseCube(4, 1.0), b = denseCube(5, 2.0);
+    unsigned threads = static_cast<unsigned>(state.range(0));
+    for (auto _ : state)
+        bench::doNotOptimize(a.multiplyParallel(b, threads));
+    state.setItemsProcessed(static_cast<int64_t>(a.size() * b.size() * state.iterations()));
+}
+BENCHMARK(BM_MultiplyParallel)->range(1, 64, 2);
+
+// `terms` distinct random monoms with powers <= 4, so any two multiply.
+static Polinom sparseOperand(int terms, unsigned seed) {
+    std::vector<Monom> monoms;
+    std::vector<bool> used(500, false);
+    while (static_cast<int>(monoms.size()) < terms) {
+        seed = seed * 1103515245u + 12345u;
+        int degree = static_cast<int>((seed >> 8) % 5) * 100 + static_cast<int>((seed >> 12) % 5) * 10
+            + static_cast<int>((seed >> 16) % 5);
+        if (!used[degree]) {
+            used[degree] = true;
+            monoms.emplace_back(degree, 1.0 + (seed >> 20) % 100 / 10.0);
+        }
+    }
+    return Polinom(monoms);
+}
+
+// Every kernel on the same operands: /<strategy>/<n>/<m> with strategy
+// 0 = Auto, 1 = Dense, 2 = Heap, 3 = Hash. Auto should track the fastest of
+// the other three; the crossovers calibrate chooseMultiplyStrategy().
+static void BM_MultiplyStrategy(bench::State& state) {
+    auto strategy = static_cast<Polinom::MultiplyStrategy>(state.range(0));
+    Polinom a = sparseOperand(static_cast<int>(state.range(1)), 1);
+    Polinom b = sparseOperand(static_cast<int>(state.range(2)), 2);
+    for (auto _ : state)
+        bench::doNotOptimize(a.multiply(b, a.getResource(), strategy));
+    state.setItemsProcessed(static_cast<int64_t>(a.size() * b.size() * state.iterations()));
+}
+BENCHMARK(BM_MultiplyStrategy)->apply([](bench::Benchmark* b) {
+    const int64_t shapes[][2] = { { 2, 2 }, { 4, 4 }, { 8, 8 }, { 16, 16 }, { 32, 32 }, { 64, 64 }, { 125, 125 },
+        { 2, 125 }, { 4, 30 }, { 8, 125 } };
+    for (const auto& shape : shapes)
+        for (int64_t strategy = 0; strategy <= 3; ++strategy)
+            b->args({ strategy, shape[0], shape[1] });
+});
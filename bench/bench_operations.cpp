@@ -0,0 +1,74 @@
+#include "expression.h"
+#include "formatter.h"
+#include "polinom.h"
+#include "bench.h"
+#include <algorithm>
+#include <random>
+
+// `terms` distinct monoms whose powers are all <= maxPower, with random
+// non-zero coefficients. Two operands with maxPower 4 can be multiplied
+// without overflowing a degree.
+static Polinom randomPolinom(int terms, unsigned seed, int maxPower = 9) {
+    std::vector<int> degrees;
+    for (int x = 0; x <= maxPower; ++x)
+        for (int y = 0; y <= maxPower; ++y)
+            for (int z = 0; z <= maxPower; ++z)
+                degrees.push_back(x * 100 + y * 10 + z);
+    std::mt19937 rng(seed);
+    std::shuffle(degrees.begin(), degrees.end(), rng);
+    std::uniform_real_distribution<double> coeff(0.5, 10.0);
+    std::vector<Monom> monoms;
+    for (int i = 0; i < terms && i < static_cast<int>(degrees.size()); ++i)
+        monoms.emplace_back(degrees[i], rng() % 2 ? coeff(rng) : -coeff(rng));
+    return Polinom(monoms);
+}
+
+static void BM_Parse(bench::State& state) {
+    std::string text = formatPolinom(randomPolinom(static_cast<int>(state.range(0)), 1));
+    for (auto _ : state)
+        bench::doNotOptimize(Polinom(text));
+    state.setBytesProcessed(static_cast<int64_t>(text.size() * state.iterations()));
+}
+BENCHMARK(BM_Parse)->range(8, 1000);
+
+static void BM_Add(bench::State& state) {
+    int terms = static_cast<int>(state.range(0));
+    Polinom a = randomPolinom(terms, 1), b = randomPolinom(terms, 2);
+    for (auto _ : state)
+        bench::doNotOptimize(a + b);
+    state.setItemsProcessed(static_cast<int64_t>((a.size() + b.size()) * state.iterations()));
+}
+BENCHMARK(BM_Add)->range(8, 1000);
+
+static void BM_Subtract(bench::State& state) {
+    int terms = static_cast<int>(state.range(0));
+    Polinom a = randomPolinom(terms, 1), b = randomPolinom(terms, 2);
+    for (auto _ : state)
+        bench::doNotOptimize(a - b);
+    state.setItemsProcessed(static_cast<int64_t>((a.size() + b.size()) * state.iterations()));
+}
+BENCHMARK(BM_Subtract)->range(8, 1000);
+
+// Random subsets of the 125 monoms with powers <= 4; BM_MultiplyDense in
+// bench_multiply.cpp covers full cubes.
+static void BM_MultiplySparse(bench::State& state) {
+    int terms = static_cast<int>(state.range(0));
+    Polinom a = randomPolinom(terms, 1, 4), b = randomPolinom(terms, 2, 4);
+    for (auto _ : state)
+        bench::doNotOptimize(a * b);
+    state.setItemsProcessed(static_cast<int64_t>(a.size() * b.size() * state.iterations()));
+}
+BENCHMARK(BM_MultiplySparse)->range(4, 125, 4);
+
+static void BM_Evaluate(bench::State& state) {
+    int terms = static_cast<int>(state.range(0));
+    Expression e("a*b + c*d - a*c + b");
+    std::map<std::string, Polinom> table;
+    unsigned seed = 1;
+    for (const char* name : { "a", "b", "c", "d" })
+        table[name] = randomPolinom(terms, seed++, 4);
+    for (auto _ : state)
+        bench::doNotOptimize(e.evaluate(table));
+    state.setItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_Evaluate)->range(4, 125, 4);
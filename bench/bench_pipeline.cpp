@@ -0,0 +1,54 @@
+#include "pipeline.h"
+#include "bench.h"
+#include <sstream>
+
+static std::string pipelineInput(int lines) {
+    std::ostringstream input;
+    for (int i = 0; i < lines; ++i) {
+        input << "a = ";
+        for (int d = 0; d < 20; ++d)
+            input << (d ? "+" : "") << (i + d + 1) << "x^" << d % 4 << "y^" << (d / 4) % 4 << "z";
+        input << "; b = " << (i % 9 + 1) << "x^2+y^3-z+" << i << "; c = xyz-" << i << "\n";
+    }
+    return input.str();
+}
+
+static const char* kPipelineExpression = "a*b - c*a + b";
+static const int kPipelineLines = 2000;
+
+// The same work done line by line on one thread.
+static void BM_PipelineSerial(bench::State& state) {
+    std::string input = pipelineInput(kPipelineLines);
+    Expression e(kPipelineExpression);
+    for (auto _ : state) {
+        std::istringstream in(input);
+        std::ostringstream out;
+        std::string line;
+        while (std::getline(in, line))
+            out << formatPolinom(e.evaluate(PolinomPipeline::parseDefinitions(line))) << '\n';
+        bench::doNotOptimize(out.str().size());
+    }
+    state.setItemsProcessed(static_cast<int64_t>(kPipelineLines) * state.iterations());
+}
+BENCHMARK(BM_PipelineSerial);
+
+// range(0) threads per stage.
+static void BM_PipelineStaged(bench::State& state) {
+    std::string input = pipelineInput(kPipelineLines);
+    PipelineConfig cfg;
+    cfg.parseThreads = cfg.computeThreads = cfg.formatThreads = static_cast<unsigned>(state.range(0));
+    PolinomPipeline pipeline(Expression(kPipelineExpression), cfg);
+    PipelineStats stats;
+    for (auto _ : state) {
+        std::istringstream in(input);
+        std::ostringstream out;
+        stats = pipeline.run(in, out);
+        bench::doNotOptimize(out.str().size());
+    }
+    state.setItemsProcessed(static_cast<int64_t>(kPipelineLines) * state.iterations());
+    for (const auto& stage : stats.stages) {
+        state.counters[stage.name + "_busy_ms"] = stage.busySeconds * 1e3;
+        state.counters[stage.name + "_depth"] = stage.meanQueueDepth;
+    }
+}
+BENCHMARK(BM_PipelineStaged)->range(1, 4, 2);
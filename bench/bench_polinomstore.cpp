@@ -0,0 +1,128 @@
+#include "polinomstore.h"
+#include "bench.h"
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+static const int kKeys = 256;
+static const int kLookupsPerThread = 20000;
+
+static std::string keyName(int k) { return "poly" + std::to_string(k); }
+
+static Polinom storeValue(int k) {
+    std::vector<Monom> monoms;
+    for (int d = 0; d < 12; ++d)
+        monoms.emplace_back((d * 83 + k) % 1000, k + d * 0.5);
+    return Polinom(monoms);
+}
+
+// Runs `threads` readers doing kLookupsPerThread lookups each while an
+// optional writer keeps replacing entries until the readers finish.
+template<typename Lookup, typename Write>
+static void runReaders(bench::State& state, const std::vector<std::string>& names,
+    Lookup lookup, Write write, bool withWriter) {
+    int threads = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        std::atomic<bool> stop{ false };
+        std::thread writer;
+        if (withWriter) {
+            writer = std::thread([&] {
+                for (int i = 0; !stop.load(); ++i) {
+                    write(names[i % kKeys], storeValue(i));
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            });
+        }
+        std::vector<std::thread> readers;
+        for (int t = 0; t < threads; ++t) {
+            readers.emplace_back([&, t] {
+                double sum = 0;
+                for (int i = 0; i < kLookupsPerThread; ++i)
+                    sum += lookup(names[(i * 7 + t) % kKeys]);
+                bench::doNotOptimize(sum);
+            });
+        }
+        for (auto& r : readers)
+            r.join();
+        stop = true;
+        if (writer.joinable())
+            writer.join();
+    }
+    state.setItemsProcessed(static_cast<int64_t>(threads) * kLookupsPerThread * state.iterations());
+}
+
+static std::vector<std::string> keyNames() {
+    std::vector<std::string> names;
+    for (int k = 0; k < kKeys; ++k)
+        names.push_back(keyName(k));
+    return names;
+}
+
+template<bool WithWriter>
+static void BM_StoreRead(bench::State& state) {
+    auto names = keyNames();
+    PolinomStore store;
+    for (int k = 0; k < kKeys; ++k)
+        store.insertOrAssign(names[k], storeValue(k));
+    runReaders(state, names,
+        [&](const std::string& name) {
+            double c = 0;
+            store.read(name, [&](const Polinom& p) { c = p.getMonoms().front().coeff; });
+            return c;
+        },
+        [&](const std::string& name, const Polinom& p) { store.insertOrAssign(name, p); },
+        WithWriter);
+}
+
+template<bool WithWriter>
+static void BM_SharedMutexMapRead(bench::State& state) {
+    auto names = keyNames();
+    std::unordered_map<std::string, Polinom> table;
+    std::shared_mutex lock;
+    for (int k = 0; k < kKeys; ++k)
+        table.emplace(names[k], storeValue(k));
+    runReaders(state, names,
+        [&](const std::string& name) {
+            std::shared_lock<std::shared_mutex> guard(lock);
+            return table.find(name)->second.getMonoms().front().coeff;
+        },
+        [&](const std::string& name, const Polinom& p) {
+            std::unique_lock<std::shared_mutex> guard(lock);
+            table.insert_or_assign(name, p);
+        },
+        WithWriter);
+}
+
+template<bool WithWriter>
+static void BM_MutexMapRead(bench::State& state) {
+    auto names = keyNames();
+    std::unordered_map<std::string, Polinom> table;
+    std::mutex lock;
+    for (int k = 0; k < kKeys; ++k)
+        table.emplace(names[k], storeValue(k));
+    runReaders(state, names,
+        [&](const std::string& name) {
+            std::lock_guard<std::mutex> guard(lock);
+            return table.find(name)->second.getMonoms().front().coeff;
+        },
+        [&](const std::string& name, const Polinom& p) {
+            std::lock_guard<std::mutex> guard(lock);
+            table.insert_or_assign(name, p);
+        },
+        WithWriter);
+}
+
+static void BM_StoreReadOnly(bench::State& state) { BM_StoreRead<false>(state); }
+static void BM_StoreReadWithWriter(bench::State& state) { BM_StoreRead<true>(state); }
+static void BM_SharedMutexReadOnly(bench::State& state) { BM_SharedMutexMapRead<false>(state); }
+static void BM_SharedMutexReadWithWriter(bench::State& state) { BM_SharedMutexMapRead<true>(state); }
+static void BM_MutexReadOnly(bench::State& state) { BM_MutexMapRead<false>(state); }
+static void BM_MutexReadWithWriter(bench::State& state) { BM_MutexMapRead<true>(state); }
+
+BENCHMARK(BM_StoreReadOnly)->range(1, 64, 2);
+BENCHMARK(BM_StoreReadWithWriter)->range(1, 64, 2);
+BENCHMARK(BM_SharedMutexReadOnly)->range(1, 64, 2);
+BENCHMARK(BM_SharedMutexReadWithWriter)->range(1, 64, 2);
+BENCHMARK(BM_MutexReadOnly)->range(1, 64, 2);
+BENCHMARK(BM_MutexReadWithWriter)->range(1, 64, 2);
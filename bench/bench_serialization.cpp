@@ -0,0 +1,72 @@
+#include "serialization.h"
+#include "bench.h"
+#include <random>
+#include <sstream>
+
+static Polinom makeSerializationInput(int64_t terms) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> degree(0, 999);
+    std::uniform_real_distribution<double> coeff(-100.0, 100.0);
+    std::vector<Monom> monoms;
+    for (int64_t i = 0; i < terms; ++i)
+        monoms.emplace_back(degree(rng), coeff(rng));
+    return Polinom(std::move(monoms));
+}
+
+static void BM_TextWrite(bench::State& state) {
+    Polinom p = makeSerializationInput(state.range(0));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::ostringstream os;
+        os << p;
+        bytes = os.str().size();
+        bench::doNotOptimize(bytes);
+    }
+    state.setBytesProcessed(static_cast<int64_t>(bytes * state.iterations()));
+    state.counters["bytes"] = static_cast<double>(bytes);
+}
+BENCHMARK(BM_TextWrite)->range(8, 1000);
+
+static void BM_TextRead(bench::State& state) {
+    std::ostringstream os;
+    os << makeSerializationInput(state.range(0));
+    std::string text = os.str();
+    for (auto _ : state)
+        bench::doNotOptimize(Polinom(text));
+    state.setBytesProcessed(static_cast<int64_t>(text.size() * state.iterations()));
+}
+BENCHMARK(BM_TextRead)->range(8, 1000);
+
+static void encodeBench(bench::State& state, CoeffEncoding encoding) {
+    Polinom p = makeSerializationInput(state.range(0));
+    SerializeOptions opts;
+    opts.encoding = encoding;
+    std::vector<uint8_t> buf;
+    for (auto _ : state) {
+        buf.clear();
+        serialize(p, buf, opts);
+        bench::doNotOptimize(buf.data());
+    }
+    state.setBytesProcessed(static_cast<int64_t>(buf.size() * state.iterations()));
+    state.counters["bytes"] = static_cast<double>(buf.size());
+}
+
+static void decodeBench(bench::State& state, CoeffEncoding encoding) {
+    SerializeOptions opts;
+    opts.encoding = encoding;
+    std::vector<uint8_t> buf = serialize(makeSerializationInput(state.range(0)), opts);
+    for (auto _ : state)
+        bench::doNotOptimize(deserialize(buf));
+    state.setBytesProcessed(static_cast<int64_t>(buf.size() * state.iterations()));
+}
+
+static void BM_BinaryWriteDouble(bench::State& state) { encodeBench(state, CoeffEncoding::Double); }
+static void BM_BinaryWriteFloat(bench::State& state) { encodeBench(state, CoeffEncoding::Float); }
+static void BM_BinaryWriteQuantized(bench::State& state) { encodeBench(state, CoeffEncoding::Quantized); }
+static void BM_BinaryReadDouble(bench::State& state) { decodeBench(state, CoeffEncoding::Double); }
+static void BM_BinaryReadQuantized(bench::State& state) { decodeBench(state, CoeffEncoding::Quantized); }
+BENCHMARK(BM_BinaryWriteDouble)->range(8, 1000);
+BENCHMARK(BM_BinaryWriteFloat)->range(8, 1000);
+BENCHMARK(BM_BinaryWriteQuantized)->range(8, 1000);
+BENCHMARK(BM_BinaryReadDouble)->range(8, 1000);
+BENCHMARK(BM_BinaryReadQuantized)->range(8, 1000);
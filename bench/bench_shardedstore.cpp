@@ -0,0 +1,99 @@
+#include "polinomstore.h"
+#include "shardedstore.h"
+#include "bench.h"
+#include <mutex>
+#include <random>
+#include <thread>
+
+static const int kMixedKeys = 1024;
+static const int kOpsPerThread = 20000;
+
+static Polinom mixedValue(int k) {
+    std::vector<Monom> monoms;
+    for (int d = 0; d < 12; ++d)
+        monoms.emplace_back((d * 83 + k) % 1000, k + d * 0.5);
+    return Polinom(monoms);
+}
+
+// range(0) threads, range(1) percent of operations that are reads; the
+// rest alternate between insertOrAssign and erase on random keys.
+template<typename Read, typename Write, typename Erase>
+static void runMixed(bench::State& state, Read read, Write write, Erase erase) {
+    int threads = static_cast<int>(state.range(0));
+    int readPercent = static_cast<int>(state.range(1));
+    std::vector<std::string> names;
+    std::vector<Polinom> values;
+    for (int k = 0; k < kMixedKeys; ++k) {
+        names.push_back("poly" + std::to_string(k));
+        values.push_back(mixedValue(k));
+    }
+    for (int k = 0; k < kMixedKeys; ++k)
+        write(names[k], values[k]);
+    for (auto _ : state) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                std::mt19937 rng(t + 1);
+                size_t hits = 0;
+                for (int i = 0; i < kOpsPerThread; ++i) {
+                    int k = static_cast<int>(rng() % kMixedKeys);
+                    int op = static_cast<int>(rng() % 100);
+                    if (op < readPercent)
+                        hits += read(names[k]);
+                    else if (op % 2 == 0)
+                        write(names[k], values[k]);
+                    else
+                        erase(names[k]);
+                }
+                bench::doNotOptimize(hits);
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+    }
+    state.setItemsProcessed(static_cast<int64_t>(threads) * kOpsPerThread * state.iterations());
+}
+
+static void BM_MixedSharded(bench::State& state) {
+    ShardedPolinomStore store;
+    runMixed(state,
+        [&](const std::string& n) { return store.contains(n); },
+        [&](const std::string& n, const Polinom& p) { store.insertOrAssign(n, p); },
+        [&](const std::string& n) { store.erase(n); });
+}
+
+static void BM_MixedSnapshotStore(bench::State& state) {
+    PolinomStore store;
+    runMixed(state,
+        [&](const std::string& n) { return store.contains(n); },
+        [&](const std::string& n, const Polinom& p) { store.insertOrAssign(n, p); },
+        [&](const std::string& n) { store.erase(n); });
+}
+
+static void BM_MixedGlobalMutex(bench::State& state) {
+    std::unordered_map<std::string, Polinom> table;
+    std::mutex lock;
+    runMixed(state,
+        [&](const std::string& n) {
+            std::lock_guard<std::mutex> guard(lock);
+            return table.count(n) > 0;
+        },
+        [&](const std::string& n, const Polinom& p) {
+            std::lock_guard<std::mutex> guard(lock);
+            table.insert_or_assign(n, p);
+        },
+        [&](const std::string& n) {
+            std::lock_guard<std::mutex> guard(lock);
+            table.erase(n);
+        });
+}
+
+static void mixedArgs(bench::Benchmark* b) {
+    for (int threads : { 1, 4, 16 })
+        for (int readPercent : { 50, 90, 99 })
+            b->args({ threads, readPercent });
+}
+
+BENCHMARK(BM_MixedSharded)->apply(mixedArgs);
+BENCHMARK(BM_MixedGlobalMutex)->apply(mixedArgs);
+BENCHMARK(BM_MixedSnapshotStore)->apply(mixedArgs);
@@ -0,0 +1,37 @@
+#include "polinom.h"
+#include "bench.h"
+
+static void BM_SmallAdd(bench::State& state) {
+    Polinom a("3x^3y^2+2xyz-5z^2+7"), b("x^2-y^2+4xz");
+    for (auto _ : state)
+        bench::doNotOptimize(a + b);
+}
+BENCHMARK(BM_SmallAdd);
+
+static void BM_SmallMultiply(bench::State& state) {
+    Polinom a("x^2+2xy+y^2"), b("x-y");
+    for (auto _ : state)
+        bench::doNotOptimize(a * b);
+}
+BENCHMARK(BM_SmallMultiply);
+
+static void BM_SmallCopy(bench::State& state) {
+    Polinom a("3x^3y^2+2xyz-5z^2+7");
+    for (auto _ : state) {
+        Polinom copy(a);
+        bench::doNotOptimize(copy);
+    }
+}
+BENCHMARK(BM_SmallCopy);
+
+static void BM_LargeCopy(bench::State& state) {
+    std::vector<Monom> terms;
+    for (int64_t d = 0; d < state.range(0); ++d)
+        terms.emplace_back(static_cast<int>(d), 1.0 + d);
+    Polinom a(terms);
+    for (auto _ : state) {
+        Polinom copy(a);
+        bench::doNotOptimize(copy);
+    }
+}
+BENCHMARK(BM_LargeCopy)->range(16, 1000);
@@ -0,0 +1,135 @@
+#include "polinomstore.h"
+#include "shardedstore.h"
+#include "tlist.h"
+#include "bench.h"
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+
+// insert/find/erase of N named polynomials in each storage backend. Insert
+// starts from an empty store, erase from a full one; building and tearing
+// down the store around the measured part is not timed.
+
+struct SnapshotBackend {
+    PolinomStore store;
+
+    void insert(const std::string& name, const Polinom& p) { store.insertOrAssign(name, p); }
+    bool find(const std::string& name) const { return store.find(name).has_value(); }
+    bool erase(const std::string& name) { return store.erase(name); }
+};
+
+struct ShardedBackend {
+    ShardedPolinomStore store;
+
+    void insert(const std::string& name, const Polinom& p) { store.insertOrAssign(name, p); }
+    bool find(const std::string& name) const { return store.find(name).has_value(); }
+    bool erase(const std::string& name) { return store.erase(name); }
+};
+
+// Linear search over List; the unordered_map is the single-threaded baseline.
+struct ListBackend {
+    struct Entry {
+        std::string name;
+        Polinom value;
+    };
+    List<Entry> entries;
+
+    auto locate(const std::string& name) const {
+        return std::find_if(entries.begin(), entries.end(), [&](const Entry& e) { return e.name == name; });
+    }
+
+    void insert(const std::string& name, const Polinom& p) { entries.emplace_back(Entry{ name, p }); }
+    bool find(const std::string& name) const { return locate(name) != entries.end(); }
+    bool erase(const std::string& name) {
+        auto it = locate(name);
+        if (it == entries.end())
+            return false;
+        entries.erase(static_cast<size_t>(std::distance(entries.cbegin(), it)));
+        return true;
+    }
+};
+
+struct MapBackend {
+    std::unordered_map<std::string, Polinom> table;
+
+    void insert(const std::string& name, const Polinom& p) { table.insert_or_assign(name, p); }
+    bool find(const std::string& name) const { return table.find(name) != table.end(); }
+    bool erase(const std::string& name) { return table.erase(name) > 0; }
+};
+
+struct StorageInput {
+    std::vector<std::string> names;
+    std::vector<Polinom> values;
+
+    explicit StorageInput(int64_t n) {
+        for (int64_t k = 0; k < n; ++k) {
+            names.push_back("poly" + std::to_string(k));
+            std::vector<Monom> monoms;
+            for (int d = 0; d < 12; ++d)
+                monoms.emplace_back(static_cast<int>((d * 83 + k) % 1000), k + d * 0.5);
+            values.emplace_back(monoms);
+        }
+    }
+};
+
+template<typename Backend>
+static void BM_StorageInsert(bench::State& state) {
+    StorageInput input(state.range(0));
+    for (auto _ : state) {
+        {
+            Backend backend;
+            for (size_t k = 0; k < input.names.size(); ++k)
+                backend.insert(input.names[k], input.values[k]);
+            state.pauseTiming();
+        }
+        state.resumeTiming();
+    }
+    state.setItemsProcessed(state.range(0) * state.iterations());
+}
+
+template<typename Backend>
+static void BM_StorageFind(bench::State& state) {
+    StorageInput input(state.range(0));
+    Backend backend;
+    for (size_t k = 0; k < input.names.size(); ++k)
+        backend.insert(input.names[k], input.values[k]);
+    for (auto _ : state) {
+        for (const auto& name : input.names)
+            bench::doNotOptimize(backend.find(name));
+    }
+    state.setItemsProcessed(state.range(0) * state.iterations());
+}
+
+template<typename Backend>
+static void BM_StorageErase(bench::State& state) {
+    StorageInput input(state.range(0));
+    for (auto _ : state) {
+        state.pauseTiming();
+        {
+            Backend backend;
+            for (size_t k = 0; k < input.names.size(); ++k)
+                backend.insert(input.names[k], input.values[k]);
+            state.resumeTiming();
+            for (const auto& name : input.names)
+                bench::doNotOptimize(backend.erase(name));
+            state.pauseTiming();
+        }
+        state.resumeTiming();
+    }
+    state.setItemsProcessed(state.range(0) * state.iterations());
+}
+
+// Every PolinomStore write copies the snapshot, so its inserts and erases
+// are quadratic in N and stop at 1024.
+BENCHMARK(BM_StorageInsert<SnapshotBackend>)->range(64, 1024, 4);
+BENCHMARK(BM_StorageInsert<ShardedBackend>)->range(64, 4096, 4);
+BENCHMARK(BM_StorageInsert<ListBackend>)->range(64, 4096, 4);
+BENCHMARK(BM_StorageInsert<MapBackend>)->range(64, 4096, 4);
+BENCHMARK(BM_StorageFind<SnapshotBackend>)->range(64, 4096, 4);
+BENCHMARK(BM_StorageFind<ShardedBackend>)->range(64, 4096, 4);
+BENCHMARK(BM_StorageFind<ListBackend>)->range(64, 4096, 4);
+BENCHMARK(BM_StorageFind<MapBackend>)->range(64, 4096, 4);
+BENCHMARK(BM_StorageErase<SnapshotBackend>)->range(64, 1024, 4);
+BENCHMARK(BM_StorageErase<ShardedBackend>)->range(64, 4096, 4);
+BENCHMARK(BM_StorageErase<ListBackend>)->range(64, 4096, 4);
+BENCHMARK(BM_StorageErase<MapBackend>)->range(64, 4096, 4);
@@ -0,0 +1,81 @@
+#include "expression.h"
+#include "polinomstore.h"
+#include "shardedstore.h"
+#include "workload.h"
+#include "bench.h"
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+// Replays a store trace: the generated default, or the file named by
+// BENCH_WORKLOAD (text or binary trace written by gen_workload).
+static const std::vector<StoreOp>& benchTrace() {
+    static const std::vector<StoreOp> trace = [] {
+        if (const char* path = std::getenv("BENCH_WORKLOAD")) {
+            std::ifstream in(path, std::ios::binary);
+            std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            if (hasWorkloadMagic(bytes, kTraceMagic))
+                return readTraceBinary(bytes);
+            std::ifstream text(path);
+            return readTraceText(text);
+        }
+        TraceSpec spec;
+        spec.operations = 20000;
+        return generateTrace(spec, 42);
+    }();
+    return trace;
+}
+
+template<typename Store>
+static void replay(Store& store, const std::vector<StoreOp>& trace, const std::vector<std::string>& names) {
+    for (const StoreOp& op : trace) {
+        switch (op.kind) {
+        case StoreOp::Kind::Insert:
+            store.insertOrAssign(names[op.key], op.value);
+            break;
+        case StoreOp::Kind::Lookup:
+            bench::doNotOptimize(store.find(names[op.key]));
+            break;
+        case StoreOp::Kind::Erase:
+            bench::doNotOptimize(store.erase(names[op.key]));
+            break;
+        case StoreOp::Kind::Evaluate: {
+            Expression e(op.expression);
+            bench::doNotOptimize(e.evaluate([&](const std::string& name) {
+                return store.find(name).value_or(Polinom());
+            }));
+            break;
+        }
+        }
+    }
+}
+
+template<typename Store>
+static void runTrace(bench::State& state) {
+    const std::vector<StoreOp>& trace = benchTrace();
+    uint32_t keys = 0;
+    for (const StoreOp& op : trace)
+        keys = std::max(keys, op.key + 1);
+    std::vector<std::string> names;
+    for (uint32_t k = 0; k < keys; ++k)
+        names.push_back(keyName(k));
+    Store store;
+    for (auto _ : state)
+        replay(store, trace, names);
+    state.setItemsProcessed(static_cast<int64_t>(trace.size() * state.iterations()));
+}
+
+static void BM_TraceSnapshotStore(bench::State& state) { runTrace<PolinomStore>(state); }
+BENCHMARK(BM_TraceSnapshotStore);
+
+static void BM_TraceShardedStore(bench::State& state) { runTrace<ShardedPolinomStore>(state); }
+BENCHMARK(BM_TraceShardedStore);
+
+static void BM_GeneratePolinoms(bench::State& state) {
+    PolinomSpec spec;
+    spec.terms = static_cast<int>(state.range(0));
+    for (auto _ : state)
+        bench::doNotOptimize(generatePolinoms(spec, 64, 7));
+    state.setItemsProcessed(64 * static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_GeneratePolinoms)->range(8, 512);
@@ -0,0 +1,449 @@
+// Compares benchmark results against a baseline and fails on regressions.
+//
+//   bench_compare BASELINE.json CURRENT.json
+//   bench_compare --run=path/to/bench_polinom --baseline=BASELINE.json
+//   bench_compare --run=path/to/bench_polinom --baseline=BASELINE.json --save-baseline
+//
+// With --run the suite is run first (--repetitions times per benchmark)
+// and its JSON is compared, or stored as the new baseline. Every instance
+// present on both sides is reported. An instance whose name matches
+// --gate is a regression when its mean time grew by more than
+// --threshold and a one-sided Welch t-test puts the slowdown below
+// --alpha significance; any gated regression makes the exit status 1.
+// Baselines are only meaningful on the machine and build type they were
+// recorded on.
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Just enough JSON for benchmark result files.
+struct Json {
+    enum class Type { Null, Bool, Number, String, Array, Object } type = Type::Null;
+    double number = 0.0;
+    std::string text;
+    std::vector<Json> items;
+    std::vector<std::pair<std::string, Json>> members;
+
+    const Json* find(const std::string& key) const {
+        for (const auto& m : members)
+            if (m.first == key)
+                return &m.second;
+        return nullptr;
+    }
+
+    std::string stringOr(const std::string& key, const std::string& fallback) const {
+        const Json* v = find(key);
+        return v && v->type == Type::String ? v->text : fallback;
+    }
+};
+
+class JsonParser {
+    const std::string& src;
+    size_t pos = 0;
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("JSON " + what + " at offset " + std::to_string(pos));
+    }
+
+    void skipSpace() {
+        while (pos < src.size() && std::isspace(static_cast<unsigned char>(src[pos])))
+            ++pos;
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (pos < src.size() && src[pos] == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c))
+            fail(std::string("expected '") + c + "'");
+    }
+
+    std::string parseString() {
+        expect('"');
+        std::string out;
+        while (pos < src.size() && src[pos] != '"') {
+            char c = src[pos++];
+            if (c == '\\') {
+                if (pos >= src.size())
+                    fail("unterminated escape");
+                char e = src[pos++];
+                switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u':
+                    // Benchmark names are ASCII; keep the escape verbatim.
+                    out += "\\u";
+                    break;
+                default: out += e; break;
+                }
+            }
+            else {
+                out += c;
+            }
+        }
+        expect('"');
+        return out;
+    }
+
+public:
+    explicit JsonParser(const std::string& text) : src(text) {}
+
+    Json parse() {
+        Json v;
+        skipSpace();
+        if (pos >= src.size())
+            fail("unexpected end");
+        char c = src[pos];
+        if (c == '{') {
+            ++pos;
+            v.type = Json::Type::Object;
+            if (!consume('}')) {
+                do {
+                    skipSpace();
+                    std::string key = parseString();
+                    expect(':');
+                    v.members.emplace_back(key, parse());
+                } while (consume(','));
+                expect('}');
+            }
+        }
+        else if (c == '[') {
+            ++pos;
+            v.type = Json::Type::Array;
+            if (!consume(']')) {
+                do {
+                    v.items.push_back(parse());
+                } while (consume(','));
+                expect(']');
+            }
+        }
+        else if (c == '"') {
+            v.type = Json::Type::String;
+            v.text = parseString();
+        }
+        else if (src.compare(pos, 4, "true") == 0 || src.compare(pos, 5, "false") == 0) {
+            v.type = Json::Type::Bool;
+            v.number = src[pos] == 't';
+            pos += src[pos] == 't' ? 4 : 5;
+        }
+        else if (src.compare(pos, 4, "null") == 0) {
+            pos += 4;
+        }
+        else {
+            const char* begin = src.c_str() + pos;
+            char* end = nullptr;
+            v.type = Json::Type::Number;
+            v.number = std::strtod(begin, &end);
+            if (end == begin)
+                fail("unexpected character");
+            pos += static_cast<size_t>(end - begin);
+        }
+        return v;
+    }
+};
+
+// Real time in ns of every non-aggregate run, grouped by run name, in
+// file order.
+std::map<std::string, std::vector<double>> loadSamples(const std::string& path, std::vector<std::string>& order) {
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("Cannot read " + path);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+    Json root = JsonParser(text).parse();
+    const Json* benchmarks = root.find("benchmarks");
+    if (!benchmarks || benchmarks->type != Json::Type::Array)
+        throw std::runtime_error(path + " has no benchmarks array");
+
+    std::map<std::string, std::vector<double>> samples;
+    for (const Json& b : benchmarks->items) {
+        if (b.stringOr("run_type", "iteration") == "aggregate")
+            continue;
+        const Json* time = b.find("real_time");
+        if (!time || time->type != Json::Type::Number)
+            continue;
+        std::string unit = b.stringOr("time_unit", "ns");
+        double scale = unit == "s" ? 1e9 : unit == "ms" ? 1e6 : unit == "us" ? 1e3 : 1.0;
+        std::string name = b.stringOr("run_name", b.stringOr("name", ""));
+        if (!samples.count(name))
+            order.push_back(name);
+        samples[name].push_back(time->number * scale);
+    }
+    return samples;
+}
+
+// Regularized incomplete beta I_x(a, b) by Lentz's continued fraction.
+double incompleteBeta(double a, double b, double x) {
+    if (x <= 0.0)
+        return 0.0;
+    if (x >= 1.0)
+        return 1.0;
+    if (x > (a + 1.0) / (a + b + 2.0))
+        return 1.0 - incompleteBeta(b, a, 1.0 - x);
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b)
+        + a * std::log(x) + b * std::log(1.0 - x)) / a;
+    const double tiny = 1e-300;
+    double f = 1.0, c = 1.0, d = 0.0;
+    for (int i = 0; i <= 400; ++i) {
+        int m = i / 2;
+        double numerator;
+        if (i == 0)
+            numerator = 1.0;
+        else if (i % 2 == 0)
+            numerator = (m * (b - m) * x) / ((a + 2.0 * m - 1.0) * (a + 2.0 * m));
+        else
+            numerator = -((a + m) * (a + b + m) * x) / ((a + 2.0 * m) * (a + 2.0 * m + 1.0));
+        d = 1.0 + numerator * d;
+        d = std::abs(d) < tiny ? tiny : d;
+        d = 1.0 / d;
+        c = 1.0 + numerator / c;
+        c = std::abs(c) < tiny ? tiny : c;
+        double step = c * d;
+        f *= step;
+        if (std::abs(1.0 - step) < 1e-12)
+            break;
+    }
+    return front * (f - 1.0);
+}
+
+// P(T <= t) for Student's t with `df` degrees of freedom.
+double studentCdf(double t, double df) {
+    double tail = 0.5 * incompleteBeta(df / 2.0, 0.5, df / (df + t * t));
+    return t > 0 ? 1.0 - tail : tail;
+}
+
+double studentQuantile(double p, double df) {
+    double lo = -1e3, hi = 1e3;
+    for (int i = 0; i < 200; ++i) {
+        double mid = (lo + hi) / 2;
+        (studentCdf(mid, df) < p ? lo : hi) = mid;
+    }
+    return (lo + hi) / 2;
+}
+
+struct Summary {
+    size_t n = 0;
+    double mean = 0.0;
+    double variance = 0.0;   // sample variance
+};
+
+Summary summarize(const std::vector<double>& v) {
+    Summary s;
+    s.n = v.size();
+    for (double x : v)
+        s.mean += x / v.size();
+    for (double x : v)
+        s.variance += (x - s.mean) * (x - s.mean);
+    s.variance = v.size() > 1 ? s.variance / (v.size() - 1) : 0.0;
+    return s;
+}
+
+// Half-width of the two-sided (1 - alpha) confidence interval of the mean.
+double halfWidth(const Summary& s, double alpha) {
+    if (s.n < 2)
+        return 0.0;
+    return studentQuantile(1.0 - alpha / 2, static_cast<double>(s.n - 1)) * std::sqrt(s.variance / s.n);
+}
+
+struct Comparison {
+    double change = 0.0;     // current mean / baseline mean - 1
+    double changeLo = 0.0;   // confidence interval of `change`
+    double changeHi = 0.0;
+    double pSlower = 1.0;    // one-sided Welch p-value for "current is slower"
+    bool tested = false;     // false with fewer than two runs on a side
+};
+
+Comparison compare(const Summary& base, const Summary& cur, double alpha) {
+    Comparison c;
+    c.change = cur.mean / base.mean - 1.0;
+    c.changeLo = c.changeHi = c.change;
+    if (base.n < 2 || cur.n < 2)
+        return c;
+    c.tested = true;
+    double vb = base.variance / base.n, vc = cur.variance / cur.n;
+    double se = std::sqrt(vb + vc);
+    double diff = cur.mean - base.mean;
+    if (se == 0.0) {
+        c.pSlower = diff > 0 ? 0.0 : 1.0;
+        return c;
+    }
+    double df = (vb + vc) * (vb + vc) / (vb * vb / (base.n - 1) + vc * vc / (cur.n - 1));
+    c.pSlower = 1.0 - studentCdf(diff / se, df);
+    double margin = studentQuantile(1.0 - alpha / 2, df) * se;
+    c.changeLo = (diff - margin) / base.mean;
+    c.changeHi = (diff + margin) / base.mean;
+    return c;
+}
+
+std::string formatTime(double ns) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (ns >= 1e6)
+        out << ns / 1e6 << " ms";
+    else if (ns >= 1e3)
+        out << ns / 1e3 << " us";
+    else
+        out << ns << " ns";
+    return out.str();
+}
+
+std::string percent(double v) {
+    std::ostringstream out;
+    out << std::showpos << std::fixed << std::setprecision(1) << v * 100 << "%";
+    return out.str();
+}
+
+bool matchesAny(const std::string& name, const std::string& patterns) {
+    size_t start = 0;
+    for (;;) {
+        size_t bar = patterns.find('|', start);
+        std::string part = patterns.substr(start, bar == std::string::npos ? std::string::npos : bar - start);
+        if (!part.empty() && name.find(part) != std::string::npos)
+            return true;
+        if (bar == std::string::npos)
+            return false;
+        start = bar + 1;
+    }
+}
+
+void usage() {
+    std::cerr <<
+        "usage: bench_compare BASELINE.json CURRENT.json [options]\n"
+        "       bench_compare --run=BENCH --baseline=BASELINE.json [--save-baseline] [options]\n"
+        "options: --gate=PATTERNS (default BM_Parse|BM_Multiply|BM_StorageFind)\n"
+        "         --filter=PATTERNS (benchmarks to run, default the gate)\n"
+        "         --threshold=F (default 0.10)  --alpha=F (default 0.05)\n"
+        "         --repetitions=N (default 5)  --min_time=S (default 0.1)\n"
+        "         --out=FILE (results of --run, default bench_current.json)\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::string baselinePath, currentPath, runPath, outPath = "bench_current.json";
+    std::string gate = "BM_Parse|BM_Multiply|BM_StorageFind", filter;
+    double threshold = 0.10, alpha = 0.05, minTime = 0.1;
+    int repetitions = 5;
+    bool saveBaseline = false;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        size_t eq = a.find('=');
+        std::string flag = a.substr(0, eq), value = eq == std::string::npos ? "" : a.substr(eq + 1);
+        if (a.rfind("--", 0) != 0) positional.push_back(a);
+        else if (flag == "--baseline") baselinePath = value;
+        else if (flag == "--current") currentPath = value;
+        else if (flag == "--run") runPath = value;
+        else if (flag == "--out") outPath = value;
+        else if (flag == "--gate") gate = value;
+        else if (flag == "--filter") filter = value;
+        else if (flag == "--threshold") threshold = std::atof(value.c_str());
+        else if (flag == "--alpha") alpha = std::atof(value.c_str());
+        else if (flag == "--min_time") minTime = std::atof(value.c_str());
+        else if (flag == "--repetitions") repetitions = std::max(1, std::atoi(value.c_str()));
+        else if (flag == "--save-baseline") saveBaseline = true;
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (positional.size() > 0 && baselinePath.empty()) baselinePath = positional[0];
+    if (positional.size() > 1 && currentPath.empty()) currentPath = positional[1];
+    if (baselinePath.empty() || (runPath.empty() && currentPath.empty()) || positional.size() > 2) {
+        usage();
+        return 2;
+    }
+
+    try {
+        if (!runPath.empty()) {
+            std::string target = saveBaseline ? baselinePath : outPath;
+            std::ostringstream command;
+            command << '"' << runPath << "\" --format=console --repetitions=" << repetitions
+                << " --min_time=" << minTime << " \"--filter=" << (filter.empty() ? gate : filter)
+                << "\" \"--out=" << target << '"';
+            std::cout << "Running " << command.str() << std::endl;
+            if (std::system(command.str().c_str()) != 0)
+                throw std::runtime_error("Benchmark run failed");
+            if (saveBaseline) {
+                std::cout << "Baseline written to " << baselinePath << std::endl;
+                return 0;
+            }
+            currentPath = outPath;
+        }
+
+        std::vector<std::string> baseOrder, curOrder;
+        auto base = loadSamples(baselinePath, baseOrder);
+        auto cur = loadSamples(currentPath, curOrder);
+
+        int regressions = 0;
+        std::cout << std::left << std::setw(44) << "Benchmark" << std::right
+            << std::setw(22) << "Baseline" << std::setw(22) << "Current"
+            << std::setw(10) << "Change" << std::setw(20) << "CI" << std::setw(8) << "p" << "  Verdict\n";
+        for (const std::string& name : curOrder) {
+            auto b = base.find(name);
+            if (b == base.end()) {
+                std::cout << std::left << std::setw(44) << name << std::right << "  (not in baseline)\n";
+                continue;
+            }
+            Summary sb = summarize(b->second), sc = summarize(cur[name]);
+            Comparison c = compare(sb, sc, alpha);
+            bool gated = matchesAny(name, gate);
+            bool slower = c.change > threshold && (!c.tested || c.pSlower < alpha);
+            bool faster = c.change < -threshold && (!c.tested || c.pSlower > 1.0 - alpha);
+            std::string verdict = slower ? (gated ? "REGRESSION" : "slower") : faster ? "faster" : "same";
+            if (slower && gated)
+                ++regressions;
+
+            std::ostringstream baseCol, curCol, ci, p;
+            baseCol << formatTime(sb.mean) << " +-" << formatTime(halfWidth(sb, alpha));
+            curCol << formatTime(sc.mean) << " +-" << formatTime(halfWidth(sc, alpha));
+            if (c.tested) {
+                ci << "[" << percent(c.changeLo) << ", " << percent(c.changeHi) << "]";
+                p << std::fixed << std::setprecision(3) << c.pSlower;
+            }
+            else {
+                ci << "n/a";
+                p << "n/a";
+            }
+            std::cout << std::left << std::setw(44) << name << std::right
+                << std::setw(22) << baseCol.str() << std::setw(22) << curCol.str()
+                << std::setw(10) << percent(c.change) << std::setw(20) << ci.str()
+                << std::setw(8) << p.str() << "  " << verdict << (gated ? "" : " (not gated)") << "\n";
+        }
+        for (const std::string& name : baseOrder)
+            if (!cur.count(name))
+                std::cout << std::left << std::setw(44) << name << std::right << "  (missing from current run)\n";
+
+        std::cout << "\n" << regressions << " gated regression(s) above " << percent(threshold)
+            << " at alpha " << alpha << std::endl;
+        return regressions ? 1 : 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "bench_compare: " << e.what() << std::endl;
+        return 2;
+    }
+}
@@ -0,0 +1,112 @@
+// Writes a reproducible benchmark workload: random polynomials or a store
+// operation trace, as text or binary (see workload.h for both formats).
+//
+//   gen_workload --kind=polinoms --count=1000 --terms=32 --seed=7 --out=p.txt
+//   gen_workload --kind=trace --ops=100000 --keys=4096 --zipf=1.1
+//                --mix=70,20,5,5 --format=binary --out=trace.bin
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "workload.h"
+
+static void usage() {
+    std::cerr <<
+        "usage: gen_workload [--kind=polinoms|trace] [--seed=N] [--format=text|binary] [--out=FILE]\n"
+        "  polynomials: --count=N --terms=N --density=F --max-power=N --decay=F\n"
+        "               --coeff=integer|uniform|loguniform --coeff-max=F\n"
+        "  traces:      --ops=N --keys=N --zipf=F --mix=LOOKUP,INSERT,ERASE,EVAL --operands=N\n"
+        "               (value shape from the polynomial flags; --max-power defaults to 4)\n";
+}
+
+int main(int argc, char** argv) {
+    std::string kind = "polinoms", format = "text", outPath;
+    uint64_t seed = 1;
+    size_t count = 100;
+    PolinomSpec spec;
+    TraceSpec trace;
+    bool maxPowerSet = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            size_t eq = a.find('=');
+            std::string flag = a.substr(0, eq), value = eq == std::string::npos ? "" : a.substr(eq + 1);
+            if (flag == "--kind") kind = value;
+            else if (flag == "--seed") seed = std::stoull(value);
+            else if (flag == "--format") format = value;
+            else if (flag == "--out") outPath = value;
+            else if (flag == "--count") count = std::stoull(value);
+            else if (flag == "--terms") spec.terms = std::stoi(value);
+            else if (flag == "--density") spec.density = std::stod(value);
+            else if (flag == "--max-power") { spec.maxPower = std::stoi(value); maxPowerSet = true; }
+            else if (flag == "--decay") spec.exponentDecay = std::stod(value);
+            else if (flag == "--coeff-max") spec.coeffMax = std::stod(value);
+            else if (flag == "--coeff") {
+                if (value == "integer") spec.coefficients = CoeffDistribution::Integer;
+                else if (value == "uniform") spec.coefficients = CoeffDistribution::Uniform;
+                else if (value == "loguniform") spec.coefficients = CoeffDistribution::LogUniform;
+                else throw std::invalid_argument("Unknown coefficient distribution: " + value);
+            }
+            else if (flag == "--ops") trace.operations = std::stoull(value);
+            else if (flag == "--keys") trace.keys = static_cast<uint32_t>(std::stoul(value));
+            else if (flag == "--zipf") trace.zipfExponent = std::stod(value);
+            else if (flag == "--operands") trace.expressionOperands = std::stoi(value);
+            else if (flag == "--mix") {
+                std::istringstream parts(value);
+                char comma1 = 0, comma2 = 0, comma3 = 0;
+                parts >> trace.lookupPercent >> comma1 >> trace.insertPercent >> comma2
+                    >> trace.erasePercent >> comma3 >> trace.evaluatePercent;
+                if (!parts || comma1 != ',' || comma2 != ',' || comma3 != ',')
+                    throw std::invalid_argument("Expected --mix=LOOKUP,INSERT,ERASE,EVAL");
+            }
+            else {
+                usage();
+                return 2;
+            }
+        }
+        if ((kind != "polinoms" && kind != "trace") || (format != "text" && format != "binary")) {
+            usage();
+            return 2;
+        }
+
+        std::ofstream file;
+        if (!outPath.empty()) {
+            file.open(outPath, std::ios::binary);
+            if (!file)
+                throw std::runtime_error("Cannot open " + outPath);
+        }
+        std::ostream& out = outPath.empty() ? std::cout : file;
+
+        std::vector<uint8_t> bytes;
+        if (kind == "polinoms") {
+            std::vector<Polinom> polinoms = generatePolinoms(spec, count, seed);
+            if (format == "text")
+                writePolinomsText(out, polinoms);
+            else
+                writePolinomsBinary(bytes, polinoms);
+        }
+        else {
+            if (!maxPowerSet)
+                spec.maxPower = trace.values.maxPower;
+            trace.values = spec;
+            std::vector<StoreOp> ops = generateTrace(trace, seed);
+            if (format == "text")
+                writeTraceText(out, ops);
+            else
+                writeTraceBinary(bytes, ops);
+        }
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        out.flush();
+        if (!out)
+            throw std::runtime_error("Write failed");
+    }
+    catch (const std::exception& e) {
+        std::cerr << "gen_workload: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
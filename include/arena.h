@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+#include "polinom.h"
+
+// Per-request monotonic arena for Polinom temporaries. Allocation is a
+// pointer bump and deallocation is a no-op; reset() returns all memory at
+// once. The first `initialBytes` are served from a buffer that is reused
+// across resets, so a warmed-up arena does not touch the global allocator.
+//
+//   PolinomArena arena;
+//   Polinom a(textA, arena.resource()), b(textB, arena.resource());
+//   Polinom answer = Polinom(a * b + a, std::pmr::get_default_resource());
+//   arena.reset();   // a, b and every intermediate are gone
+//
+// Polinoms allocated from the arena must not be used after reset(); they
+// may still be destroyed afterwards, unless they were copied onto the arena
+// itself (Polinom(p, arena.resource())), which makes their terms shared.
+class PolinomArena {
+private:
+    std::vector<std::byte> initial;
+    std::pmr::monotonic_buffer_resource arena;
+
+public:
+    explicit PolinomArena(size_t initialBytes = 64 * 1024,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : initial(initialBytes), arena(initial.data(), initial.size(), upstream) {}
+
+    PolinomArena(const PolinomArena&) = delete;
+    PolinomArena& operator=(const PolinomArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &arena; }
+
+    void reset() { arena.release(); }
+};
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Arbitrary-precision signed integer: sign and magnitude, the magnitude in
+// base-2^32 limbs, least significant first, with no zero limb on top. Zero
+// has no limbs and is never negative. Enough for Rational; the algorithms
+// are the schoolbook ones (Knuth's algorithm D for division).
+class BigInt {
+public:
+    BigInt() = default;
+    BigInt(int64_t v) : negative(v < 0) {
+        uint64_t magnitude = v < 0 ? uint64_t(-(v + 1)) + 1 : uint64_t(v);
+        for (; magnitude; magnitude >>= 32)
+            limbs.push_back(static_cast<uint32_t>(magnitude));
+    }
+
+    // Optional '-' followed by decimal digits.
+    static BigInt fromString(const std::string& text) {
+        bool minus = !text.empty() && text[0] == '-';
+        size_t end;
+        BigInt result = parseDigits(text, minus ? 1 : 0, end);
+        if (end != text.size())
+            throw std::invalid_argument("BigInt: invalid digit in \"" + text + "\"");
+        return minus ? -result : result;
+    }
+
+    // Decimal digits at text[pos]; `end` is set past them.
+    static BigInt parseDigits(const std::string& text, size_t pos, size_t& end) {
+        if (pos >= text.size() || !std::isdigit(static_cast<unsigned char>(text[pos])))
+            throw std::invalid_argument("BigInt: expected digits");
+        BigInt result;
+        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+            // Nine digits at a time fit one limb.
+            uint32_t chunk = 0, scale = 1;
+            for (int i = 0; i < 9 && pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])); ++i) {
+                chunk = chunk * 10 + static_cast<uint32_t>(text[pos++] - '0');
+                scale *= 10;
+            }
+            result.mulAddSmall(scale, chunk);
+        }
+        end = pos;
+        return result;
+    }
+
+    std::string toString() const {
+        if (limbs.empty())
+            return "0";
+        std::vector<uint32_t> chunks;  // base 10^9, least significant first
+        BigInt rest = abs();
+        while (!rest.limbs.empty())
+            chunks.push_back(rest.divSmall(1000000000u));
+        std::string text = negative ? "-" : "";
+        text += std::to_string(chunks.back());
+        for (size_t i = chunks.size() - 1; i-- > 0;) {
+            std::string part = std::to_string(chunks[i]);
+            text.append(9 - part.size(), '0');
+            text += part;
+        }
+        return text;
+    }
+
+    bool isZero() const { return limbs.empty(); }
+    bool isNegative() const { return negative; }
+    int sign() const { return limbs.empty() ? 0 : negative ? -1 : 1; }
+    BigInt abs() const {
+        BigInt r = *this;
+        r.negative = false;
+        return r;
+    }
+
+    BigInt operator-() const {
+        BigInt r = *this;
+        r.negative = !r.limbs.empty() && !negative;
+        return r;
+    }
+
+    BigInt& operator+=(const BigInt& o) {
+        if (negative == o.negative) {
+            addMagnitude(o.limbs);
+            return *this;
+        }
+        if (compareMagnitude(limbs, o.limbs) >= 0) {
+            subMagnitude(o.limbs);
+        }
+        else {
+            BigInt r = o;
+            r.subMagnitude(limbs);
+            *this = std::move(r);
+        }
+        if (limbs.empty())
+            negative = false;
+        return *this;
+    }
+    BigInt& operator-=(const BigInt& o) { return *this += -o; }
+    BigInt& operator*=(const BigInt& o) { return *this = *this * o; }
+    BigInt& operator/=(const BigInt& o) { return *this = divMod(*this, o).first; }
+    BigInt& operator%=(const BigInt& o) { return *this = divMod(*this, o).second; }
+
+    friend BigInt operator+(BigInt a, const BigInt& b) { return a += b; }
+    friend BigInt operator-(BigInt a, const BigInt& b) { return a -= b; }
+    friend BigInt operator/(const BigInt& a, const BigInt& b) { return divMod(a, b).first; }
+    friend BigInt operator%(const BigInt& a, const BigInt& b) { return divMod(a, b).second; }
+
+    friend BigInt operator*(const BigInt& a, const BigInt& b) {
+        BigInt r;
+        if (a.limbs.empty() || b.limbs.empty())
+            return r;
+        r.limbs.assign(a.limbs.size() + b.limbs.size(), 0);
+        for (size_t i = 0; i < a.limbs.size(); ++i) {
+            uint64_t carry = 0, ai = a.limbs[i];
+            for (size_t j = 0; j < b.limbs.size(); ++j) {
+                uint64_t t = ai * b.limbs[j] + r.limbs[i + j] + carry;
+                r.limbs[i + j] = static_cast<uint32_t>(t);
+                carry = t >> 32;
+            }
+            r.limbs[i + b.limbs.size()] = static_cast<uint32_t>(carry);
+        }
+        r.trim();
+        r.negative = a.negative != b.negative;
+        return r;
+    }
+
+    // Truncating division, as for built-in integers: the quotient rounds
+    // toward zero and the remainder takes the dividend's sign.
+    static std::pair<BigInt, BigInt> divMod(const BigInt& a, const BigInt& b) {
+        if (b.limbs.empty())
+            throw std::domain_error("BigInt: division by zero");
+        std::pair<BigInt, BigInt> qr;
+        if (compareMagnitude(a.limbs, b.limbs) < 0) {
+            qr.second = a;
+            return qr;
+        }
+        if (b.limbs.size() == 1) {
+            qr.first = a.abs();
+            qr.second = BigInt(static_cast<int64_t>(qr.first.divSmall(b.limbs[0])));
+        }
+        else {
+            divideKnuth(a.limbs, b.limbs, qr.first.limbs, qr.second.limbs);
+        }
+        qr.first.negative = !qr.first.limbs.empty() && a.negative != b.negative;
+        qr.second.negative = !qr.second.limbs.empty() && a.negative;
+        return qr;
+    }
+
+    static BigInt gcd(BigInt a, BigInt b) {
+        a.negative = b.negative = false;
+        while (!b.limbs.empty()) {
+            BigInt r = divMod(a, b).second;
+            a = std::move(b);
+            b = std::move(r);
+        }
+        return a;
+    }
+
+    friend bool operator==(const BigInt& a, const BigInt& b) { return a.negative == b.negative && a.limbs == b.limbs; }
+    friend bool operator!=(const BigInt& a, const BigInt& b) { return !(a == b); }
+    friend bool operator<(const BigInt& a, const BigInt& b) {
+        if (a.negative != b.negative)
+            return a.negative;
+        int c = compareMagnitude(a.limbs, b.limbs);
+        return a.negative ? c > 0 : c < 0;
+    }
+    friend bool operator>(const BigInt& a, const BigInt& b) { return b < a; }
+    friend bool operator<=(const BigInt& a, const BigInt& b) { return !(b < a); }
+    friend bool operator>=(const BigInt& a, const BigInt& b) { return !(a < b); }
+
+    uint64_t hash() const {
+        uint64_t h = negative ? 0x9e3779b97f4a7c15ull : 1469598103934665603ull;
+        for (uint32_t limb : limbs)
+            h = (h ^ limb) * 1099511628211ull;
+        return h;
+    }
+
+    // Nearest double, or +-inf beyond its range.
+    double toDouble() const {
+        double r = 0;
+        for (size_t i = limbs.size(); i-- > 0;)
+            r = r * 4294967296.0 + limbs[i];
+        return negative ? -r : r;
+    }
+
+    size_t limbCount() const { return limbs.size(); }
+
+    friend std::ostream& operator<<(std::ostream& os, const BigInt& v) { return os << v.toString(); }
+
+private:
+    bool negative = false;
+    std::vector<uint32_t> limbs;
+
+    void trim() {
+        while (!limbs.empty() && limbs.back() == 0)
+            limbs.pop_back();
+    }
+
+    static int compareMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+        if (a.size() != b.size())
+            return a.size() < b.size() ? -1 : 1;
+        for (size_t i = a.size(); i-- > 0;)
+            if (a[i] != b[i])
+                return a[i] < b[i] ? -1 : 1;
+        return 0;
+    }
+
+    void addMagnitude(const std::vector<uint32_t>& o) {
+        if (limbs.size() < o.size())
+            limbs.resize(o.size(), 0);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < limbs.size(); ++i) {
+            uint64_t t = uint64_t(limbs[i]) + (i < o.size() ? o[i] : 0) + carry;
+            limbs[i] = static_cast<uint32_t>(t);
+            carry = t >> 32;
+            if (!carry && i >= o.size())
+                break;
+        }
+        if (carry)
+            limbs.push_back(static_cast<uint32_t>(carry));
+    }
+
+    // |*this| -= |o|, requires |*this| >= |o|.
+    void subMagnitude(const std::vector<uint32_t>& o) {
+        int64_t borrow = 0;
+        for (size_t i = 0; i < limbs.size(); ++i) {
+            int64_t t = int64_t(limbs[i]) - (i < o.size() ? o[i] : 0) - borrow;
+            borrow = t < 0;
+            limbs[i] = static_cast<uint32_t>(t + (borrow << 32));
+            if (!borrow && i >= o.size())
+                break;
+        }
+        trim();
+    }
+
+    // |*this| = |*this| * factor + addend.
+    void mulAddSmall(uint32_t factor, uint32_t addend) {
+        uint64_t carry = addend;
+        for (uint32_t& limb : limbs) {
+            uint64_t t = uint64_t(limb) * factor + carry;
+            limb = static_cast<uint32_t>(t);
+            carry = t >> 32;
+        }
+        if (carry)
+            limbs.push_back(static_cast<uint32_t>(carry));
+    }
+
+    // |*this| /= divisor; returns the remainder.
+    uint32_t divSmall(uint32_t divisor) {
+        uint64_t rem = 0;
+        for (size_t i = limbs.size(); i-- > 0;) {
+            uint64_t cur = (rem << 32) | limbs[i];
+            limbs[i] = static_cast<uint32_t>(cur / divisor);
+            rem = cur % divisor;
+        }
+        trim();
+        return static_cast<uint32_t>(rem);
+    }
+
+    // Knuth, TAOCP vol. 2, 4.3.1 algorithm D, in the form of Hacker's
+    // Delight's divmnu: |u| / |v| for |u| >= |v| and v of two limbs or more.
+    static void divideKnuth(const std::vector<uint32_t>& u, const std::vector<uint32_t>& v,
+        std::vector<uint32_t>& quotient, std::vector<uint32_t>& remainder) {
+        const uint64_t base = uint64_t(1) << 32;
+        size_t m = u.size(), n = v.size();
+        int shift = 0;
+        for (uint32_t top = v[n - 1]; !(top & 0x80000000u); top <<= 1)
+            ++shift;
+
+        // Normalize so the divisor's top limb has its high bit set.
+        std::vector<uint32_t> vn(n), un(m + 1);
+        for (size_t i = n - 1; i > 0; --i)
+            vn[i] = (v[i] << shift) | (shift ? v[i - 1] >> (32 - shift) : 0);
+        vn[0] = v[0] << shift;
+        un[m] = shift ? u[m - 1] >> (32 - shift) : 0;
+        for (size_t i = m - 1; i > 0; --i)
+            un[i] = (u[i] << shift) | (shift ? u[i - 1] >> (32 - shift) : 0);
+        un[0] = u[0] << shift;
+
+        quotient.assign(m - n + 1, 0);
+        for (size_t j = m - n + 1; j-- > 0;) {
+            // Estimate the quotient limb from the top two limbs; it is at
+            // most two too large, and the loop below catches most of that.
+            uint64_t numerator = (uint64_t(un[j + n]) << 32) | un[j + n - 1];
+            uint64_t qhat = numerator / vn[n - 1], rhat = numerator % vn[n - 1];
+            while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+                --qhat;
+                rhat += vn[n - 1];
+                if (rhat >= base)
+                    break;
+            }
+
+            // un[j .. j + n] -= qhat * vn.
+            int64_t borrow = 0, t;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t p = qhat * vn[i];
+                t = int64_t(un[i + j]) - borrow - int64_t(p & 0xffffffffu);
+                un[i + j] = static_cast<uint32_t>(t);
+                borrow = int64_t(p >> 32) - (t >> 32);
+            }
+            t = int64_t(un[j + n]) - borrow;
+            un[j + n] = static_cast<uint32_t>(t);
+
+            quotient[j] = static_cast<uint32_t>(qhat);
+            if (t < 0) {
+                // qhat was one too large: add the divisor back.
+                --quotient[j];
+                uint64_t carry = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    uint64_t s = uint64_t(un[i + j]) + vn[i] + carry;
+                    un[i + j] = static_cast<uint32_t>(s);
+                    carry = s >> 32;
+                }
+                un[j + n] = static_cast<uint32_t>(un[j + n] + carry);
+            }
+        }
+
+        remainder.assign(n, 0);
+        for (size_t i = 0; i < n; ++i)
+            remainder[i] = (un[i] >> shift) | (shift ? un[i + 1] << (32 - shift) : 0);
+        while (!quotient.empty() && quotient.back() == 0)
+            quotient.pop_back();
+        while (!remainder.empty() && remainder.back() == 0)
+            remainder.pop_back();
+    }
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+// What BasicPolinom<C> needs from its coefficient ring C. The primary
+// template describes an exact ring: C is constructible from int64_t, has
+// + - * and ==, prints with <<, and provides
+//   static C parse(const std::string& text, size_t pos, size_t& end);
+// which reads the coefficient at text[pos] and sets `end` past it, and
+//   uint64_t hash() const;
+// Zero is exactly C(0) and equality is exact.
+//
+// Accumulator is what the multiply kernels sum products of pairs into. It
+// defaults to C; a ring whose products can be added up unreduced (ModInt)
+// supplies a cheaper one. Accumulator() must be zero.
+template <class C>
+struct CoeffTraits {
+    using Accumulator = C;
+
+    static bool isZero(const C& c) { return c == C(0); }
+    static bool equal(const C& a, const C& b) { return a == b; }
+    // Whether operator<< prints the coefficient with a leading '-'.
+    static bool isNegative(const C& c) { return c.isNegative(); }
+    static C parse(const std::string& text, size_t pos, size_t& end) { return C::parse(text, pos, end); }
+    static void write(std::ostream& os, const C& c) { os << c; }
+    static uint64_t hash(const C& c) { return c.hash(); }
+
+    static void multiplyAdd(Accumulator& acc, const C& a, const C& b) { acc += a * b; }
+    static void merge(Accumulator& into, const Accumulator& from) { into += from; }
+    static C reduce(const Accumulator& acc) { return acc; }
+};
+
+// double keeps the library's historical semantics: coefficients within
+// 1e-10 of zero are dropped and compare equal to zero.
+template <>
+struct CoeffTraits<double> {
+    using Accumulator = double;
+
+    static constexpr double kEpsilon = 1e-10;
+
+    static bool isZero(double c) { return !(std::fabs(c) > kEpsilon); }
+    static bool equal(double a, double b) { return std::abs(a - b) < kEpsilon; }
+    static bool isNegative(double c) { return !(c > 0); }
+    static double parse(const std::string& text, size_t pos, size_t& end) {
+        size_t used = 0;
+        double value = std::stod(text.substr(pos), &used);
+        end = pos + used;
+        return value;
+    }
+    static void write(std::ostream& os, double c) { os << c; }
+    static uint64_t hash(double c) {
+        uint64_t bits;
+        std::memcpy(&bits, &c, sizeof(bits));
+        return bits;
+    }
+
+    static void multiplyAdd(double& acc, double a, double b) { acc += a * b; }
+    static void merge(double& into, double from) { into += from; }
+    static double reduce(double acc) { return acc; }
+};
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "arena.h"
+#include "polinom.h"
+#include "scheduler.h"
+
+struct ExprNode {
+    enum class Op { Constant, Variable, Add, Subtract, Multiply, Negate };
+
+    Op op = Op::Constant;
+    int lhs = -1;
+    int rhs = -1;
+    double value = 0.0;
+    std::string name;
+};
+
+// Expression over named polynomials, e.g. "a*b + c*(d - 2)". Parsing builds a
+// DAG: identical subexpressions (including a*b vs b*a) become one node, and
+// nodes are stored children-first with the root last.
+//
+// Evaluation takes a resolver, any callable mapping a name to a Polinom.
+// Parallel evaluation calls it from worker threads, so it must be safe to
+// call concurrently.
+class Expression {
+private:
+    std::vector<ExprNode> nodes;
+
+    class Parser {
+        const std::string& text;
+        size_t pos = 0;
+        std::vector<ExprNode>& nodes;
+        std::map<std::tuple<int, int, int, std::string, double>, int> seen;
+
+        void skipSpace() {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+        }
+
+        int intern(ExprNode node) {
+            if ((node.op == ExprNode::Op::Add || node.op == ExprNode::Op::Multiply) && node.lhs > node.rhs)
+                std::swap(node.lhs, node.rhs);
+            auto key = std::make_tuple(static_cast<int>(node.op), node.lhs, node.rhs, node.name, node.value);
+            auto it = seen.find(key);
+            if (it != seen.end())
+                return it->second;
+            nodes.push_back(std::move(node));
+            int index = static_cast<int>(nodes.size()) - 1;
+            seen.emplace(key, index);
+            return index;
+        }
+
+        int binary(ExprNode::Op op, int lhs, int rhs) {
+            ExprNode node;
+            node.op = op;
+            node.lhs = lhs;
+            node.rhs = rhs;
+            return intern(std::move(node));
+        }
+
+        int parsePrimary() {
+            skipSpace();
+            if (pos >= text.size())
+                throw std::runtime_error("Unexpected end of expression");
+            char c = text[pos];
+            if (c == '(') {
+                pos++;
+                int inner = parseSum();
+                skipSpace();
+                if (pos >= text.size() || text[pos] != ')')
+                    throw std::runtime_error("Expected ')' in expression");
+                pos++;
+                return inner;
+            }
+            if (c == '-') {
+                pos++;
+                ExprNode node;
+                node.op = ExprNode::Op::Negate;
+                node.lhs = parsePrimary();
+                return intern(std::move(node));
+            }
+            if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+                size_t used = 0;
+                ExprNode node;
+                node.op = ExprNode::Op::Constant;
+                try {
+                    node.value = std::stod(text.substr(pos), &used);
+                }
+                catch (...) {
+                    throw std::runtime_error("Invalid number in expression");
+                }
+                pos += used;
+                return intern(std::move(node));
+            }
+            if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+                size_t start = pos;
+                while (pos < text.size() && (std::isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '_'))
+                    pos++;
+                ExprNode node;
+                node.op = ExprNode::Op::Variable;
+                node.name = text.substr(start, pos - start);
+                return intern(std::move(node));
+            }
+            throw std::runtime_error("Unexpected character in expression: " + std::string(1, c));
+        }
+
+        int parseProduct() {
+            int lhs = parsePrimary();
+            for (;;) {
+                skipSpace();
+                if (pos < text.size() && text[pos] == '*') {
+                    pos++;
+                    lhs = binary(ExprNode::Op::Multiply, lhs, parsePrimary());
+                }
+                else {
+                    return lhs;
+                }
+            }
+        }
+
+        int parseSum() {
+            int lhs = parseProduct();
+            for (;;) {
+                skipSpace();
+                if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+                    ExprNode::Op op = text[pos] == '+' ? ExprNode::Op::Add : ExprNode::Op::Subtract;
+                    pos++;
+                    lhs = binary(op, lhs, parseProduct());
+                }
+                else {
+                    return lhs;
+                }
+            }
+        }
+
+    public:
+        Parser(const std::string& source, std::vector<ExprNode>& out) : text(source), nodes(out) {}
+
+        void parse() {
+            int root = parseSum();
+            skipSpace();
+            if (pos != text.size())
+                throw std::runtime_error("Unexpected character in expression: " + std::string(1, text[pos]));
+            // A node cannot equal one of its own subexpressions, so the root
+            // is always the last node interned.
+            if (root != static_cast<int>(nodes.size()) - 1)
+                throw std::logic_error("Expression root is not the last node");
+        }
+    };
+
+    static Polinom constant(double value, std::pmr::memory_resource* resource) {
+        return Polinom(std::vector<Monom>{ Monom(0, value) }, resource);
+    }
+
+    template<typename Resolver>
+    Polinom apply(const ExprNode& node, const Polinom* lhs, const Polinom* rhs,
+        Resolver& resolve, std::pmr::memory_resource* resource) const {
+        switch (node.op) {
+        case ExprNode::Op::Constant:
+            return constant(node.value, resource);
+        case ExprNode::Op::Variable:
+            return Polinom(resolve(node.name), resource);
+        case ExprNode::Op::Add:
+            return lhs->add(*rhs, resource);
+        case ExprNode::Op::Subtract:
+            return lhs->subtract(*rhs, resource);
+        case ExprNode::Op::Negate:
+            return lhs->scale(-1.0, resource);
+        case ExprNode::Op::Multiply:
+            if (nodes[node.lhs].op == ExprNode::Op::Constant)
+                return rhs->scale(nodes[node.lhs].value, resource);
+            if (nodes[node.rhs].op == ExprNode::Op::Constant)
+                return lhs->scale(nodes[node.rhs].value, resource);
+            return lhs->multiply(*rhs, resource);
+        }
+        throw std::logic_error("Unknown expression node");
+    }
+
+    struct TableResolver {
+        const std::map<std::string, Polinom>& table;
+
+        const Polinom& operator()(const std::string& name) const {
+            auto it = table.find(name);
+            if (it == table.end())
+                throw std::runtime_error("Unknown polinom: " + name);
+            return it->second;
+        }
+    };
+
+    struct ParallelEvaluation {
+        std::vector<std::unique_ptr<PolinomArena>> arenas;
+        std::vector<std::optional<Polinom>> values;
+        std::vector<std::vector<int>> parents;
+        std::unique_ptr<std::atomic<int>[]> waiting;
+        std::atomic<size_t> outstanding{ 0 };
+        std::atomic<bool> failed{ false };
+        std::exception_ptr error;
+        std::mutex lock;
+        std::condition_variable finished;
+        bool done = false;
+    };
+
+    template<typename Resolver>
+    void runNode(const std::shared_ptr<ParallelEvaluation>& state, int index,
+        Resolver& resolve, TaskScheduler& scheduler) const {
+        if (!state->failed.load(std::memory_order_acquire)) {
+            try {
+                POLINOM_TRACE_SPAN("eval_node", index);
+                size_t worker = static_cast<size_t>(scheduler.workerIndex());
+                if (!state->arenas[worker])
+                    state->arenas[worker] = std::make_unique<PolinomArena>();
+                const ExprNode& node = nodes[index];
+                const Polinom* lhs = node.lhs >= 0 ? &*state->values[node.lhs] : nullptr;
+                const Polinom* rhs = node.rhs >= 0 ? &*state->values[node.rhs] : nullptr;
+                state->values[index].emplace(apply(node, lhs, rhs, resolve, state->arenas[worker]->resource()));
+
+                for (int parent : state->parents[index]) {
+                    if (state->waiting[parent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        state->outstanding.fetch_add(1, std::memory_order_relaxed);
+                        scheduler.submit([this, state, parent, &resolve, &scheduler] {
+                            runNode(state, parent, resolve, scheduler);
+                        });
+                    }
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> guard(state->lock);
+                if (!state->error)
+                    state->error = std::current_exception();
+                state->failed.store(true, std::memory_order_release);
+            }
+        }
+        if (state->outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> guard(state->lock);
+            state->done = true;
+            state->finished.notify_all();
+        }
+    }
+
+public:
+    Expression() = default;
+    explicit Expression(const std::string& text) {
+        POLINOM_TRACE_SPAN("parse_expression");
+        Parser(text, nodes).parse();
+    }
+
+    static Expression parse(const std::string& text) { return Expression(text); }
+
+    const std::vector<ExprNode>& getNodes() const { return nodes; }
+    size_t size() const { return nodes.size(); }
+
+    std::vector<std::string> variables() const {
+        std::vector<std::string> names;
+        for (const auto& n : nodes)
+            if (n.op == ExprNode::Op::Variable)
+                names.push_back(n.name);
+        return names;
+    }
+
+    // Evaluates on the calling thread with all intermediates in one arena.
+    template<typename Resolver, typename = std::enable_if_t<std::is_invocable_v<Resolver&, const std::string&>>>
+    Polinom evaluate(Resolver&& resolve) const {
+        if (nodes.empty())
+            throw std::runtime_error("Empty expression");
+        POLINOM_METRIC_TIME(Evaluate);
+        POLINOM_TRACE_SPAN("evaluate");
+        PolinomArena arena;
+        std::vector<Polinom> values;
+        values.reserve(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            POLINOM_TRACE_SPAN("eval_node", static_cast<int64_t>(i));
+            const ExprNode& node = nodes[i];
+            const Polinom* lhs = node.lhs >= 0 ? &values[node.lhs] : nullptr;
+            const Polinom* rhs = node.rhs >= 0 ? &values[node.rhs] : nullptr;
+            values.push_back(apply(node, lhs, rhs, resolve, arena.resource()));
+        }
+        return Polinom(values.back(), std::pmr::get_default_resource());
+    }
+
+    // Evaluates independent nodes concurrently on `scheduler`. Every worker
+    // keeps its intermediates in its own arena, released when the call
+    // returns. Called from one of the scheduler's own workers it falls back
+    // to evaluate() rather than block a worker.
+    template<typename Resolver, typename = std::enable_if_t<std::is_invocable_v<Resolver&, const std::string&>>>
+    Polinom evaluate(Resolver&& resolve, TaskScheduler& scheduler) const {
+        if (nodes.empty())
+            throw std::runtime_error("Empty expression");
+        if (scheduler.workerIndex() >= 0)
+            return evaluate(resolve);
+        POLINOM_METRIC_TIME(Evaluate);
+        POLINOM_TRACE_SPAN("evaluate");
+
+        auto state = std::make_shared<ParallelEvaluation>();
+        std::vector<int> ready;
+        {
+            POLINOM_TRACE_SPAN("plan");
+            state->arenas.resize(scheduler.size());
+            state->values.resize(nodes.size());
+            state->parents.resize(nodes.size());
+            state->waiting.reset(new std::atomic<int>[nodes.size()]);
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                int children = 0;
+                if (nodes[i].lhs >= 0) {
+                    state->parents[nodes[i].lhs].push_back(static_cast<int>(i));
+                    ++children;
+                }
+                if (nodes[i].rhs >= 0) {
+                    state->parents[nodes[i].rhs].push_back(static_cast<int>(i));
+                    ++children;
+                }
+                state->waiting[i].store(children, std::memory_order_relaxed);
+                if (children == 0)
+                    ready.push_back(static_cast<int>(i));
+            }
+        }
+
+        state->outstanding.store(ready.size(), std::memory_order_relaxed);
+        for (int leaf : ready) {
+            scheduler.submit([this, state, leaf, &resolve, &scheduler] {
+                runNode(state, leaf, resolve, scheduler);
+            });
+        }
+
+        std::unique_lock<std::mutex> guard(state->lock);
+        state->finished.wait(guard, [&] { return state->done; });
+        if (state->error)
+            std::rethrow_exception(state->error);
+        return Polinom(*state->values.back(), std::pmr::get_default_resource());
+    }
+
+    Polinom evaluate(const std::map<std::string, Polinom>& table) const {
+        return evaluate(TableResolver{ table });
+    }
+
+    Polinom evaluate(const std::map<std::string, Polinom>& table, TaskScheduler& scheduler) const {
+        return evaluate(TableResolver{ table }, scheduler);
+    }
+};
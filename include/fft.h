@@ -0,0 +1,298 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+#include "kronecker.h"
+
+// FFT multiplication: a product is Kronecker-packed (kronecker.h) into one
+// univariate convolution of length L and computed in O(L log L).
+//
+// Floating-point FFTs lose precision relative to the largest coefficient,
+// so the operands are not transformed as they are. Every coefficient is
+// snapped to a grid q * u, u a power of two and |q| < 2^2K, and q is split
+// into halves q = qh * 2^K + ql. The three partial convolutions of halves
+// have integer values, and K is chosen so the FFT error on them stays under
+// 1/2; rounding then recovers them exactly. Integer coefficients, and dyadic
+// fractions such as 0.25, of up to 2K significant bits therefore multiply
+// exactly. For other doubles the snap error is weighed against the plain
+// FFT rounding error on a grid as fine as the data; the cheaper one is
+// used and the error estimate accounts for it.
+namespace detail {
+
+using Complex = std::complex<double>;
+
+// std::complex's operator* checks for inf/nan; finite inputs never need it.
+inline Complex complexMul(Complex a, Complex b) {
+    return Complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+// Roots e^(-2 pi i k / n) for k < n / 2, n being the largest transform size
+// seen on this thread; a size-m transform reads every (n / m)-th one. Each
+// root is computed directly, not by repeated multiplication, so it is within
+// a few ulps, which the error bound relies on.
+inline const std::vector<Complex>& fftRoots(size_t n) {
+    thread_local std::vector<Complex> roots;
+    if (2 * roots.size() < n) {
+        const double tau = 2.0 * std::acos(-1.0);
+        roots.resize(n / 2);
+        for (size_t k = 0; k < n / 2; ++k)
+            roots[k] = std::polar(1.0, -tau * static_cast<double>(k) / static_cast<double>(n));
+    }
+    return roots;
+}
+
+// In-place iterative radix-2 transform of a power-of-two length. The
+// inverse is unscaled. Butterflies work on the interleaved doubles, which
+// std::complex guarantees, so the compiler can keep them in registers.
+inline void fft(std::vector<Complex>& a, bool inverse) {
+    size_t n = a.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(a[i], a[j]);
+    }
+    const std::vector<Complex>& roots = fftRoots(n);
+    size_t top = 2 * roots.size();
+    double sign = inverse ? -1.0 : 1.0;
+    double* data = reinterpret_cast<double*>(a.data());
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2, stride = top / len;
+        for (size_t i = 0; i < n; i += len) {
+            double* lo = data + 2 * i;
+            double* hi = lo + 2 * half;
+            for (size_t k = 0; k < half; ++k) {
+                double wr = roots[k * stride].real(), wi = sign * roots[k * stride].imag();
+                double vr = hi[2 * k] * wr - hi[2 * k + 1] * wi, vi = hi[2 * k] * wi + hi[2 * k + 1] * wr;
+                double ur = lo[2 * k], ui = lo[2 * k + 1];
+                lo[2 * k] = ur + vr;
+                lo[2 * k + 1] = ui + vi;
+                hi[2 * k] = ur - vr;
+                hi[2 * k + 1] = ui - vi;
+            }
+        }
+    }
+}
+
+// Exponent of the lowest set bit of c != 0, i.e. c = odd * 2^e.
+inline int lowestBitExponent(double c) {
+    uint64_t bits;
+    std::memcpy(&bits, &c, sizeof bits);
+    int biased = static_cast<int>(bits >> 52 & 0x7ff);
+    uint64_t mantissa = bits & ((uint64_t(1) << 52) - 1);
+    if (biased)
+        mantissa |= uint64_t(1) << 52;
+    else
+        biased = 1;
+    // c = mantissa * 2^(biased - 1075); the lowest set bit alone converts
+    // to double exactly, and its exponent field is its position.
+    double low = static_cast<double>(mantissa & (~mantissa + 1));
+    std::memcpy(&bits, &low, sizeof bits);
+    return biased - 1075 + static_cast<int>(bits >> 52 & 0x7ff) - 1023;
+}
+
+// Round to nearest for |v| < 2^51, without the libm call std::nearbyint
+// costs on baseline x86-64.
+inline double roundToInteger(double v) {
+    const double magic = 6755399441055744.0;  // 1.5 * 2^52
+    return (v + magic) - magic;
+}
+
+// What the grid choice needs to know about one operand.
+struct GridStats {
+    double maxAbs = 0;
+    int finest = INT_MAX;  // lowestBitExponent over the nonzero coefficients
+    double l1 = 0;
+    double l2 = 0;
+};
+
+inline GridStats scanOperand(const std::vector<double>& x) {
+    GridStats s;
+    for (double c : x) {
+        if (c == 0)
+            continue;
+        s.maxAbs = std::max(s.maxAbs, std::fabs(c));
+        s.finest = std::min(s.finest, lowestBitExponent(c));
+        s.l1 += std::fabs(c);
+        s.l2 += c * c;
+    }
+    s.l2 = std::sqrt(s.l2);
+    return s;
+}
+
+// Coarsest grid that still gives the largest coefficient 2K bits, or the
+// data's own finest bit if that is coarser still. The snap is exact iff
+// the result is s.finest.
+inline int unitExponent(const GridStats& s, int k) {
+    return s.maxAbs == 0 ? 0 : std::max(std::ilogb(s.maxAbs) + 1 - 2 * k, s.finest);
+}
+
+inline double snapBound(const GridStats& s, int k) {
+    int e = unitExponent(s, k);
+    return s.maxAbs == 0 || e == s.finest ? 0.0 : std::ldexp(0.5, e);
+}
+
+// One operand on the grid, halves packed as high + i * low so a single
+// complex transform carries both.
+struct FftOperand {
+    std::vector<Complex> packed;
+    int unitExponent = 0;  // u = 2^unitExponent
+    double snapError = 0;  // max |x - q * u|
+    double l2 = 0;         // ||qh + i ql||_2
+};
+
+inline FftOperand snapToGrid(const std::vector<double>& x, const GridStats& stats, size_t length, int k) {
+    FftOperand out;
+    out.packed.assign(length, Complex());
+    out.unitExponent = unitExponent(stats, k);
+    double toGrid = std::ldexp(1.0, -out.unitExponent), fromGrid = std::ldexp(1.0, out.unitExponent);
+    double halfScale = std::ldexp(1.0, k), toHalf = std::ldexp(1.0, -k);
+    double squares = 0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        double q = roundToInteger(x[i] * toGrid);
+        out.snapError = std::max(out.snapError, std::fabs(x[i] - q * fromGrid));
+        double high = roundToInteger(q * toHalf), low = q - high * halfScale;
+        out.packed[i] = Complex(high, low);
+        squares += high * high + low * low;
+    }
+    out.l2 = std::sqrt(squares);
+    return out;
+}
+
+// (a + da)(b + db) - ab summed over the pairs of one output power, for
+// snap errors |da| <= da, |db| <= db.
+inline double snapErrorBound(double da, const GridStats& a, size_t na, double db, const GridStats& b, size_t nb) {
+    return da * b.l1 + db * a.l1 + da * db * static_cast<double>(std::min(na, nb));
+}
+
+}
+
+struct FftConvolution {
+    std::vector<double> values;
+    // Bound on |values[i] - exact[i]|, not counting the final rounding of
+    // the exact value to double. Zero when the inputs sat on the grid.
+    double error = 0;
+};
+
+// a * b as univariate coefficient vectors, lowest power first.
+inline FftConvolution fftConvolve(const std::vector<double>& a, const std::vector<double>& b) {
+    FftConvolution result;
+    if (a.empty() || b.empty())
+        return result;
+    size_t length = a.size() + b.size() - 1, n = 1;
+    int levels = 0;
+    for (; n < length; n <<= 1)
+        ++levels;
+
+    // Percival's bound for a floating-point convolution by FFT,
+    // |error| <= ||x||_2 ||y||_2 (12 log2 n + 3) u for accurate roots, with
+    // u = eps / 2 the unit roundoff. Unpacking the half spectra adds at most
+    // 5u, giving 12 log2 n + 8, and each inverse transform carries two
+    // convolutions (hh + i ll, hl + lh), which doubles it:
+    // factor = 2 (12 log2 n + 8) u. Halves are at most 2^K, so
+    // ||x||_2 ||y||_2 <= 1.25 * 2^2K * sqrt(|a| |b|); kExact is the largest
+    // K that keeps that worst case under 1/4, so the halves round exactly.
+    const double u = std::numeric_limits<double>::epsilon() / 2;
+    const double factor = 2.0 * (12.0 * levels + 8.0) * u;
+    double worst = 1.25 * factor * std::sqrt(static_cast<double>(a.size()) * static_cast<double>(b.size()));
+    const int kFine = 25;
+    int kExact = std::max(1, std::min(kFine, static_cast<int>(std::floor(std::log2(0.25 / worst))) / 2));
+
+    // Data that does not fit the kExact grid pays for snapping to it. When
+    // that costs more than the plain FFT rounding on the fine grid, where the
+    // snap is below an ulp of the largest coefficient, take the fine grid
+    // and leave the halves unrounded.
+    detail::GridStats sa = detail::scanOperand(a), sb = detail::scanOperand(b);
+    // Grid units are applied as power-of-two factors, which must stay normal.
+    for (const detail::GridStats* s : { &sa, &sb }) {
+        if (s->maxAbs != 0 && (std::ilogb(s->maxAbs) > 900 || s->finest < -900)) {
+            result.values.assign(length, 0.0);
+            result.error = std::numeric_limits<double>::infinity();
+            return result;
+        }
+    }
+    int k = kExact;
+    double exactCost = detail::snapErrorBound(detail::snapBound(sa, kExact), sa, a.size(),
+        detail::snapBound(sb, kExact), sb, b.size());
+    if (exactCost > 0) {
+        double fineCost = sa.l2 * sb.l2 * factor * 1.25 + detail::snapErrorBound(detail::snapBound(sa, kFine), sa,
+            a.size(), detail::snapBound(sb, kFine), sb, b.size());
+        if (fineCost < exactCost)
+            k = kFine;
+    }
+
+    detail::FftOperand x = detail::snapToGrid(a, sa, n, k), y = detail::snapToGrid(b, sb, n, k);
+    detail::fft(x.packed, false);
+    detail::fft(y.packed, false);
+
+    // Unpack the spectra of the four real halves, then transform back
+    // qh_a*qh_b + i ql_a*ql_b and qh_a*ql_b + ql_a*qh_b.
+    std::vector<detail::Complex> outer(n), cross(n);
+    const detail::Complex minusHalfI(0, -0.5);
+    for (size_t i = 0; i < n; ++i) {
+        size_t j = (n - i) & (n - 1);
+        detail::Complex xh = (x.packed[i] + std::conj(x.packed[j])) * 0.5;
+        detail::Complex xl = detail::complexMul(x.packed[i] - std::conj(x.packed[j]), minusHalfI);
+        detail::Complex yh = (y.packed[i] + std::conj(y.packed[j])) * 0.5;
+        detail::Complex yl = detail::complexMul(y.packed[i] - std::conj(y.packed[j]), minusHalfI);
+        detail::Complex lows = detail::complexMul(xl, yl);
+        outer[i] = detail::complexMul(xh, yh) + detail::Complex(-lows.imag(), lows.real());
+        cross[i] = detail::complexMul(xh, yl) + detail::complexMul(xl, yh);
+    }
+    detail::fft(outer, true);
+    detail::fft(cross, true);
+
+    double fftError = x.l2 * y.l2 * factor;
+    bool exactHalves = fftError < 0.5;
+    double inverseN = 1.0 / static_cast<double>(n);
+    double highScale = std::ldexp(1.0, 2 * k), crossScale = std::ldexp(1.0, k);
+    // The two units separately: their product can leave the normal range
+    // even where the result does not.
+    double unitX = std::ldexp(1.0, x.unitExponent), unitY = std::ldexp(1.0, y.unitExponent);
+    result.values.resize(length);
+    for (size_t i = 0; i < length; ++i) {
+        double hh = outer[i].real() * inverseN, ll = outer[i].imag() * inverseN, hl = cross[i].real() * inverseN;
+        if (exactHalves) {
+            hh = detail::roundToInteger(hh);
+            ll = detail::roundToInteger(ll);
+            hl = detail::roundToInteger(hl);
+        }
+        result.values[i] = (ll + hl * crossScale + hh * highScale) * unitX * unitY;
+    }
+
+    result.error = detail::snapErrorBound(x.snapError, sa, a.size(), y.snapError, sb, b.size());
+    if (!exactHalves)
+        result.error += fftError * (highScale + crossScale + 1) * unitX * unitY;
+    return result;
+}
+
+struct FftProduct {
+    Polinom product;
+    double error = 0;       // FftConvolution::error of the FFT attempt
+    bool fellBack = false;  // error exceeded the tolerance; product is Polinom::multiply's
+};
+
+// a * b by FFT, unless the error estimate exceeds `tolerance`; then the
+// product is recomputed by the term-by-term kernels of Polinom::multiply.
+// The default tolerance is the cut below which coefficients count as zero.
+inline FftProduct multiplyFft(const Polinom& a, const Polinom& b, double tolerance = 1e-10,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+    if (a.empty() || b.empty())
+        return FftProduct{ Polinom(resource), 0.0, false };
+    KroneckerLayout layout = KroneckerLayout::forProduct(a, b);
+    FftConvolution conv = fftConvolve(layout.toDense(a), layout.toDense(b));
+    if (conv.error > tolerance)
+        return FftProduct{ a.multiply(b, resource), conv.error, true };
+    size_t lo = layout.pack(a.getMonoms().back().degree) + layout.pack(b.getMonoms().back().degree);
+    return FftProduct{ layout.fromDense(conv.values, lo, resource), conv.error, false };
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <charconv>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include "polinom.h"
+
+struct FormatOptions {
+    // Negative: shortest representation that parses back to the same double.
+    // Otherwise: fixed notation with this many digits after the point.
+    int precision = -1;
+};
+
+// Upper bound on the characters formatPolinom writes for p.
+inline size_t maxFormattedSize(const Polinom& p, FormatOptions opts = FormatOptions()) {
+    // sign + fixed-notation double (DBL_MAX has 309 integral digits, the
+    // smallest subnormal needs 324 fractional ones) + "x^9y^9z^9"
+    size_t coeffChars = 2 + 330 + (opts.precision > 0 ? static_cast<size_t>(opts.precision) : 0);
+    return 1 + p.size() * (coeffChars + 9);
+}
+
+inline std::to_chars_result formatMonom(char* first, char* last, const Monom& m, FormatOptions opts = FormatOptions()) {
+    if (m.coeff == -1.0 && m.degree != 0) {
+        if (first == last)
+            return { last, std::errc::value_too_large };
+        *first++ = '-';
+    }
+    else if (m.coeff != 1.0 || m.degree == 0) {
+        std::to_chars_result r = opts.precision < 0
+            ? std::to_chars(first, last, m.coeff, std::chars_format::fixed)
+            : std::to_chars(first, last, m.coeff, std::chars_format::fixed, opts.precision);
+        if (r.ec != std::errc())
+            return r;
+        first = r.ptr;
+    }
+
+    const char vars[3] = { 'x', 'y', 'z' };
+    const int powers[3] = { m.degree / 100, (m.degree / 10) % 10, m.degree % 10 };
+    for (int v = 0; v < 3; ++v) {
+        if (powers[v] == 0)
+            continue;
+        size_t need = powers[v] > 1 ? 3 : 1;
+        if (static_cast<size_t>(last - first) < need)
+            return { last, std::errc::value_too_large };
+        *first++ = vars[v];
+        if (powers[v] > 1) {
+            *first++ = '^';
+            *first++ = static_cast<char>('0' + powers[v]);
+        }
+    }
+    return { first, std::errc() };
+}
+
+// Writes p in the same syntax as operator<< into [first, last). Output is not
+// NUL-terminated; on overflow returns errc::value_too_large like std::to_chars.
+inline std::to_chars_result formatPolinom(char* first, char* last, const Polinom& p, FormatOptions opts = FormatOptions()) {
+    const auto& monoms = p.getMonoms();
+    if (monoms.empty()) {
+        if (first == last)
+            return { last, std::errc::value_too_large };
+        *first++ = '0';
+        return { first, std::errc() };
+    }
+    for (size_t i = 0; i < monoms.size(); ++i) {
+        if (i > 0 && monoms[i].coeff > 0) {
+            if (first == last)
+                return { last, std::errc::value_too_large };
+            *first++ = '+';
+        }
+        std::to_chars_result r = formatMonom(first, last, monoms[i], opts);
+        if (r.ec != std::errc())
+            return r;
+        first = r.ptr;
+    }
+    return { first, std::errc() };
+}
+
+// Appends p to out. Tries a typical-size buffer first and only falls back to
+// the worst-case bound for extreme coefficients.
+inline void appendPolinom(std::string& out, const Polinom& p, FormatOptions opts = FormatOptions()) {
+    POLINOM_TRACE_SPAN("format");
+    size_t used = out.size();
+    size_t typical = 1 + p.size() * (24 + (opts.precision > 0 ? static_cast<size_t>(opts.precision) : 0));
+    out.resize(used + typical);
+    std::to_chars_result r = formatPolinom(&out[used], &out[0] + out.size(), p, opts);
+    if (r.ec != std::errc()) {
+        out.resize(used + maxFormattedSize(p, opts));
+        r = formatPolinom(&out[used], &out[0] + out.size(), p, opts);
+    }
+    out.resize(static_cast<size_t>(r.ptr - out.data()));
+}
+
+inline std::string formatPolinom(const Polinom& p, FormatOptions opts = FormatOptions()) {
+    std::string out;
+    appendPolinom(out, p, opts);
+    return out;
+}
+
+// Accumulates many polynomials in one buffer so that a whole table reaches the
+// stream with a single write.
+class PolinomFormatter {
+private:
+    std::string buffer;
+    FormatOptions options;
+
+public:
+    explicit PolinomFormatter(FormatOptions opts = FormatOptions()) : options(opts) {}
+
+    PolinomFormatter& append(const Polinom& p) {
+        appendPolinom(buffer, p, options);
+        buffer.push_back('\n');
+        return *this;
+    }
+
+    PolinomFormatter& append(std::string_view name, const Polinom& p) {
+        buffer.append(name.data(), name.size());
+        buffer.append(" = ");
+        return append(p);
+    }
+
+    // Any range of (name, Polinom) pairs, e.g. std::map<std::string, Polinom>.
+    template<typename Table>
+    PolinomFormatter& appendTable(const Table& table) {
+        for (const auto& entry : table)
+            append(entry.first, entry.second);
+        return *this;
+    }
+
+    void reserve(size_t bytes) { buffer.reserve(bytes); }
+    size_t size() const { return buffer.size(); }
+    const std::string& str() const { return buffer; }
+    void clear() { buffer.clear(); }
+
+    void flush(std::ostream& os) {
+        os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#include "polinom.h"
+
+// Deduplicates polynomials by content. intern() returns a copy of the
+// canonical instance, so identical spilled polynomials end up sharing one
+// term block instead of holding separate copies. Polynomials short enough
+// to be stored inline have nothing to share and are only canonicalised.
+// Thread-safe.
+class PolinomInterner {
+private:
+    mutable std::mutex lock;
+    std::unordered_multimap<size_t, Polinom> canonical;
+
+public:
+    Polinom intern(const Polinom& p) {
+        size_t h = p.hash();
+        std::lock_guard<std::mutex> guard(lock);
+        auto range = canonical.equal_range(h);
+        for (auto it = range.first; it != range.second; ++it)
+            if (it->second.identical(p))
+                return it->second;
+        return canonical.emplace(h, p)->second;
+    }
+
+    bool contains(const Polinom& p) const {
+        size_t h = p.hash();
+        std::lock_guard<std::mutex> guard(lock);
+        auto range = canonical.equal_range(h);
+        for (auto it = range.first; it != range.second; ++it)
+            if (it->second.identical(p))
+                return true;
+        return false;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> guard(lock);
+        return canonical.size();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> guard(lock);
+        canonical.clear();
+    }
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+#include "polinom.h"
+
+// Kronecker substitution: x^i y^j z^k maps to t^((i * by + j) * bz + k).
+// As long as no power of the product reaches its variable's base, the map
+// respects multiplication, so a multivariate product becomes one univariate
+// convolution. The packed degree Polinom stores is this map with every base
+// 10, which is why the kernels in polinom.h can add degrees directly;
+// forProduct() picks the smallest bases for one product instead, which
+// shortens the univariate operands when the powers are low.
+struct KroneckerLayout {
+    int base[3] = { 10, 10, 10 };
+
+    static KroneckerLayout forProduct(const Polinom& a, const Polinom& b) {
+        int pa[3] = { 0, 0, 0 }, pb[3] = { 0, 0, 0 };
+        for (const Monom& m : a.getMonoms()) {
+            pa[0] = std::max(pa[0], m.degree / 100);
+            pa[1] = std::max(pa[1], m.degree / 10 % 10);
+            pa[2] = std::max(pa[2], m.degree % 10);
+        }
+        for (const Monom& m : b.getMonoms()) {
+            pb[0] = std::max(pb[0], m.degree / 100);
+            pb[1] = std::max(pb[1], m.degree / 10 % 10);
+            pb[2] = std::max(pb[2], m.degree % 10);
+        }
+        if (pa[0] + pb[0] > 9 || pa[1] + pb[1] > 9 || pa[2] + pb[2] > 9)
+            throw std::runtime_error("Multiplication error: Degree overflow in monom multiplication");
+        KroneckerLayout layout;
+        for (int v = 0; v < 3; ++v)
+            layout.base[v] = pa[v] + pb[v] + 1;
+        return layout;
+    }
+
+    size_t pack(int degree) const {
+        return (static_cast<size_t>(degree / 100) * base[1] + degree / 10 % 10) * base[2] + degree % 10;
+    }
+
+    int unpack(size_t packed) const {
+        int z = static_cast<int>(packed % base[2]);
+        packed /= base[2];
+        int y = static_cast<int>(packed % base[1]);
+        int x = static_cast<int>(packed / base[1]);
+        return x * 100 + y * 10 + z;
+    }
+
+    // Coefficients of p as a dense univariate polynomial, lowest packed
+    // power first, starting at the packed degree of p's last term.
+    std::vector<double> toDense(const Polinom& p) const {
+        const auto& monoms = p.getMonoms();
+        size_t lo = pack(monoms.back().degree);
+        std::vector<double> dense(pack(monoms.front().degree) - lo + 1, 0.0);
+        for (const Monom& m : monoms)
+            dense[pack(m.degree) - lo] = m.coeff;
+        return dense;
+    }
+
+    // Inverse of toDense for a product whose lowest packed power is `lo`.
+    // Packing preserves the monom order, so the terms come out sorted.
+    // Coefficients no larger than `cut` are treated as zero.
+    Polinom fromDense(const std::vector<double>& dense, size_t lo,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+        double cut = CoeffTraits<double>::kEpsilon) const {
+        std::vector<Monom> monoms;
+        for (size_t i = dense.size(); i-- > 0;)
+            if (std::fabs(dense[i]) > cut)
+                monoms.emplace_back(unpack(lo + i), dense[i]);
+        return Polinom(monoms, resource);
+    }
+};
+
+// Below this many coefficients in the shorter operand, schoolbook beats
+// another level of recursion (BM_Karatsuba).
+constexpr size_t kKaratsubaCutoff = 32;
+
+// out[0, n + m - 1) += a[0, n) * b[0, m).
+inline void schoolbookMultiply(const double* a, size_t n, const double* b, size_t m, double* out) {
+    for (size_t i = 0; i < n; ++i) {
+        double c = a[i];
+        if (c == 0.0)
+            continue;
+        double* row = out + i;
+        for (size_t j = 0; j < m; ++j)
+            row[j] += c * b[j];
+    }
+}
+
+namespace detail {
+
+// Scratch doubles karatsubaStep needs for an n x n product: its own 4 * high
+// plus its children's.
+inline size_t karatsubaScratch(size_t n) {
+    size_t total = 0;
+    while (n >= kKaratsubaCutoff) {
+        size_t high = n - n / 2;
+        total += 4 * high;
+        n = high;
+    }
+    return total;
+}
+
+// out[0, 2n - 1) = a[0, n) * b[0, n); `out` must be zeroed on entry, since
+// the middle term is corrected by subtracting what the outer two left there.
+// a = a0 + t^h a1, b = b0 + t^h b1:
+// ab = a0 b0 + t^h ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) + t^2h a1 b1.
+// The three sub-products go straight into out; only the middle one, which
+// overlaps both others, needs a buffer.
+inline void karatsubaStep(const double* a, const double* b, size_t n, double* out, double* scratch) {
+    if (n < kKaratsubaCutoff) {
+        schoolbookMultiply(a, n, b, n, out);
+        return;
+    }
+    size_t h = n / 2, high = n - h;
+    double* sa = scratch;
+    double* sb = sa + high;
+    double* mid = sb + high;  // 2 * high - 1 entries
+    double* rest = mid + 2 * high;
+    for (size_t i = 0; i < high; ++i) {
+        sa[i] = a[h + i] + (i < h ? a[i] : 0.0);
+        sb[i] = b[h + i] + (i < h ? b[i] : 0.0);
+    }
+    for (size_t i = 0; i + 1 < 2 * high; ++i)
+        mid[i] = 0.0;
+    karatsubaStep(sa, sb, high, mid, rest);
+
+    // low = a0 b0 into out[0, 2h - 1), top = a1 b1 into out[2h, 2n - 1);
+    // these ranges do not overlap. mid -= low + top, then out[h..] += mid.
+    karatsubaStep(a, b, h, out, rest);
+    karatsubaStep(a + h, b + h, high, out + 2 * h, rest);
+    for (size_t i = 0; i + 1 < 2 * h; ++i)
+        mid[i] -= out[i];
+    for (size_t i = 0; i + 1 < 2 * high; ++i)
+        mid[i] -= out[2 * h + i];
+    for (size_t i = 0; i + 1 < 2 * high; ++i)
+        out[h + i] += mid[i];
+}
+
+}
+
+// out[0, n + m - 1) = a[0, n) * b[0, m) in O(n^1.58) multiplications for
+// balanced operands; `out` must be zeroed by the caller. Unbalanced
+// operands are cut into blocks as long as the shorter one.
+inline void karatsubaMultiply(const double* a, size_t n, const double* b, size_t m, double* out) {
+    if (n < m) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    if (m == 0)
+        return;
+    if (m < kKaratsubaCutoff) {
+        schoolbookMultiply(a, n, b, m, out);
+        return;
+    }
+    std::vector<double> scratch(detail::karatsubaScratch(m) + 3 * m);
+    if (n == m) {
+        detail::karatsubaStep(a, b, m, out, scratch.data());
+        return;
+    }
+    double* padded = scratch.data() + detail::karatsubaScratch(m);
+    double* product = padded + m;
+    for (size_t start = 0; start < n; start += m) {
+        size_t len = std::min(m, n - start);
+        const double* block = a + start;
+        if (len < m) {
+            std::fill(std::copy(block, block + len, padded), padded + m, 0.0);
+            block = padded;
+        }
+        std::fill(product, product + 2 * m - 1, 0.0);
+        detail::karatsubaStep(block, b, m, product, scratch.data());
+        for (size_t i = 0; i < len + m - 1; ++i)
+            out[start + i] += product[i];
+    }
+}
+
+namespace detail {
+
+inline double maxAbs(const std::vector<double>& v) {
+    double m = 0.0;
+    for (double c : v)
+        m = std::max(m, std::fabs(c));
+    return m;
+}
+
+}
+
+// a * b by Kronecker substitution and Karatsuba. The subtractions in
+// Karatsuba leave rounding noise at powers whose true coefficient is zero,
+// and it scales with the operands: each output sums at most len = min(n, m)
+// products of size up to max|a| max|b|. Anything under
+// eps * max|a| * max|b| * len is dropped as noise; on random operands the
+// noise measures under 1/20 of that.
+inline Polinom multiplyKronecker(const Polinom& a, const Polinom& b,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+    if (a.empty() || b.empty())
+        return Polinom(resource);
+    KroneckerLayout layout = KroneckerLayout::forProduct(a, b);
+    std::vector<double> da = layout.toDense(a), db = layout.toDense(b);
+    std::vector<double> product(da.size() + db.size() - 1, 0.0);
+    karatsubaMultiply(da.data(), da.size(), db.data(), db.size(), product.data());
+    double noise = std::numeric_limits<double>::epsilon() * detail::maxAbs(da) * detail::maxAbs(db)
+        * static_cast<double>(std::min(da.size(), db.size()));
+    return layout.fromDense(product, layout.pack(a.getMonoms().back().degree) + layout.pack(b.getMonoms().back().degree),
+        resource, std::max(noise, CoeffTraits<double>::kEpsilon));
+}
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+// Opt-in operation counters and latency histograms. Build with
+// POLINOM_METRICS=1 (CMake option POLINOM_METRICS) to compile the
+// instrumentation in; otherwise every POLINOM_METRIC_* macro expands to
+// nothing and the instrumented code is identical to an uninstrumented
+// build. The classes below are always available, so exporting code
+// compiles either way and simply reports zeros when metrics are off.
+//
+// Like POLINOM_INLINE_TERMS, every translation unit of a program must be
+// built with the same setting.
+#ifndef POLINOM_METRICS
+#define POLINOM_METRICS 0
+#endif
+
+namespace metrics {
+
+enum class Counter : unsigned {
+    MonomsProcessed,      // input terms of parse, add, subtract, scale; term pairs of multiply
+    TermAllocations,      // heap blocks taken by spilled term lists
+    TermBytesAllocated,
+    PoolChunks,           // chunks NodePool took from its upstream resource
+    Merges,               // add and subtract calls
+    StoreLookups,
+    StoreHits,
+    StoreMisses,
+    StoreInserts,
+    StoreErases,
+    Count
+};
+
+enum class Op : unsigned {
+    Parse,
+    Add,
+    Subtract,
+    Multiply,
+    Scale,
+    Evaluate,
+    StoreLookup,
+    StoreWrite,
+    Count
+};
+
+inline const char* name(Counter c) {
+    static const char* const names[] = { "monoms_processed", "term_allocations", "term_bytes_allocated",
+        "pool_chunks", "merges", "store_lookups", "store_hits", "store_misses", "store_inserts", "store_erases" };
+    return names[static_cast<unsigned>(c)];
+}
+
+inline const char* name(Op op) {
+    static const char* const names[] = { "parse", "add", "subtract", "multiply", "scale", "evaluate",
+        "store_lookup", "store_write" };
+    return names[static_cast<unsigned>(op)];
+}
+
+inline int highestBit(uint64_t v) {
+    int bit = 0;
+    for (int step = 32; step > 0; step >>= 1) {
+        if (v >> step) {
+            v >>= step;
+            bit += step;
+        }
+    }
+    return bit;
+}
+
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+    double mean = 0.0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+};
+
+// Log-linear histogram in the style of HdrHistogram: values below 16 get a
+// bucket each, and every power of two above that is split into 16 equal
+// buckets, so a reported percentile is within 1/16 (6.25%) of the true
+// value across the whole uint64_t range. Recording is a few relaxed
+// atomic adds and is safe from any thread.
+class Histogram {
+public:
+    static constexpr int kSubBits = 4;
+    static constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBits;
+    static constexpr size_t kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+    static size_t bucketOf(uint64_t v) {
+        if (v < kSubBuckets)
+            return static_cast<size_t>(v);
+        int shift = highestBit(v) - kSubBits;
+        return static_cast<size_t>((shift + 1) * kSubBuckets + ((v >> shift) & (kSubBuckets - 1)));
+    }
+
+    // Smallest and largest value that land in `bucket`.
+    static uint64_t lowerBound(size_t bucket) {
+        size_t group = bucket / kSubBuckets;
+        uint64_t sub = bucket % kSubBuckets;
+        return group == 0 ? sub : (kSubBuckets + sub) << (group - 1);
+    }
+
+    static uint64_t upperBound(size_t bucket) {
+        size_t group = bucket / kSubBuckets;
+        return group <= 1 ? lowerBound(bucket) : lowerBound(bucket) + ((uint64_t(1) << (group - 1)) - 1);
+    }
+
+    void record(uint64_t v) {
+        counts[bucketOf(v)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(v, std::memory_order_relaxed);
+        uint64_t seen = minimum.load(std::memory_order_relaxed);
+        while (v < seen && !minimum.compare_exchange_weak(seen, v, std::memory_order_relaxed)) {}
+        seen = maximum.load(std::memory_order_relaxed);
+        while (v > seen && !maximum.compare_exchange_weak(seen, v, std::memory_order_relaxed)) {}
+    }
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the q-quantile, clamped to the
+    // recorded range. q in [0, 1].
+    uint64_t percentile(double q) const {
+        uint64_t n = count();
+        if (n == 0)
+            return 0;
+        uint64_t rank = static_cast<uint64_t>(q * n + 0.5);
+        rank = rank < 1 ? 1 : rank > n ? n : rank;
+        uint64_t seen = 0;
+        for (size_t b = 0; b < kBuckets; ++b) {
+            seen += counts[b].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                uint64_t value = upperBound(b);
+                uint64_t lo = minimum.load(std::memory_order_relaxed), hi = maximum.load(std::memory_order_relaxed);
+                return value < lo ? lo : value > hi ? hi : value;
+            }
+        }
+        return maximum.load(std::memory_order_relaxed);
+    }
+
+    HistogramSnapshot snapshot() const {
+        HistogramSnapshot s;
+        s.count = count();
+        if (s.count == 0)
+            return s;
+        s.min = minimum.load(std::memory_order_relaxed);
+        s.max = maximum.load(std::memory_order_relaxed);
+        s.mean = static_cast<double>(sum.load(std::memory_order_relaxed)) / s.count;
+        s.p50 = percentile(0.5);
+        s.p90 = percentile(0.9);
+        s.p99 = percentile(0.99);
+        s.p999 = percentile(0.999);
+        return s;
+    }
+
+    void reset() {
+        for (auto& c : counts)
+            c.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        minimum.store(UINT64_MAX, std::memory_order_relaxed);
+        maximum.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> counts[kBuckets] = {};
+    std::atomic<uint64_t> total{ 0 };
+    std::atomic<uint64_t> sum{ 0 };
+    std::atomic<uint64_t> minimum{ UINT64_MAX };
+    std::atomic<uint64_t> maximum{ 0 };
+};
+
+// Multiply calls are bucketed by term pairs: bucket b counts calls with
+// 2^b <= pairs < 2^(b+1) (bucket 0 also takes pairs == 0).
+constexpr size_t kMultiplyBuckets = 20;
+
+struct Snapshot {
+    std::array<uint64_t, static_cast<size_t>(Counter::Count)> counters{};
+    std::array<uint64_t, kMultiplyBuckets> multiplyByPairs{};
+    std::array<HistogramSnapshot, static_cast<size_t>(Op::Count)> latency{};
+
+    uint64_t operator[](Counter c) const { return counters[static_cast<size_t>(c)]; }
+    const HistogramSnapshot& operator[](Op op) const { return latency[static_cast<size_t>(op)]; }
+
+    std::string toText() const {
+        std::ostringstream out;
+        for (size_t c = 0; c < counters.size(); ++c)
+            out << name(static_cast<Counter>(c)) << ' ' << counters[c] << '\n';
+        for (size_t b = 0; b < kMultiplyBuckets; ++b)
+            if (multiplyByPairs[b])
+                out << "multiply_calls pairs>=" << (uint64_t(1) << b) << ' ' << multiplyByPairs[b] << '\n';
+        out << std::fixed << std::setprecision(1);
+        for (size_t op = 0; op < latency.size(); ++op) {
+            const HistogramSnapshot& h = latency[op];
+            if (!h.count)
+                continue;
+            out << "latency_ns " << name(static_cast<Op>(op)) << " count=" << h.count << " min=" << h.min
+                << " mean=" << h.mean << " p50=" << h.p50 << " p90=" << h.p90 << " p99=" << h.p99
+                << " p999=" << h.p999 << " max=" << h.max << '\n';
+        }
+        return out.str();
+    }
+
+    std::string toJson() const {
+        std::ostringstream out;
+        out << "{\n  \"enabled\": " << (POLINOM_METRICS ? "true" : "false") << ",\n  \"counters\": {";
+        for (size_t c = 0; c < counters.size(); ++c)
+            out << (c ? "," : "") << "\n    \"" << name(static_cast<Counter>(c)) << "\": " << counters[c];
+        out << "\n  },\n  \"multiply_calls_by_pairs\": [";
+        bool first = true;
+        for (size_t b = 0; b < kMultiplyBuckets; ++b) {
+            if (!multiplyByPairs[b])
+                continue;
+            out << (first ? "" : ",") << "\n    { \"min_pairs\": " << (b ? uint64_t(1) << b : 0)
+                << ", \"calls\": " << multiplyByPairs[b] << " }";
+            first = false;
+        }
+        out << "\n  ],\n  \"latency_ns\": {";
+        first = true;
+        for (size_t op = 0; op < latency.size(); ++op) {
+            const HistogramSnapshot& h = latency[op];
+            if (!h.count)
+                continue;
+            out << (first ? "" : ",") << "\n    \"" << name(static_cast<Op>(op)) << "\": { \"count\": " << h.count
+                << ", \"min\": " << h.min << ", \"mean\": " << h.mean << ", \"p50\": " << h.p50
+                << ", \"p90\": " << h.p90 << ", \"p99\": " << h.p99 << ", \"p999\": " << h.p999
+                << ", \"max\": " << h.max << " }";
+            first = false;
+        }
+        out << "\n  }\n}\n";
+        return out.str();
+    }
+};
+
+class Registry {
+public:
+    void add(Counter c, uint64_t n) {
+        counters[static_cast<size_t>(c)].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void recordMultiply(uint64_t pairs) {
+        size_t bucket = pairs < 2 ? 0 : static_cast<size_t>(highestBit(pairs));
+        multiplyByPairs[bucket < kMultiplyBuckets ? bucket : kMultiplyBuckets - 1].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void record(Op op, uint64_t nanos) { histograms[static_cast<size_t>(op)].record(nanos); }
+
+    Snapshot snapshot() const {
+        Snapshot s;
+        for (size_t c = 0; c < s.counters.size(); ++c)
+            s.counters[c] = counters[c].value.load(std::memory_order_relaxed);
+        for (size_t b = 0; b < kMultiplyBuckets; ++b)
+            s.multiplyByPairs[b] = multiplyByPairs[b].load(std::memory_order_relaxed);
+        for (size_t op = 0; op < s.latency.size(); ++op)
+            s.latency[op] = histograms[op].snapshot();
+        return s;
+    }
+
+    void reset() {
+        for (auto& c : counters)
+            c.value.store(0, std::memory_order_relaxed);
+        for (auto& b : multiplyByPairs)
+            b.store(0, std::memory_order_relaxed);
+        for (auto& h : histograms)
+            h.reset();
+    }
+
+private:
+    // Counters on their own cache lines, so threads bumping different
+    // counters do not contend.
+    struct alignas(64) PaddedCounter {
+        std::atomic<uint64_t> value{ 0 };
+    };
+
+    PaddedCounter counters[static_cast<size_t>(Counter::Count)];
+    std::atomic<uint64_t> multiplyByPairs[kMultiplyBuckets] = {};
+    Histogram histograms[static_cast<size_t>(Op::Count)];
+};
+
+inline Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+inline Snapshot snapshot() { return registry().snapshot(); }
+inline void reset() { registry().reset(); }
+
+// Records the lifetime of the object as one latency sample of `op`.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Op timed) : op(timed), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        registry().record(op, static_cast<uint64_t>(nanos.count()));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Op op;
+    std::chrono::steady_clock::time_point start;
+};
+
+}
+
+#define POLINOM_METRIC_CONCAT_INNER(a, b) a##b
+#define POLINOM_METRIC_CONCAT(a, b) POLINOM_METRIC_CONCAT_INNER(a, b)
+
+#if POLINOM_METRICS
+#define POLINOM_METRIC_ADD(counter, n) ::metrics::registry().add(::metrics::Counter::counter, static_cast<uint64_t>(n))
+#define POLINOM_METRIC_MULTIPLY(pairs) ::metrics::registry().recordMultiply(static_cast<uint64_t>(pairs))
+#define POLINOM_METRIC_TIME(op) ::metrics::ScopedTimer POLINOM_METRIC_CONCAT(polinomMetricTimer_, __LINE__)(::metrics::Op::op)
+#else
+#define POLINOM_METRIC_ADD(counter, n) ((void)0)
+#define POLINOM_METRIC_MULTIPLY(pairs) ((void)0)
+#define POLINOM_METRIC_TIME(op) ((void)0)
+#endif
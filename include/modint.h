@@ -0,0 +1,243 @@
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include "coefficient.h"
+
+#if defined(__SIZEOF_INT128__)
+#define POLINOM_HAS_INT128 1
+#else
+#define POLINOM_HAS_INT128 0
+#endif
+
+namespace detail {
+
+// 64 x 64 -> 128-bit product; returns the low word and stores the high one.
+inline uint64_t mulWide(uint64_t a, uint64_t b, uint64_t& high) {
+#if POLINOM_HAS_INT128
+    unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+    high = static_cast<uint64_t>(p >> 64);
+    return static_cast<uint64_t>(p);
+#else
+    uint64_t aLo = a & 0xffffffffu, aHi = a >> 32, bLo = b & 0xffffffffu, bHi = b >> 32;
+    uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+    uint64_t mid = (ll >> 32) + (lh & 0xffffffffu) + (hl & 0xffffffffu);
+    high = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return (mid << 32) | (ll & 0xffffffffu);
+#endif
+}
+
+}
+
+// Integers modulo an odd Mod < 2^63, stored in Montgomery form
+// a * 2^64 mod Mod. A product then costs two wide multiplications and no
+// division: REDC divides by 2^64 instead of by Mod. Division needs Mod to
+// be prime.
+//
+// Coefficients print as the representative in (-Mod/2, Mod/2], so small
+// negative integers read back the way they were written.
+template <uint64_t Mod>
+class ModInt {
+    static_assert(Mod % 2 == 1 && Mod > 1 && Mod < (uint64_t(1) << 63), "ModInt needs an odd modulus below 2^63");
+
+public:
+    static constexpr uint64_t modulus = Mod;
+
+    ModInt() = default;
+    ModInt(int64_t v) {
+        uint64_t r = uint64_t(v) % Mod;
+        if (v < 0) {
+            r = (uint64_t(-(v + 1)) + 1) % Mod;  // |v|, even for INT64_MIN
+            r = r ? Mod - r : 0;
+        }
+        uint64_t high;
+        uint64_t low = detail::mulWide(r, kR2, high);
+        value = redc(low, high);
+    }
+
+    // (high * 2^64 + low) / 2^64 mod Mod as Montgomery form, for high < Mod;
+    // i.e. the ModInt whose Montgomery form times 2^64 is that value.
+    static ModInt fromWide(uint64_t low, uint64_t high) {
+        ModInt m;
+        m.value = redc(low, high);
+        return m;
+    }
+
+    uint64_t get() const { return redc(value, 0); }
+    int64_t signedValue() const {
+        uint64_t v = get();
+        return v > Mod / 2 ? -static_cast<int64_t>(Mod - v) : static_cast<int64_t>(v);
+    }
+    uint64_t montgomery() const { return value; }
+    bool isNegative() const { return signedValue() < 0; }
+    uint64_t hash() const { return value; }
+
+    ModInt& operator+=(ModInt o) {
+        value += o.value;
+        if (value >= Mod)
+            value -= Mod;
+        return *this;
+    }
+    ModInt& operator-=(ModInt o) {
+        value = value >= o.value ? value - o.value : value + (Mod - o.value);
+        return *this;
+    }
+    ModInt& operator*=(ModInt o) {
+        uint64_t high;
+        uint64_t low = detail::mulWide(value, o.value, high);
+        value = redc(low, high);
+        return *this;
+    }
+    ModInt& operator/=(ModInt o) { return *this *= o.inverse(); }
+
+    friend ModInt operator+(ModInt a, ModInt b) { return a += b; }
+    friend ModInt operator-(ModInt a, ModInt b) { return a -= b; }
+    friend ModInt operator*(ModInt a, ModInt b) { return a *= b; }
+    friend ModInt operator/(ModInt a, ModInt b) { return a /= b; }
+    ModInt operator-() const { return ModInt() -= *this; }
+
+    bool operator==(ModInt o) const { return value == o.value; }
+    bool operator!=(ModInt o) const { return value != o.value; }
+
+    ModInt pow(uint64_t e) const {
+        ModInt result(1), base = *this;
+        for (; e; e >>= 1, base *= base)
+            if (e & 1)
+                result *= base;
+        return result;
+    }
+
+    // Fermat inverse; Mod must be prime.
+    ModInt inverse() const {
+        if (value == 0)
+            throw std::domain_error("ModInt: inverse of zero");
+        return pow(Mod - 2);
+    }
+
+    // Decimal digits at text[pos], reduced mod Mod as they are read.
+    static ModInt parse(const std::string& text, size_t pos, size_t& end) {
+        if (pos >= text.size() || !std::isdigit(static_cast<unsigned char>(text[pos])))
+            throw std::invalid_argument("ModInt: expected digits");
+        ModInt result, ten(10);
+        for (; pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])); ++pos)
+            result = result * ten + ModInt(text[pos] - '0');
+        end = pos;
+        return result;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, ModInt m) { return os << m.signedValue(); }
+
+private:
+    // -Mod^-1 mod 2^64 by Newton's iteration; each step doubles the
+    // correct low bits, starting from the 3 that Mod itself gets right.
+    static constexpr uint64_t negInverse() {
+        uint64_t inv = Mod;
+        for (int i = 0; i < 5; ++i)
+            inv *= 2 - Mod * inv;
+        return 0 - inv;
+    }
+
+    // 2^128 mod Mod, which converts into Montgomery form.
+    static constexpr uint64_t r2() {
+        uint64_t x = 1;
+        for (int i = 0; i < 128; ++i) {
+            x <<= 1;
+            if (x >= Mod)
+                x -= Mod;
+        }
+        return x;
+    }
+
+    static constexpr uint64_t kNegInverse = negInverse();
+    static constexpr uint64_t kR2 = r2();
+
+    // Montgomery reduction of high * 2^64 + low, high < Mod: adding m * Mod
+    // clears the low word, so the high word is the quotient by 2^64.
+    static uint64_t redc(uint64_t low, uint64_t high) {
+        uint64_t m = low * kNegInverse, mHigh;
+        detail::mulWide(m, Mod, mHigh);
+        uint64_t t = high + mHigh + (low != 0);
+        return t >= Mod ? t - Mod : t;
+    }
+
+    uint64_t value = 0;
+};
+
+// 2^61 - 1, a Mersenne prime: the default ring for exact integer workloads
+// whose coefficients stay far below it.
+using ModInt61 = ModInt<(uint64_t(1) << 61) - 1>;
+
+// Sum of products of Montgomery residues, kept in 128 bits and reduced
+// once when read instead of once per product. Each product is below
+// Mod * 2^64, and subtracting Mod * 2^64 whenever the high word reaches Mod
+// keeps the sum below it without changing its residue.
+template <uint64_t Mod>
+class ModAccumulator {
+public:
+    void add(ModInt<Mod> a, ModInt<Mod> b) {
+#if POLINOM_HAS_INT128
+        sum += static_cast<unsigned __int128>(a.montgomery()) * b.montgomery();
+        if (static_cast<uint64_t>(sum >> 64) >= Mod)
+            sum -= static_cast<unsigned __int128>(Mod) << 64;
+#else
+        uint64_t high;
+        uint64_t low = detail::mulWide(a.montgomery(), b.montgomery(), high);
+        addWide(low, high);
+#endif
+    }
+
+    void merge(const ModAccumulator& other) {
+#if POLINOM_HAS_INT128
+        sum += other.sum;
+        if (static_cast<uint64_t>(sum >> 64) >= Mod)
+            sum -= static_cast<unsigned __int128>(Mod) << 64;
+#else
+        addWide(other.low, other.high);
+#endif
+    }
+
+    ModInt<Mod> reduce() const {
+#if POLINOM_HAS_INT128
+        return ModInt<Mod>::fromWide(static_cast<uint64_t>(sum), static_cast<uint64_t>(sum >> 64));
+#else
+        return ModInt<Mod>::fromWide(low, high);
+#endif
+    }
+
+    // No default member initializers: value-initialization zeroes the
+    // accumulator and a kernel's stack array of them stays trivial.
+private:
+#if POLINOM_HAS_INT128
+    unsigned __int128 sum;
+#else
+    void addWide(uint64_t l, uint64_t h) {
+        low += l;
+        high += h + (low < l);
+        if (high >= Mod)
+            high -= Mod;
+    }
+
+    uint64_t low;
+    uint64_t high;
+#endif
+};
+
+template <uint64_t Mod>
+struct CoeffTraits<ModInt<Mod>> {
+    using C = ModInt<Mod>;
+    using Accumulator = ModAccumulator<Mod>;
+
+    static bool isZero(C c) { return c == C(); }
+    static bool equal(C a, C b) { return a == b; }
+    static bool isNegative(C c) { return c.isNegative(); }
+    static C parse(const std::string& text, size_t pos, size_t& end) { return C::parse(text, pos, end); }
+    static void write(std::ostream& os, C c) { os << c; }
+    static uint64_t hash(C c) { return c.hash(); }
+
+    static void multiplyAdd(Accumulator& acc, C a, C b) { acc.add(a, b); }
+    static void merge(Accumulator& into, const Accumulator& from) { into.merge(from); }
+    static C reduce(const Accumulator& acc) { return acc.reduce(); }
+};
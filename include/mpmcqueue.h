@@ -0,0 +1,368 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#ifndef POLINOM_CACHE_LINE
+#define POLINOM_CACHE_LINE 64
+#endif
+
+// Bounded multi-producer multi-consumer ring queue (Dmitry Vyukov's design).
+// Every cell carries a sequence number: a cell at position pos is free for
+// the producer of pos when seq == pos and holds that producer's item when
+// seq == pos + 1. Producers and consumers claim positions with a CAS on
+// their own counter and never touch the other side's counter, and the two
+// counters live on separate cache lines.
+//
+// Batch operations claim a run of consecutive cells with one CAS. They may
+// transfer fewer items than asked for and return how many they moved.
+//
+// If constructing an item throws, its cell is still published, marked
+// empty, so consumers skip it instead of waiting on it forever; the
+// exception then propagates to the producer. Types whose copy and move
+// constructors cannot throw carry no mark: an emplace from other arguments
+// builds the item before claiming a cell, and then moves it in.
+//
+// Queue<T> in tlist.h remains the single-threaded queue.
+namespace detail {
+
+// Whether a published cell holds an item; an empty base when it always does.
+template<bool Marked>
+struct CellMark {
+    bool full;
+    void setFull(bool f) { full = f; }
+    bool isFull() const { return full; }
+};
+
+template<>
+struct CellMark<false> {
+    void setFull(bool) {}
+    bool isFull() const { return true; }
+};
+
+}
+
+template<typename T>
+class MPMCQueue {
+private:
+    static constexpr bool kMarksEmpty =
+        !(std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_move_constructible_v<T>);
+
+    struct Cell : detail::CellMark<kMarksEmpty> {
+        std::atomic<size_t> seq;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* item() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    alignas(POLINOM_CACHE_LINE) Cell* cells;
+    size_t mask;
+    alignas(POLINOM_CACHE_LINE) std::atomic<size_t> enqueuePos{ 0 };
+    alignas(POLINOM_CACHE_LINE) std::atomic<size_t> dequeuePos{ 0 };
+
+    // Claims up to `wanted` cells starting at the current position of
+    // `counter`. A cell is ready when its seq equals pos + `offset` (0 for
+    // producers, 1 for consumers). Returns the first position and count.
+    std::pair<size_t, size_t> claim(std::atomic<size_t>& counter, size_t offset, size_t wanted) {
+        size_t pos = counter.load(std::memory_order_relaxed);
+        for (;;) {
+            size_t ready = 0;
+            while (ready < wanted) {
+                Cell& cell = cells[(pos + ready) & mask];
+                size_t seq = cell.seq.load(std::memory_order_acquire);
+                if (seq != pos + ready + offset)
+                    break;
+                ++ready;
+            }
+            if (ready == 0) {
+                Cell& cell = cells[pos & mask];
+                intptr_t diff = static_cast<intptr_t>(cell.seq.load(std::memory_order_acquire))
+                    - static_cast<intptr_t>(pos + offset);
+                if (diff < 0)
+                    return { pos, 0 };   // full for producers, empty for consumers
+                pos = counter.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (counter.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed))
+                return { pos, ready };
+        }
+    }
+
+    template<typename... Args>
+    void publish(size_t pos, Args&&... args) {
+        Cell& cell = cells[pos & mask];
+        if constexpr (kMarksEmpty) {
+            try {
+                new (cell.storage) T(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                publishEmpty(pos);
+                throw;
+            }
+        }
+        else {
+            static_assert(std::is_nothrow_constructible_v<T, Args&&...>, "unmarked cells need nothrow construction");
+            new (cell.storage) T(std::forward<Args>(args)...);
+        }
+        cell.setFull(true);
+        cell.seq.store(pos + 1, std::memory_order_release);
+    }
+
+    void publishEmpty(size_t pos) {
+        static_assert(kMarksEmpty, "only marked cells can be published empty");
+        Cell& cell = cells[pos & mask];
+        cell.setFull(false);
+        cell.seq.store(pos + 1, std::memory_order_release);
+    }
+
+    // Frees the claimed cell at `pos`, moving its item to *out++ if it has
+    // one. Returns whether it did.
+    template<typename OutIt>
+    bool release(size_t pos, OutIt& out) {
+        Cell& cell = cells[pos & mask];
+        bool full = cell.isFull();
+        if (full) {
+            *out++ = std::move(*cell.item());
+            cell.item()->~T();
+        }
+        cell.seq.store(pos + mask + 1, std::memory_order_release);
+        return full;
+    }
+
+public:
+    explicit MPMCQueue(size_t capacity) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+            throw std::invalid_argument("MPMCQueue capacity must be a power of two >= 2");
+        mask = capacity - 1;
+        cells = static_cast<Cell*>(::operator new(sizeof(Cell) * capacity, std::align_val_t(alignof(Cell))));
+        for (size_t i = 0; i < capacity; ++i)
+            new (&cells[i].seq) std::atomic<size_t>(i);
+    }
+
+    ~MPMCQueue() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            size_t tail = enqueuePos.load();
+            for (size_t pos = dequeuePos.load(); pos != tail; ++pos)
+                if (cells[pos & mask].isFull())
+                    cells[pos & mask].item()->~T();
+        }
+        ::operator delete(cells, std::align_val_t(alignof(Cell)));
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    template<typename... Args>
+    bool tryEmplace(Args&&... args) {
+        if constexpr (!kMarksEmpty && !std::is_nothrow_constructible_v<T, Args&&...>) {
+            T value(std::forward<Args>(args)...);
+            return tryEmplace(std::move(value));
+        }
+        auto [pos, count] = claim(enqueuePos, 0, 1);
+        if (count == 0)
+            return false;
+        publish(pos, std::forward<Args>(args)...);
+        return true;
+    }
+
+    bool tryPush(const T& value) { return tryEmplace(value); }
+    bool tryPush(T&& value) { return tryEmplace(std::move(value)); }
+
+    bool tryPop(T& out) {
+        for (;;) {
+            auto [pos, count] = claim(dequeuePos, 1, 1);
+            if (count == 0)
+                return false;
+            T* target = &out;
+            if (release(pos, target))
+                return true;
+        }
+    }
+
+    // Moves items from [first, first + n) into the queue; returns how many.
+    template<typename It>
+    size_t tryPushBatch(It first, size_t n) {
+        if (n == 0)
+            return 0;
+        auto [pos, count] = claim(enqueuePos, 0, n);
+        if constexpr (kMarksEmpty) {
+            size_t i = 0;
+            try {
+                for (; i < count; ++i, ++first)
+                    publish(pos + i, std::move(*first));
+            }
+            catch (...) {
+                // publish() gave up cell i; the rest of the run must not stall.
+                for (++i; i < count; ++i)
+                    publishEmpty(pos + i);
+                throw;
+            }
+        }
+        else {
+            for (size_t i = 0; i < count; ++i, ++first)
+                publish(pos + i, std::move(*first));
+        }
+        return count;
+    }
+
+    // Writes up to `max` items to `out`; returns how many.
+    template<typename OutIt>
+    size_t tryPopBatch(OutIt out, size_t max) {
+        if (max == 0)
+            return 0;
+        size_t popped = 0;
+        while (popped == 0) {
+            auto [pos, count] = claim(dequeuePos, 1, max);
+            if (count == 0)
+                break;
+            for (size_t i = 0; i < count; ++i)
+                popped += release(pos + i, out);
+        }
+        return popped;
+    }
+
+    // Approximate while other threads are active.
+    size_t sizeApprox() const {
+        size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        size_t head = dequeuePos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+};
+
+// Blocking front end over MPMCQueue. Callers spin briefly on the lock-free
+// path and only then sleep, so the mutex is touched only when a side
+// actually has to wait. close() wakes every waiter: push then fails and
+// pop drains what is left before failing. Close only after the producers
+// are done; a push racing with close() may land after the last pop.
+template<typename T>
+class BlockingQueue {
+private:
+    MPMCQueue<T> queue;
+    std::atomic<bool> closed{ false };
+    alignas(POLINOM_CACHE_LINE) std::atomic<int> waitingPop{ 0 };
+    alignas(POLINOM_CACHE_LINE) std::atomic<int> waitingPush{ 0 };
+    std::mutex lock;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+
+    static constexpr int kSpins = 64;
+
+    void wake(std::atomic<int>& waiting, std::condition_variable& cv, size_t count) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) == 0)
+            return;
+        { std::lock_guard<std::mutex> guard(lock); }
+        if (count == 1)
+            cv.notify_one();
+        else
+            cv.notify_all();
+    }
+
+    // Retries `attempt` until it returns non-zero or `stop()` holds.
+    template<typename Attempt, typename Stop>
+    size_t retry(Attempt attempt, Stop stop, std::atomic<int>& waiting, std::condition_variable& cv) {
+        for (int i = 0; i < kSpins; ++i) {
+            if (size_t n = attempt())
+                return n;
+            if (stop())
+                return 0;
+            std::this_thread::yield();
+        }
+        waiting.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        size_t n = 0;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            cv.wait(guard, [&] { return (n = attempt()) != 0 || stop(); });
+        }
+        waiting.fetch_sub(1);
+        return n;
+    }
+
+public:
+    explicit BlockingQueue(size_t capacity) : queue(capacity) {}
+
+    size_t capacity() const { return queue.capacity(); }
+    size_t sizeApprox() const { return queue.sizeApprox(); }
+    bool isClosed() const { return closed.load(); }
+
+    // Returns false if the queue was closed.
+    bool push(T value) {
+        auto closedNow = [&] { return closed.load(); };
+        size_t n = retry([&] { return closedNow() ? size_t(0) : size_t(queue.tryPush(std::move(value))); },
+            closedNow, waitingPush, notFull);
+        if (n)
+            wake(waitingPop, notEmpty, 1);
+        return n != 0;
+    }
+
+    // Returns false once the queue is closed and drained.
+    bool pop(T& out) {
+        size_t n = retry([&] { return size_t(queue.tryPop(out)); },
+            [&] { return closed.load() && queue.sizeApprox() == 0; }, waitingPop, notEmpty);
+        if (n)
+            wake(waitingPush, notFull, 1);
+        return n != 0;
+    }
+
+    bool tryPush(T value) {
+        if (closed.load() || !queue.tryPush(std::move(value)))
+            return false;
+        wake(waitingPop, notEmpty, 1);
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        if (!queue.tryPop(out))
+            return false;
+        wake(waitingPush, notFull, 1);
+        return true;
+    }
+
+    // Pushes all n items, blocking as needed; returns how many were pushed
+    // before the queue was closed.
+    template<typename It>
+    size_t pushBatch(It first, size_t n) {
+        size_t done = 0;
+        auto closedNow = [&] { return closed.load(); };
+        while (done < n) {
+            size_t moved = retry([&] { return closedNow() ? size_t(0) : queue.tryPushBatch(first, n - done); },
+                closedNow, waitingPush, notFull);
+            if (moved == 0)
+                break;
+            std::advance(first, moved);
+            done += moved;
+            wake(waitingPop, notEmpty, moved);
+        }
+        return done;
+    }
+
+    // Blocks until at least one item is available, then takes up to `max`.
+    // Returns 0 once the queue is closed and drained.
+    template<typename OutIt>
+    size_t popBatch(OutIt out, size_t max) {
+        size_t n = retry([&] { return queue.tryPopBatch(out, max); },
+            [&] { return closed.load() && queue.sizeApprox() == 0; }, waitingPop, notEmpty);
+        if (n)
+            wake(waitingPush, notFull, n);
+        return n;
+    }
+
+    void close() {
+        closed.store(true);
+        std::lock_guard<std::mutex> guard(lock);
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+};
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#include "metrics.h"
+
+// Fixed-size block allocator for node-based containers. Blocks are carved
+// out of chunks obtained from a pmr upstream resource. Chunks start at
+// `firstChunkBlocks` blocks and double, up to kMaxChunkBlocks. Freed blocks
+// go on an intrusive free list and are reused before a chunk is touched.
+// release() hands every chunk back to the upstream at once, so a container
+// that destroys its nodes and then calls release() skips the per-node
+// deallocate.
+//
+// Not thread-safe; each container owns its pool.
+class NodePool {
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct Chunk {
+        Chunk* next;
+        size_t bytes;
+    };
+
+    static constexpr size_t kMaxChunkBlocks = 4096;
+
+    size_t blockSize;
+    size_t blockAlign;
+    size_t headerSize;
+    size_t firstChunkBlocks;
+    size_t nextChunkBlocks;
+    std::pmr::memory_resource* upstream;
+    Chunk* chunks = nullptr;
+    FreeBlock* freeList = nullptr;
+    char* bump = nullptr;
+    char* bumpEnd = nullptr;
+    size_t live = 0;
+    size_t chunkTotal = 0;
+
+    static size_t roundUp(size_t n, size_t align) {
+        return (n + align - 1) / align * align;
+    }
+
+    void addChunk() {
+        size_t bytes = headerSize + nextChunkBlocks * blockSize;
+        void* memory = upstream->allocate(bytes, std::max(alignof(Chunk), blockAlign));
+        Chunk* chunk = new (memory) Chunk{ chunks, bytes };
+        chunks = chunk;
+        ++chunkTotal;
+        POLINOM_METRIC_ADD(PoolChunks, 1);
+        bump = static_cast<char*>(memory) + headerSize;
+        bumpEnd = static_cast<char*>(memory) + bytes;
+        nextChunkBlocks = std::min(nextChunkBlocks * 2, kMaxChunkBlocks);
+    }
+
+public:
+    NodePool(size_t size, size_t align, size_t firstChunk = 16,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : blockAlign(std::max(align, alignof(FreeBlock))),
+          firstChunkBlocks(std::max<size_t>(1, firstChunk)),
+          nextChunkBlocks(std::max<size_t>(1, firstChunk)),
+          upstream(resource) {
+        blockSize = roundUp(std::max(size, sizeof(FreeBlock)), blockAlign);
+        headerSize = roundUp(sizeof(Chunk), blockAlign);
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    NodePool(NodePool&& other) noexcept
+        : blockSize(other.blockSize), blockAlign(other.blockAlign), headerSize(other.headerSize),
+          firstChunkBlocks(other.firstChunkBlocks), nextChunkBlocks(other.nextChunkBlocks),
+          upstream(other.upstream), chunks(std::exchange(other.chunks, nullptr)),
+          freeList(std::exchange(other.freeList, nullptr)), bump(std::exchange(other.bump, nullptr)),
+          bumpEnd(std::exchange(other.bumpEnd, nullptr)), live(std::exchange(other.live, 0)),
+          chunkTotal(std::exchange(other.chunkTotal, 0)) {
+        other.nextChunkBlocks = other.firstChunkBlocks;
+    }
+
+    ~NodePool() { release(); }
+
+    void swap(NodePool& other) noexcept {
+        std::swap(blockSize, other.blockSize);
+        std::swap(blockAlign, other.blockAlign);
+        std::swap(headerSize, other.headerSize);
+        std::swap(firstChunkBlocks, other.firstChunkBlocks);
+        std::swap(nextChunkBlocks, other.nextChunkBlocks);
+        std::swap(upstream, other.upstream);
+        std::swap(chunks, other.chunks);
+        std::swap(freeList, other.freeList);
+        std::swap(bump, other.bump);
+        std::swap(bumpEnd, other.bumpEnd);
+        std::swap(live, other.live);
+        std::swap(chunkTotal, other.chunkTotal);
+    }
+
+    void* allocate() {
+        if (freeList) {
+            FreeBlock* block = freeList;
+            freeList = block->next;
+            ++live;
+            return block;
+        }
+        if (bump == bumpEnd)
+            addChunk();   // may throw; nothing is counted yet
+        void* block = bump;
+        bump += blockSize;
+        ++live;
+        return block;
+    }
+
+    void deallocate(void* p) noexcept {
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = freeList;
+        freeList = block;
+        --live;
+    }
+
+    // Returns every chunk to the upstream resource. Objects still living in
+    // the pool must have been destroyed already.
+    void release() noexcept {
+        while (chunks) {
+            Chunk* next = chunks->next;
+            upstream->deallocate(chunks, chunks->bytes, std::max(alignof(Chunk), blockAlign));
+            chunks = next;
+        }
+        freeList = nullptr;
+        bump = bumpEnd = nullptr;
+        live = 0;
+        chunkTotal = 0;
+        nextChunkBlocks = firstChunkBlocks;
+    }
+
+    size_t liveBlocks() const { return live; }
+    size_t chunkCount() const { return chunkTotal; }
+    size_t blockBytes() const { return blockSize; }
+    std::pmr::memory_resource* resource() const { return upstream; }
+};
+
+// NodePool for one node type.
+template<typename Node>
+class TypedNodePool {
+private:
+    NodePool pool;
+
+public:
+    explicit TypedNodePool(size_t firstChunk = 16,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : pool(sizeof(Node), alignof(Node), firstChunk, resource) {}
+
+    template<typename... Args>
+    Node* create(Args&&... args) {
+        void* memory = pool.allocate();
+        try {
+            return new (memory) Node(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            pool.deallocate(memory);
+            throw;
+        }
+    }
+
+    void destroy(Node* node) noexcept {
+        node->~Node();
+        pool.deallocate(node);
+    }
+
+    void release() noexcept { pool.release(); }
+    void swap(TypedNodePool& other) noexcept { pool.swap(other.pool); }
+
+    size_t liveNodes() const { return pool.liveBlocks(); }
+    size_t chunkCount() const { return pool.chunkCount(); }
+    std::pmr::memory_resource* resource() const { return pool.resource(); }
+};
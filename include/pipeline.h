@@ -0,0 +1,374 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "expression.h"
+#include "formatter.h"
+#include "mpmcqueue.h"
+#include "polinom.h"
+
+struct PipelineConfig {
+    unsigned parseThreads = 1;
+    unsigned computeThreads = 1;
+    unsigned formatThreads = 1;
+    // Capacity of each queue between stages (rounded up to a power of two).
+    // A full queue blocks the stage feeding it.
+    size_t queueCapacity = 256;
+    // Most lines read but not yet written. Output is written in input order,
+    // so one slow line holds every later result; the reader waits for the
+    // writer rather than let them pile up. 0 means 4 * queue capacity.
+    size_t maxInFlight = 0;
+};
+
+struct StageStats {
+    std::string name;
+    unsigned threads = 0;
+    uint64_t items = 0;
+    uint64_t errors = 0;
+    // Summed over the stage's threads; busySeconds / wallSeconds / threads
+    // is the stage's utilisation.
+    double busySeconds = 0.0;
+    double itemsPerSecond = 0.0;
+    // Depth of the stage's input queue, sampled at every pop.
+    size_t maxQueueDepth = 0;
+    double meanQueueDepth = 0.0;
+};
+
+struct PipelineStats {
+    double wallSeconds = 0.0;
+    uint64_t lines = 0;
+    std::vector<StageStats> stages;
+};
+
+// Three-stage line pipeline: parse -> compute -> format, each stage with its
+// own thread count, connected by bounded BlockingQueues. A reader thread
+// feeds input lines. The calling thread writes the formatted lines to the
+// output in input order. Because the queues are bounded, a slow stage
+// throttles everything upstream of it instead of buffering without limit.
+//
+// An exception in parse or compute turns that line into "error: <what>"
+// and the line skips the remaining stages. stats() may be called from
+// another thread while run() is in progress. If run() itself fails, e.g.
+// writing the output throws, every queue is closed and the workers are
+// joined before the exception leaves run().
+template<typename Parsed, typename Computed>
+class Pipeline {
+public:
+    using ParseFn = std::function<Parsed(const std::string&)>;
+    using ComputeFn = std::function<Computed(Parsed&)>;
+    using FormatFn = std::function<std::string(const Computed&)>;
+
+private:
+    template<typename T>
+    struct Item {
+        uint64_t id = 0;
+        std::optional<T> value;
+        std::string error;
+    };
+
+    struct alignas(POLINOM_CACHE_LINE) StageCounters {
+        std::atomic<uint64_t> items{ 0 };
+        std::atomic<uint64_t> errors{ 0 };
+        std::atomic<uint64_t> busyNanos{ 0 };
+        std::atomic<uint64_t> depthSum{ 0 };
+        std::atomic<uint64_t> depthSamples{ 0 };
+        std::atomic<size_t> maxDepth{ 0 };
+
+        void reset() {
+            items = 0;
+            errors = 0;
+            busyNanos = 0;
+            depthSum = 0;
+            depthSamples = 0;
+            maxDepth = 0;
+        }
+
+        void sampleDepth(size_t depth) {
+            depthSum.fetch_add(depth, std::memory_order_relaxed);
+            depthSamples.fetch_add(1, std::memory_order_relaxed);
+            size_t seen = maxDepth.load(std::memory_order_relaxed);
+            while (depth > seen && !maxDepth.compare_exchange_weak(seen, depth, std::memory_order_relaxed)) {}
+        }
+    };
+
+    PipelineConfig config;
+    ParseFn parseFn;
+    ComputeFn computeFn;
+    FormatFn formatFn;
+    StageCounters counters[3];
+    std::atomic<uint64_t> linesRead{ 0 };
+    std::atomic<int64_t> startNanos{ 0 };
+    std::atomic<int64_t> endNanos{ 0 };
+
+    static int64_t nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static size_t queueSize(size_t capacity) {
+        size_t p = 2;
+        while (p < capacity)
+            p <<= 1;
+        return p;
+    }
+
+    // Runs `threads` workers that pop from `in`, apply `fn` and push to
+    // `out`. The last worker to finish closes `out`.
+    template<typename In, typename Out, typename Fn>
+    void startStage(std::vector<std::thread>& pool, unsigned threads, StageCounters& stage,
+        BlockingQueue<In>& in, BlockingQueue<Out>& out, std::atomic<unsigned>& running, Fn fn) {
+        running = std::max(1u, threads);
+        for (unsigned t = 0; t < std::max(1u, threads); ++t) {
+            pool.emplace_back([&, fn] {
+                In item;
+                while (in.pop(item)) {
+                    stage.sampleDepth(in.sizeApprox());
+                    int64_t begin = nowNanos();
+                    Out result;
+                    result.id = item.id;
+                    if (!item.value) {
+                        result.error = std::move(item.error);
+                    }
+                    else {
+                        try {
+                            fn(item, result);
+                        }
+                        catch (const std::exception& e) {
+                            result.error = e.what();
+                            stage.errors.fetch_add(1, std::memory_order_relaxed);
+                        }
+                        catch (...) {
+                            result.error = "unknown exception";
+                            stage.errors.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                    stage.busyNanos.fetch_add(static_cast<uint64_t>(nowNanos() - begin), std::memory_order_relaxed);
+                    stage.items.fetch_add(1, std::memory_order_relaxed);
+                    out.push(std::move(result));
+                }
+                if (running.fetch_sub(1) == 1)
+                    out.close();
+            });
+        }
+    }
+
+    // Lines read but not yet written, bounded by the in-flight window.
+    struct Window {
+        std::mutex lock;
+        std::condition_variable open;
+        uint64_t written = 0;
+        bool abandoned = false;
+
+        // Blocks until line `id` fits; false if the run is being abandoned.
+        bool admit(uint64_t id, uint64_t size) {
+            std::unique_lock<std::mutex> guard(lock);
+            open.wait(guard, [&] { return abandoned || id - written < size; });
+            return !abandoned;
+        }
+
+        void advance(uint64_t count) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                written = count;
+            }
+            open.notify_one();
+        }
+
+        void abandon() {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                abandoned = true;
+            }
+            open.notify_all();
+        }
+    };
+
+    // Joins the workers on every exit from run(). If they are still running
+    // when it is destroyed, run() is unwinding: it closes the queues and the
+    // window first so no worker stays blocked.
+    template<typename Stop>
+    struct Crew {
+        std::vector<std::thread> threads;
+        Stop stop;
+
+        explicit Crew(Stop s) : stop(std::move(s)) {}
+
+        void join() {
+            for (auto& t : threads)
+                if (t.joinable())
+                    t.join();
+        }
+
+        ~Crew() {
+            if (std::any_of(threads.begin(), threads.end(), [](const std::thread& t) { return t.joinable(); }))
+                stop();
+            join();
+        }
+    };
+
+public:
+    Pipeline(PipelineConfig cfg, ParseFn parse, ComputeFn compute, FormatFn format)
+        : config(cfg), parseFn(std::move(parse)), computeFn(std::move(compute)), formatFn(std::move(format)) {}
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    const PipelineConfig& getConfig() const { return config; }
+
+    // Streams every line of `in` through the stages and writes one output
+    // line per input line to `out`. Not reentrant.
+    PipelineStats run(std::istream& in, std::ostream& out) {
+        for (auto& c : counters)
+            c.reset();
+        linesRead = 0;
+        startNanos = nowNanos();
+        endNanos = 0;
+
+        size_t capacity = queueSize(config.queueCapacity);
+        BlockingQueue<Item<std::string>> lines(capacity);
+        BlockingQueue<Item<Parsed>> parsed(capacity);
+        BlockingQueue<Item<Computed>> computed(capacity);
+        BlockingQueue<Item<std::string>> formatted(capacity);
+        std::atomic<unsigned> parseRunning{ 0 }, computeRunning{ 0 }, formatRunning{ 0 };
+        Window window;
+        uint64_t windowSize = config.maxInFlight ? config.maxInFlight : 4 * capacity;
+        std::exception_ptr readError;
+        Crew crew([&] {
+            window.abandon();
+            lines.close();
+            parsed.close();
+            computed.close();
+            formatted.close();
+        });
+        std::vector<std::thread>& pool = crew.threads;
+
+        pool.emplace_back([&] {
+            try {
+                Item<std::string> item;
+                std::string line;
+                uint64_t id = 0;
+                while (std::getline(in, line)) {
+                    if (!window.admit(id, windowSize))
+                        break;
+                    item.id = id++;
+                    item.value = std::move(line);
+                    linesRead.fetch_add(1, std::memory_order_relaxed);
+                    if (!lines.push(std::move(item)))
+                        break;
+                    item = Item<std::string>();
+                }
+            }
+            catch (...) {
+                readError = std::current_exception();
+            }
+            lines.close();
+        });
+
+        startStage(pool, config.parseThreads, counters[0], lines, parsed, parseRunning,
+            [this](Item<std::string>& item, Item<Parsed>& result) { result.value.emplace(parseFn(*item.value)); });
+        startStage(pool, config.computeThreads, counters[1], parsed, computed, computeRunning,
+            [this](Item<Parsed>& item, Item<Computed>& result) { result.value.emplace(computeFn(*item.value)); });
+        startStage(pool, config.formatThreads, counters[2], computed, formatted, formatRunning,
+            [this](Item<Computed>& item, Item<std::string>& result) { result.value.emplace(formatFn(*item.value)); });
+
+        // Restore input order; at most the in-flight window is buffered.
+        std::map<uint64_t, std::string> waiting;
+        uint64_t next = 0;
+        Item<std::string> item;
+        while (formatted.pop(item)) {
+            waiting.emplace(item.id, item.value ? std::move(*item.value) : "error: " + item.error);
+            uint64_t first = next;
+            for (auto it = waiting.find(next); it != waiting.end(); it = waiting.find(++next)) {
+                out << it->second << '\n';
+                waiting.erase(it);
+            }
+            if (next != first)
+                window.advance(next);
+        }
+        crew.join();
+        endNanos = nowNanos();
+        if (readError)
+            std::rethrow_exception(readError);
+        return stats();
+    }
+
+    // Counters of the current or last run.
+    PipelineStats stats() const {
+        PipelineStats s;
+        int64_t end = endNanos.load();
+        s.wallSeconds = ((end ? end : nowNanos()) - startNanos.load()) * 1e-9;
+        s.lines = linesRead.load();
+        const char* names[3] = { "parse", "compute", "format" };
+        const unsigned threads[3] = { config.parseThreads, config.computeThreads, config.formatThreads };
+        for (int i = 0; i < 3; ++i) {
+            const StageCounters& c = counters[i];
+            StageStats st;
+            st.name = names[i];
+            st.threads = std::max(1u, threads[i]);
+            st.items = c.items.load();
+            st.errors = c.errors.load();
+            st.busySeconds = c.busyNanos.load() * 1e-9;
+            st.itemsPerSecond = s.wallSeconds > 0 ? st.items / s.wallSeconds : 0.0;
+            st.maxQueueDepth = c.maxDepth.load();
+            uint64_t samples = c.depthSamples.load();
+            st.meanQueueDepth = samples ? static_cast<double>(c.depthSum.load()) / samples : 0.0;
+            s.stages.push_back(st);
+        }
+        return s;
+    }
+};
+
+// Reads lines of definitions, evaluates one expression over each line's
+// definitions, and writes the formatted result line, e.g.
+//
+//   Expression e("a*b + c");
+//   PolinomPipeline pipeline(e);
+//   pipeline.run(in, out);   // "a = x+1; b = y; c = 2" -> "xy+y+2"
+//
+// Definitions are separated by ';' and take the form name = polinom.
+class PolinomPipeline : public Pipeline<std::map<std::string, Polinom>, Polinom> {
+public:
+    static std::map<std::string, Polinom> parseDefinitions(const std::string& line) {
+        std::map<std::string, Polinom> table;
+        size_t start = 0;
+        while (start <= line.size()) {
+            size_t end = line.find(';', start);
+            if (end == std::string::npos)
+                end = line.size();
+            std::string part = line.substr(start, end - start);
+            if (part.find_first_not_of(" \t\r") != std::string::npos) {
+                size_t eq = part.find('=');
+                if (eq == std::string::npos)
+                    throw std::runtime_error("Expected name = polinom");
+                size_t b = part.find_first_not_of(" \t", 0), e = part.find_last_not_of(" \t", eq - 1);
+                if (b >= eq || e == std::string::npos)
+                    throw std::runtime_error("Expected name = polinom");
+                table[part.substr(b, e - b + 1)] = Polinom(part.substr(eq + 1));
+            }
+            start = end + 1;
+        }
+        return table;
+    }
+
+    explicit PolinomPipeline(const Expression& expression, PipelineConfig cfg = PipelineConfig(),
+        FormatOptions format = FormatOptions())
+        : Pipeline(cfg,
+            &PolinomPipeline::parseDefinitions,
+            [expression](std::map<std::string, Polinom>& table) { return expression.evaluate(table); },
+            [format](const Polinom& p) { return formatPolinom(p, format); }) {}
+};
@@ -3,23 +3,60 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <memory_resource>
 #include <algorithm>
 #include <stdexcept>
 #include <cmath>
 #include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include "coefficient.h"
+#include "smallvector.h"
+#include "metrics.h"
+#include "trace.h"
+#include "tracking.h"
+
+// Terms a Polinom keeps inside the object before spilling to the heap. All
+// translation units of a program must agree on the value.
+#ifndef POLINOM_INLINE_TERMS
+#define POLINOM_INLINE_TERMS 8
+#endif
+
+namespace detail {
+
+// Term list for coefficient types that are not trivially copyable: the
+// subset of the SmallVector interface BasicPolinom uses.
+template <class T>
+class TermVector : public std::pmr::vector<T> {
+public:
+    using std::pmr::vector<T>::vector;
+    std::pmr::memory_resource* resource() const { return this->get_allocator().resource(); }
+};
+
+}
+
+// A term coeff * x^a y^b z^c with degree packed as a * 100 + b * 10 + c.
+// C is the coefficient ring; CoeffTraits<C> says how to compare, parse and
+// print it.
+template <class C>
+struct BasicMonom {
+    using Traits = CoeffTraits<C>;
 
-struct Monom {
     int degree = 0;
-    double coeff = 0.0;
+    C coeff = C(0);
 
-    Monom() = default;
-    Monom(int deg, double c) : degree(deg), coeff(c) {
+    BasicMonom() = default;
+    BasicMonom(int deg, C c) : degree(deg), coeff(std::move(c)) {
         validateDegree();
     }
 
-    explicit Monom(const std::string& str) {
+    explicit BasicMonom(const std::string& str) {
         if (str.empty() || str == "0") {
-            coeff = 0.0;
+            coeff = C(0);
             degree = 0;
             return;
         }
@@ -41,16 +78,16 @@ private:
             while (pos < str.size() && std::isspace(str[pos])) pos++;
         }
 
-        double coef = 1.0;
+        C coef = C(1);
         if (pos < str.size() && (std::isdigit(str[pos]) || str[pos] == '.')) {
             size_t end_pos = pos;
             try {
-                coef = std::stod(str.substr(pos), &end_pos);
+                coef = Traits::parse(str, pos, end_pos);
             }
             catch (...) {
                 throw std::runtime_error("Invalid coefficient format");
             }
-            pos += end_pos;
+            pos = end_pos;
             while (pos < str.size() && std::isspace(str[pos])) pos++;
         }
         if (negative) coef = -coef;
@@ -79,7 +116,7 @@ private:
         if (x_pow > 9 || y_pow > 9 || z_pow > 9)
             throw std::runtime_error("Degree overflow in monom: exponent too large (max 9)");
 
-        coeff = coef;
+        coeff = std::move(coef);
         degree = x_pow * 100 + y_pow * 10 + z_pow;
     }
 
@@ -106,48 +143,49 @@ private:
     }
 
 public:
-    bool operator>(const Monom& other) const { return degree > other.degree; }
-    bool operator<(const Monom& other) const { return degree < other.degree; }
-    bool operator==(const Monom& other) const {
-        return std::abs(coeff - other.coeff) < 1e-10 && degree == other.degree;
+    bool operator>(const BasicMonom& other) const { return degree > other.degree; }
+    bool operator<(const BasicMonom& other) const { return degree < other.degree; }
+    bool operator==(const BasicMonom& other) const {
+        return Traits::equal(coeff, other.coeff) && degree == other.degree;
     }
-    bool operator!=(const Monom& other) const { return !(*this == other); }
+    bool operator!=(const BasicMonom& other) const { return !(*this == other); }
 
-    Monom operator+(const Monom& other) const {
+    BasicMonom operator+(const BasicMonom& other) const {
         if (degree != other.degree) {
             throw std::runtime_error("Cannot add monoms with different degrees");
         }
-        return Monom(degree, coeff + other.coeff);
+        return BasicMonom(degree, coeff + other.coeff);
     }
 
-    Monom operator-(const Monom& other) const {
+    BasicMonom operator-(const BasicMonom& other) const {
         if (degree != other.degree) {
             throw std::runtime_error("Cannot subtract monoms with different degrees");
         }
-        return Monom(degree, coeff - other.coeff);
+        return BasicMonom(degree, coeff - other.coeff);
     }
 
-    Monom operator*(double val) const {
-        if (std::abs(val) < 1e-10)
-            return Monom(0, 0.0);
-        return Monom(degree, coeff * val);
+    BasicMonom operator*(const C& val) const {
+        if (Traits::isZero(val))
+            return BasicMonom(0, C(0));
+        return BasicMonom(degree, coeff * val);
     }
 
-    Monom operator*(const Monom& other) const {
+    BasicMonom operator*(const BasicMonom& other) const {
         int new_degree = degree + other.degree;
-        if ((new_degree / 100) > 9 || ((new_degree / 10) % 10 > 9 || (new_degree % 10) > 9))
+        if (degree / 100 + other.degree / 100 > 9 || (degree / 10) % 10 + (other.degree / 10) % 10 > 9
+            || degree % 10 + other.degree % 10 > 9)
             throw std::runtime_error("Degree overflow in monom multiplication");
-        return Monom(new_degree, coeff * other.coeff);
+        return BasicMonom(new_degree, coeff * other.coeff);
     }
 
-    friend std::ostream& operator<<(std::ostream& os, const Monom& m) {
-        if (m.coeff == 1.0 && m.degree != 0) {
+    friend std::ostream& operator<<(std::ostream& os, const BasicMonom& m) {
+        if (m.coeff == C(1) && m.degree != 0) {
         }
-        else if (m.coeff == -1.0 && m.degree != 0) {
+        else if (m.coeff == C(-1) && m.degree != 0) {
             os << "-";
         }
         else {
-            os << m.coeff;
+            Traits::write(os, m.coeff);
         }
         auto printVar = [&](char var, int power) {
             if (power > 0) {
@@ -162,9 +200,34 @@ public:
     }
 };
 
-class Polinom {
+// Up to POLINOM_INLINE_TERMS terms live inside the object; longer term lists
+// spill to a std::pmr::memory_resource. Results of arithmetic are allocated
+// from the left operand's resource, so expressions over arena-backed operands
+// keep all intermediates in that arena. Copies are made on the default
+// resource and therefore outlive the arena; a copy of a spilled polynomial on
+// the same resource shares its term block until either side is modified.
+//
+// The coefficient ring is a template parameter; Polinom, below, is the
+// double instantiation the rest of the library works with. Exact rings
+// (ModInt, Rational) keep a term exactly when its coefficient is nonzero.
+// Rings whose values own memory (Rational) cannot go in a SmallVector; their
+// terms live in a plain pmr vector with the same resource semantics and are
+// never shared between copies.
+template <class C>
+class BasicPolinom {
+public:
+    using Coeff = C;
+    using Monom = BasicMonom<C>;
+    using Traits = CoeffTraits<C>;
+    static constexpr bool kCopyOnWriteTerms = std::is_trivially_copyable_v<Monom>;
+    using Terms = std::conditional_t<kCopyOnWriteTerms,
+        SmallVector<Monom, POLINOM_INLINE_TERMS>, detail::TermVector<Monom>>;
+
 private:
-    std::vector<Monom> monoms;
+    using Accumulator = typename Traits::Accumulator;
+    using Polinom = BasicPolinom;
+
+    Terms monoms;
 
     void parsePolinom(const std::string& str) {
         std::vector<std::string> terms;
@@ -189,8 +252,8 @@ private:
         for (const auto& term : terms) {
             if (!term.empty()) {
                 Monom m(term);
-                if (std::fabs(m.coeff) > 1e-10)
-                    monoms.push_back(m);
+                if (!Traits::isZero(m.coeff))
+                    monoms.push_back(std::move(m));
             }
         }
         combineLikeTerms();
@@ -198,42 +261,232 @@ private:
 
     void combineLikeTerms() {
         if (monoms.empty()) return;
-        std::sort(monoms.begin(), monoms.end(), std::greater<Monom>());
-        std::vector<Monom> combined;
+        if (!std::is_sorted(monoms.begin(), monoms.end(), std::greater<Monom>()))
+            std::sort(monoms.begin(), monoms.end(), std::greater<Monom>());
+        size_t out = 0;
         Monom current = monoms[0];
         for (size_t i = 1; i < monoms.size(); ++i) {
             if (monoms[i].degree == current.degree) {
                 current.coeff += monoms[i].coeff;
             }
             else {
-                if (std::fabs(current.coeff) > 1e-10)
-                    combined.push_back(current);
+                if (!Traits::isZero(current.coeff))
+                    monoms[out++] = current;
                 current = monoms[i];
             }
         }
-        if (std::fabs(current.coeff) > 1e-10)
-            combined.push_back(current);
-        monoms = std::move(combined);
+        if (!Traits::isZero(current.coeff))
+            monoms[out++] = current;
+        monoms.resize(out);
+    }
+
+    void maxPowers(int (&powers)[3]) const {
+        powers[0] = powers[1] = powers[2] = 0;
+        for (const auto& m : monoms) {
+            powers[0] = std::max(powers[0], m.degree / 100);
+            powers[1] = std::max(powers[1], (m.degree / 10) % 10);
+            powers[2] = std::max(powers[2], m.degree % 10);
+        }
+    }
+
+    // A product overflows iff the largest powers of some variable do, so one
+    // check up front lets the kernels add packed degrees without carries.
+    // Returns the number of degrees the product can reach, the box bounded
+    // by those largest powers.
+    size_t checkProductDegrees(const Polinom& other) const {
+        int a[3], b[3];
+        maxPowers(a);
+        other.maxPowers(b);
+        if (a[0] + b[0] > 9 || a[1] + b[1] > 9 || a[2] + b[2] > 9)
+            throw std::runtime_error("Multiplication error: Degree overflow in monom multiplication");
+        return static_cast<size_t>(a[0] + b[0] + 1) * (a[1] + b[1] + 1) * (a[2] + b[2] + 1);
+    }
+
+    size_t productSpan(const Polinom& other) const {
+        return static_cast<size_t>(monoms.front().degree + other.monoms.front().degree
+            - monoms.back().degree - other.monoms.back().degree + 1);
+    }
+
+    // acc[d - lo] += coefficient of x^d over rows [rowBegin, rowEnd) of *this.
+    void accumulateRows(const Polinom& other, size_t rowBegin, size_t rowEnd, Accumulator* acc, int lo) const {
+        const Monom* b = other.monoms.data();
+        size_t m = other.monoms.size();
+        for (size_t i = rowBegin; i < rowEnd; ++i) {
+            Accumulator* row = acc + (monoms[i].degree - lo);
+            const C& c = monoms[i].coeff;
+            for (size_t j = 0; j < m; ++j)
+                Traits::multiplyAdd(row[b[j].degree], c, b[j].coeff);
+        }
+    }
+
+    static Polinom fromDense(const Accumulator* acc, int lo, int hi, std::pmr::memory_resource* resource) {
+        Polinom result(resource);
+        size_t nonzero = 0;
+        for (int d = hi; d >= lo; --d)
+            if (!Traits::isZero(Traits::reduce(acc[d - lo])))
+                ++nonzero;
+        result.monoms.reserve(nonzero);
+        for (int d = hi; d >= lo; --d) {
+            C c = Traits::reduce(acc[d - lo]);
+            if (!Traits::isZero(c))
+                result.monoms.push_back(Monom(d, std::move(c)));
+        }
+        return result;
+    }
+
+    // Johnson's heap multiplication: one cursor per term of the shorter
+    // operand walks the longer one, and a max-heap on the product degree
+    // yields the terms in output order, so nothing is sorted or merged
+    // afterwards. Cursors start lazily: row i + 1 enters the heap only once
+    // row i has produced its first term, which keeps the heap small when
+    // the rows barely overlap.
+    Polinom multiplyByHeap(const Polinom& other, std::pmr::memory_resource* resource) const {
+        const Terms& rows = monoms.size() <= other.monoms.size() ? monoms : other.monoms;
+        const Terms& cols = monoms.size() <= other.monoms.size() ? other.monoms : monoms;
+        struct Cursor {
+            int degree;
+            uint32_t row;
+            uint32_t col;
+        };
+        std::vector<Cursor> heap(rows.size());
+        size_t size = 0;
+        auto siftDown = [&](size_t i) {
+            Cursor moving = heap[i];
+            for (size_t child = 2 * i + 1; child < size; child = 2 * i + 1) {
+                if (child + 1 < size && heap[child + 1].degree > heap[child].degree)
+                    ++child;
+                if (heap[child].degree <= moving.degree)
+                    break;
+                heap[i] = heap[child];
+                i = child;
+            }
+            heap[i] = moving;
+        };
+        auto siftUp = [&](size_t i) {
+            Cursor moving = heap[i];
+            while (i > 0 && heap[(i - 1) / 2].degree < moving.degree) {
+                heap[i] = heap[(i - 1) / 2];
+                i = (i - 1) / 2;
+            }
+            heap[i] = moving;
+        };
+        heap[size++] = Cursor{ rows[0].degree + cols[0].degree, 0, 0 };
+
+        Polinom result(resource);
+        result.monoms.reserve(std::min(rows.size() * cols.size(), productSpan(other)));
+        while (size > 0) {
+            int degree = heap[0].degree;
+            Accumulator sum = Accumulator();
+            do {
+                // Advance the top cursor in place; one sift restores the heap.
+                Cursor& top = heap[0];
+                uint32_t row = top.row;
+                Traits::multiplyAdd(sum, rows[row].coeff, cols[top.col].coeff);
+                bool startNext = top.col == 0 && row + 1 < rows.size();
+                if (++top.col < cols.size())
+                    top.degree = rows[row].degree + cols[top.col].degree;
+                else
+                    heap[0] = heap[--size];
+                siftDown(0);
+                if (startNext) {
+                    heap[size] = Cursor{ rows[row + 1].degree + cols[0].degree, row + 1, 0 };
+                    siftUp(size++);
+                }
+            } while (size > 0 && heap[0].degree == degree);
+            C c = Traits::reduce(sum);
+            if (!Traits::isZero(c))
+                result.monoms.push_back(Monom(degree, std::move(c)));
+        }
+        return result;
+    }
+
+    // Accumulates every product into an open-addressing table keyed by the
+    // packed degree and sorts the distinct degrees once at the end. Costs
+    // O(pairs) plus O(out log out) whatever the degree range, so it suits
+    // operands whose product terms are few and scattered.
+    Polinom multiplyByHash(const Polinom& other, std::pmr::memory_resource* resource) const {
+        size_t expected = std::min(monoms.size() * other.monoms.size(), productSpan(other));
+        int bits = 4;
+        while ((size_t(1) << bits) < 2 * expected)
+            ++bits;
+        size_t mask = (size_t(1) << bits) - 1;
+        std::vector<int> keys(mask + 1, -1);
+        std::vector<Accumulator> sums(mask + 1);
+        std::vector<uint32_t> used;
+        used.reserve(expected);
+
+        for (const auto& m1 : monoms) {
+            for (const auto& m2 : other.monoms) {
+                int degree = m1.degree + m2.degree;
+                size_t slot = (static_cast<uint32_t>(degree) * 2654435761u) >> (32 - bits);
+                while (keys[slot] != degree && keys[slot] != -1)
+                    slot = (slot + 1) & mask;
+                if (keys[slot] == -1) {
+                    keys[slot] = degree;
+                    used.push_back(static_cast<uint32_t>(slot));
+                }
+                Traits::multiplyAdd(sums[slot], m1.coeff, m2.coeff);
+            }
+        }
+
+        Polinom result(resource);
+        result.monoms.reserve(used.size());
+        for (uint32_t slot : used) {
+            C c = Traits::reduce(sums[slot]);
+            if (!Traits::isZero(c))
+                result.monoms.push_back(Monom(keys[slot], std::move(c)));
+        }
+        std::sort(result.monoms.begin(), result.monoms.end(), std::greater<Monom>());
+        return result;
     }
 
 public:
-    Polinom() = default;
-    explicit Polinom(const std::string& str) {
+    BasicPolinom() = default;
+    explicit BasicPolinom(std::pmr::memory_resource* resource) : monoms(resource) {}
+    explicit BasicPolinom(const std::string& str,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : monoms(resource) {
+        POLINOM_METRIC_TIME(Parse);
+        POLINOM_TRACE_SPAN("parse_polinom");
+        POLINOM_ALLOC_SCOPE(Parse);
         if (!str.empty())
             parsePolinom(str);
+        POLINOM_METRIC_ADD(MonomsProcessed, monoms.size());
+    }
+    explicit BasicPolinom(const std::vector<Monom>& terms,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : monoms(resource) {
+        monoms.assign(terms.begin(), terms.end());
+        combineLikeTerms();
     }
+    explicit BasicPolinom(Terms terms) : monoms(std::move(terms)) {
+        combineLikeTerms();
+    }
+
+    BasicPolinom(const BasicPolinom&) = default;
+    BasicPolinom(const BasicPolinom& other, std::pmr::memory_resource* resource)
+        : monoms(other.monoms, resource) {}
+    BasicPolinom(BasicPolinom&&) noexcept = default;
+    BasicPolinom& operator=(const BasicPolinom&) = default;
+    BasicPolinom& operator=(BasicPolinom&&) = default;
 
-    Polinom(const Polinom&) = default;
-    Polinom& operator=(const Polinom&) = default;
+    std::pmr::memory_resource* getResource() const { return monoms.resource(); }
 
-    Polinom operator+(const Polinom& other) const {
-        Polinom result;
+    // Arithmetic with an explicit resource for the result; the operators use
+    // the left operand's resource.
+    Polinom add(const Polinom& other, std::pmr::memory_resource* resource) const {
+        POLINOM_METRIC_TIME(Add);
+        POLINOM_ALLOC_SCOPE(Add);
+        POLINOM_METRIC_ADD(Merges, 1);
+        POLINOM_METRIC_ADD(MonomsProcessed, monoms.size() + other.monoms.size());
+        Polinom result(resource);
+        result.monoms.reserve(monoms.size() + other.monoms.size());
         size_t i = 0, j = 0;
         while (i < monoms.size() && j < other.monoms.size()) {
             if (monoms[i].degree == other.monoms[j].degree) {
                 Monom sum = monoms[i] + other.monoms[j];
-                if (std::fabs(sum.coeff) > 1e-10)
-                    result.monoms.push_back(sum);
+                if (!Traits::isZero(sum.coeff))
+                    result.monoms.push_back(std::move(sum));
                 ++i; ++j;
             }
             else if (monoms[i].degree > other.monoms[j].degree) {
@@ -256,14 +509,19 @@ public:
         return result;
     }
 
-    Polinom operator-(const Polinom& other) const {
-        Polinom result;
+    Polinom subtract(const Polinom& other, std::pmr::memory_resource* resource) const {
+        POLINOM_METRIC_TIME(Subtract);
+        POLINOM_ALLOC_SCOPE(Subtract);
+        POLINOM_METRIC_ADD(Merges, 1);
+        POLINOM_METRIC_ADD(MonomsProcessed, monoms.size() + other.monoms.size());
+        Polinom result(resource);
+        result.monoms.reserve(monoms.size() + other.monoms.size());
         size_t i = 0, j = 0;
         while (i < monoms.size() && j < other.monoms.size()) {
             if (monoms[i].degree == other.monoms[j].degree) {
                 Monom diff = monoms[i] - other.monoms[j];
-                if (std::fabs(diff.coeff) > 1e-10)
-                    result.monoms.push_back(diff);
+                if (!Traits::isZero(diff.coeff))
+                    result.monoms.push_back(std::move(diff));
                 ++i; ++j;
             }
             else if (monoms[i].degree > other.monoms[j].degree) {
@@ -286,38 +544,154 @@ public:
         return result;
     }
 
-    Polinom operator*(const Polinom& other) const {
-        Polinom result;
-        for (const auto& m1 : monoms) {
-            Polinom temp;
-            for (const auto& m2 : other.monoms) {
-                try {
-                    Monom product = m1 * m2;
-                    if (std::fabs(product.coeff) > 1e-10)
-                        temp.monoms.push_back(product);
-                }
-                catch (const std::runtime_error& e) {
-                    throw std::runtime_error(std::string("Multiplication error: ") + e.what());
-                }
+    // Term pairs above which operator* splits the work across threads. With
+    // exponents capped at 9 no product exceeds 125 * 216 = 27000 pairs, which
+    // a single thread finishes faster than it can start workers, so this only
+    // takes effect once larger exponents are allowed; call multiplyParallel()
+    // directly to force it.
+    static constexpr size_t kParallelMultiplyThreshold = size_t(1) << 17;
+
+    // Kernel behind multiply(); Auto lets chooseMultiplyStrategy() decide.
+    enum class MultiplyStrategy { Auto, Dense, Heap, Hash };
+
+    // Picks the cheapest kernel for an n x m term product whose degrees span
+    // `span` packed values, of which at most `reachable` can occur. Estimates
+    // are in nanoseconds, fitted to BM_MultiplyStrategy on x86-64:
+    //   Dense: clearing and scanning the span, plus one add per pair.
+    //   Heap: a sift of depth log2(min(n, m)) per pair; output comes sorted.
+    //   Hash: one probe per pair, then sorting the distinct degrees, of which
+    //         there are at most min(pairs, reachable).
+    // With exponents capped at 9 the span never exceeds 1000, so dense wins
+    // from about 16 x 16 terms up and the heap below that; hashing pays off
+    // when many products collapse onto few degrees spread over a range far
+    // wider than the dense accumulator.
+    static MultiplyStrategy chooseMultiplyStrategy(size_t n, size_t m, size_t span, size_t reachable) {
+        double pairs = static_cast<double>(n) * m;
+        double out = std::min({ pairs, static_cast<double>(span), static_cast<double>(reachable) });
+        double dense = 1.2 * span + 0.9 * pairs;
+        double heap = 50.0 + pairs * (3.0 + 3.0 * std::log2(static_cast<double>(std::min(n, m))));
+        double hash = 60.0 + 1.5 * pairs + 2.0 * out * std::log2(out + 1);
+        if (dense <= heap && dense <= hash)
+            return MultiplyStrategy::Dense;
+        return heap <= hash ? MultiplyStrategy::Heap : MultiplyStrategy::Hash;
+    }
+
+    Polinom multiply(const Polinom& other, std::pmr::memory_resource* resource) const {
+        return multiply(other, resource, MultiplyStrategy::Auto);
+    }
+
+    Polinom multiply(const Polinom& other, std::pmr::memory_resource* resource, MultiplyStrategy strategy) const {
+        POLINOM_ALLOC_SCOPE(Multiply);
+        size_t pairs = monoms.size() * other.monoms.size();
+        if (pairs >= kParallelMultiplyThreshold) {
+            unsigned threads = std::thread::hardware_concurrency();
+            if (threads > 1)
+                return multiplyParallel(other, threads, resource);
+        }
+        POLINOM_METRIC_TIME(Multiply);
+        POLINOM_METRIC_MULTIPLY(pairs);
+        POLINOM_METRIC_ADD(MonomsProcessed, pairs);
+        if (pairs == 0)
+            return Polinom(resource);
+        size_t reachable = checkProductDegrees(other);
+
+        if (strategy == MultiplyStrategy::Auto)
+            strategy = chooseMultiplyStrategy(monoms.size(), other.monoms.size(), productSpan(other), reachable);
+        if (strategy == MultiplyStrategy::Heap)
+            return multiplyByHeap(other, resource);
+        if (strategy == MultiplyStrategy::Hash)
+            return multiplyByHash(other, resource);
+
+        int lo = monoms.back().degree + other.monoms.back().degree;
+        int hi = monoms.front().degree + other.monoms.front().degree;
+        if constexpr (std::is_trivially_copyable_v<Accumulator>) {
+            Accumulator acc[1000];
+            std::fill(acc, acc + productSpan(other), Accumulator());
+            accumulateRows(other, 0, monoms.size(), acc, lo);
+            return fromDense(acc, lo, hi, resource);
+        }
+        else {
+            std::vector<Accumulator> acc(productSpan(other));
+            accumulateRows(other, 0, monoms.size(), acc.data(), lo);
+            return fromDense(acc.data(), lo, hi, resource);
+        }
+    }
+
+    // Splits the rows of *this across `threads` workers, each summing into a
+    // private dense accumulator; the accumulators are then added up. No
+    // locks are taken and results do not depend on the thread count beyond
+    // floating-point summation order.
+    Polinom multiplyParallel(const Polinom& other, unsigned threads) const {
+        return multiplyParallel(other, threads, getResource());
+    }
+
+    Polinom multiplyParallel(const Polinom& other, unsigned threads, std::pmr::memory_resource* resource) const {
+        POLINOM_METRIC_TIME(Multiply);
+        POLINOM_ALLOC_SCOPE(Multiply);
+        POLINOM_METRIC_MULTIPLY(monoms.size() * other.monoms.size());
+        POLINOM_METRIC_ADD(MonomsProcessed, monoms.size() * other.monoms.size());
+        if (empty() || other.empty())
+            return Polinom(resource);
+        checkProductDegrees(other);
+        if (threads > monoms.size())
+            threads = static_cast<unsigned>(monoms.size());
+        if (threads < 1)
+            threads = 1;
+
+        size_t span = productSpan(other);
+        int lo = monoms.back().degree + other.monoms.back().degree;
+        std::vector<Accumulator> partial(threads * span);
+        auto work = [&](unsigned t) {
+            size_t rowBegin = monoms.size() * t / threads;
+            size_t rowEnd = monoms.size() * (t + 1) / threads;
+            accumulateRows(other, rowBegin, rowEnd, &partial[t * span], lo);
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (unsigned t = 1; t < threads; ++t) {
+            try {
+                workers.emplace_back(work, t);
+            }
+            catch (const std::system_error&) {
+                work(t);
             }
-            result = result + temp;
         }
-        return result;
+        work(0);
+        for (auto& w : workers)
+            w.join();
+
+        for (unsigned t = 1; t < threads; ++t) {
+            const Accumulator* src = &partial[t * span];
+            for (size_t i = 0; i < span; ++i)
+                Traits::merge(partial[i], src[i]);
+        }
+        return fromDense(partial.data(), lo, lo + static_cast<int>(span) - 1, resource);
     }
 
-    Polinom operator*(double scalar) const {
-        Polinom result;
+    Polinom operator+(const Polinom& other) const { return add(other, getResource()); }
+    Polinom operator-(const Polinom& other) const { return subtract(other, getResource()); }
+    Polinom operator*(const Polinom& other) const { return multiply(other, getResource()); }
+
+    Polinom scale(const C& scalar, std::pmr::memory_resource* resource) const {
+        POLINOM_METRIC_TIME(Scale);
+        POLINOM_ALLOC_SCOPE(Scale);
+        POLINOM_METRIC_ADD(MonomsProcessed, monoms.size());
+        Polinom result(resource);
+        result.monoms.reserve(monoms.size());
         for (const auto& m : monoms) {
             Monom product = m * scalar;
-            if (std::fabs(product.coeff) > 1e-10)
-                result.monoms.push_back(product);
+            if (!Traits::isZero(product.coeff))
+                result.monoms.push_back(std::move(product));
         }
         return result;
     }
 
+    Polinom operator*(const C& scalar) const { return scale(scalar, getResource()); }
+
     size_t size() const { return monoms.size(); }
     bool empty() const { return monoms.empty(); }
-    const std::vector<Monom>& getMonoms() const { return monoms; }
+    const Terms& getMonoms() const { return monoms; }
 
     bool operator==(const Polinom& other) const {
         if (monoms.size() != other.monoms.size())
@@ -329,13 +703,40 @@ public:
     }
     bool operator!=(const Polinom& other) const { return !(*this == other); }
 
+    // Bitwise term equality, consistent with hash() (operator== is tolerant).
+    bool identical(const Polinom& other) const {
+        if (monoms.size() != other.monoms.size())
+            return false;
+        for (size_t i = 0; i < monoms.size(); ++i)
+            if (monoms[i].degree != other.monoms[i].degree || monoms[i].coeff != other.monoms[i].coeff)
+                return false;
+        return true;
+    }
+
+    size_t hash() const {
+        uint64_t h = 1469598103934665603ull;
+        for (const Monom& m : monoms) {
+            h = (h ^ static_cast<uint64_t>(m.degree)) * 1099511628211ull;
+            h = (h ^ Traits::hash(m.coeff)) * 1099511628211ull;
+            h ^= h >> 29;
+        }
+        return static_cast<size_t>(h);
+    }
+
+    bool sharesTermsWith(const Polinom& other) const {
+        if constexpr (kCopyOnWriteTerms)
+            return !monoms.isInline() && monoms.data() == other.monoms.data();
+        else
+            return false;
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const Polinom& p) {
         if (p.monoms.empty()) {
             os << "0";
             return os;
         }
         for (size_t i = 0; i < p.monoms.size(); ++i) {
-            if (i > 0 && p.monoms[i].coeff > 0)
+            if (i > 0 && !Traits::isNegative(p.monoms[i].coeff))
                 os << "+";
             os << p.monoms[i];
         }
@@ -346,3 +747,6 @@ public:
         std::cout << *this << std::endl;
     }
 };
+
+using Monom = BasicMonom<double>;
+using Polinom = BasicPolinom<double>;
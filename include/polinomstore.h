@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "polinom.h"
+
+// Named polynomials for many concurrent readers and occasional writers.
+//
+// Readers never lock: the table is an immutable snapshot behind an atomic
+// pointer. A reader announces itself in one of kStripes padded counters,
+// loads the pointer and reads. Writers serialize on a mutex, copy the
+// snapshot (spilled terms are shared copy-on-write, so this copies names
+// and handles, not coefficients), publish the copy, then wait for every
+// reader that might still see the old snapshot before freeing it.
+//
+// That wait is the SRCU scheme: readers count themselves under the current
+// epoch parity, and a writer flips the parity twice, each time waiting for
+// the old parity's counters to drain. Two flips cover a reader that read
+// the parity just before the first flip but registered after it.
+//
+// read() runs a callback on the stored value in place. find() returns a
+// copy, which for spilled terms bumps a shared refcount; read() avoids
+// that shared write on hot paths.
+class PolinomStore {
+private:
+    using Table = std::unordered_map<std::string, Polinom>;
+
+    static constexpr size_t kStripes = 64;
+
+    struct alignas(64) Stripe {
+        std::atomic<int64_t> readers[2] = { {0}, {0} };
+    };
+
+    std::atomic<const Table*> current;
+    mutable std::atomic<unsigned> epoch{ 0 };
+    mutable std::array<Stripe, kStripes> stripes;
+    std::mutex writeLock;
+
+    static size_t stripeIndex() {
+        static std::atomic<size_t> nextThread{ 0 };
+        thread_local size_t index = nextThread.fetch_add(1, std::memory_order_relaxed) % kStripes;
+        return index;
+    }
+
+    class ReadSection {
+        std::atomic<int64_t>& counter;
+
+    public:
+        explicit ReadSection(const PolinomStore& store)
+            : counter(store.stripes[stripeIndex()].readers[store.epoch.load() & 1]) {
+            counter.fetch_add(1);
+        }
+        ~ReadSection() { counter.fetch_sub(1, std::memory_order_release); }
+
+        ReadSection(const ReadSection&) = delete;
+        ReadSection& operator=(const ReadSection&) = delete;
+    };
+
+    void waitForReaders(unsigned parity) {
+        for (auto& s : stripes)
+            while (s.readers[parity].load(std::memory_order_acquire) != 0)
+                std::this_thread::yield();
+    }
+
+    void synchronize() {
+        for (int flip = 0; flip < 2; ++flip) {
+            unsigned old = epoch.fetch_add(1);
+            waitForReaders(old & 1);
+        }
+    }
+
+    // Caller holds writeLock.
+    void publish(const Table* next) {
+        const Table* old = current.exchange(next);
+        synchronize();
+        delete old;
+    }
+
+    template<typename Fn>
+    bool update(Fn&& change) {
+        std::lock_guard<std::mutex> guard(writeLock);
+        auto next = std::make_unique<Table>(*current.load());
+        if (!change(*next))
+            return false;
+        publish(next.release());
+        return true;
+    }
+
+public:
+    PolinomStore() : current(new Table()) {}
+    ~PolinomStore() { delete current.load(); }
+
+    PolinomStore(const PolinomStore&) = delete;
+    PolinomStore& operator=(const PolinomStore&) = delete;
+
+    // Calls fn(const Polinom&) if `name` is present. The reference is only
+    // valid inside fn, and fn must not write to this store.
+    template<typename Fn>
+    bool read(const std::string& name, Fn&& fn) const {
+        POLINOM_METRIC_TIME(StoreLookup);
+        POLINOM_METRIC_ADD(StoreLookups, 1);
+        POLINOM_TRACE_SPAN("store_lookup");
+        ReadSection section(*this);
+        const Table* table = current.load();
+        auto it = table->find(name);
+        if (it == table->end()) {
+            POLINOM_METRIC_ADD(StoreMisses, 1);
+            return false;
+        }
+        POLINOM_METRIC_ADD(StoreHits, 1);
+        fn(it->second);
+        return true;
+    }
+
+    std::optional<Polinom> find(const std::string& name) const {
+        std::optional<Polinom> result;
+        read(name, [&](const Polinom& p) { result.emplace(p); });
+        return result;
+    }
+
+    bool contains(const std::string& name) const {
+        return read(name, [](const Polinom&) {});
+    }
+
+    size_t size() const {
+        ReadSection section(*this);
+        return current.load()->size();
+    }
+
+    // Visits one consistent snapshot of every entry.
+    void forEach(const std::function<void(const std::string&, const Polinom&)>& fn) const {
+        ReadSection section(*this);
+        for (const auto& entry : *current.load())
+            fn(entry.first, entry.second);
+    }
+
+    // Returns true if the name was new.
+    bool insertOrAssign(const std::string& name, const Polinom& value) {
+        POLINOM_METRIC_TIME(StoreWrite);
+        POLINOM_METRIC_ADD(StoreInserts, 1);
+        POLINOM_ALLOC_SCOPE(StoreInsert);
+        bool inserted = false;
+        update([&](Table& table) {
+            inserted = table.insert_or_assign(name, Polinom(value, std::pmr::get_default_resource())).second;
+            return true;
+        });
+        return inserted;
+    }
+
+    bool erase(const std::string& name) {
+        POLINOM_METRIC_TIME(StoreWrite);
+        POLINOM_METRIC_ADD(StoreErases, 1);
+        return update([&](Table& table) { return table.erase(name) > 0; });
+    }
+
+    void clear() {
+        update([](Table& table) {
+            table.clear();
+            return true;
+        });
+    }
+};
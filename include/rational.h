@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "bigint.h"
+#include "coefficient.h"
+
+// Exact fraction num / den in lowest terms with den > 0; zero is 0/1.
+// Every operation renormalizes through a gcd, so values compare equal
+// exactly when they are.
+class Rational {
+public:
+    Rational() : den(1) {}
+    Rational(int64_t n) : num(n), den(1) {}
+    Rational(BigInt n, BigInt d) : num(std::move(n)), den(std::move(d)) {
+        if (den.isZero())
+            throw std::domain_error("Rational: zero denominator");
+        normalize();
+    }
+
+    // Digits with an optional fractional part and an optional /denominator
+    // at text[pos]: "3", "0.25", ".5", "3/4", "1.5/7". A leading '.' is
+    // accepted because Monom treats it as the start of a coefficient.
+    static Rational parse(const std::string& text, size_t pos, size_t& end) {
+        auto digitAt = [&text](size_t i) {
+            return i < text.size() && std::isdigit(static_cast<unsigned char>(text[i]));
+        };
+        BigInt n, scale(1);
+        if (digitAt(pos))
+            n = BigInt::parseDigits(text, pos, pos);
+        else if (!(pos < text.size() && text[pos] == '.' && digitAt(pos + 1)))
+            throw std::invalid_argument("Rational: expected a number");
+        if (pos < text.size() && text[pos] == '.' && digitAt(pos + 1)) {
+            size_t start = pos + 1;
+            BigInt fraction = BigInt::parseDigits(text, start, pos);
+            for (size_t i = start; i < pos; ++i) {
+                n *= BigInt(10);
+                scale *= BigInt(10);
+            }
+            n += fraction;
+        }
+        if (pos < text.size() && text[pos] == '/') {
+            scale *= BigInt::parseDigits(text, pos + 1, pos);
+            if (scale.isZero())
+                throw std::domain_error("Rational: zero denominator");
+        }
+        end = pos;
+        return Rational(std::move(n), std::move(scale));
+    }
+
+    const BigInt& numerator() const { return num; }
+    const BigInt& denominator() const { return den; }
+    bool isZero() const { return num.isZero(); }
+    bool isNegative() const { return num.isNegative(); }
+    bool isInteger() const { return den == BigInt(1); }
+    double toDouble() const { return num.toDouble() / den.toDouble(); }
+
+    uint64_t hash() const { return num.hash() * 1099511628211ull ^ den.hash(); }
+
+    Rational operator-() const {
+        Rational r = *this;
+        r.num = -r.num;
+        return r;
+    }
+
+    Rational& operator+=(const Rational& o) {
+        if (o.num.isZero())
+            return *this;
+        if (den == o.den) {
+            num += o.num;
+        }
+        else {
+            num = num * o.den + o.num * den;
+            den *= o.den;
+        }
+        normalize();
+        return *this;
+    }
+    Rational& operator-=(const Rational& o) { return *this += -o; }
+    Rational& operator*=(const Rational& o) {
+        num *= o.num;
+        den *= o.den;
+        normalize();
+        return *this;
+    }
+    Rational& operator/=(const Rational& o) {
+        if (o.num.isZero())
+            throw std::domain_error("Rational: division by zero");
+        num *= o.den;
+        den *= o.num;
+        normalize();
+        return *this;
+    }
+
+    friend Rational operator+(Rational a, const Rational& b) { return a += b; }
+    friend Rational operator-(Rational a, const Rational& b) { return a -= b; }
+    friend Rational operator*(Rational a, const Rational& b) { return a *= b; }
+    friend Rational operator/(Rational a, const Rational& b) { return a /= b; }
+
+    friend bool operator==(const Rational& a, const Rational& b) { return a.num == b.num && a.den == b.den; }
+    friend bool operator!=(const Rational& a, const Rational& b) { return !(a == b); }
+    friend bool operator<(const Rational& a, const Rational& b) { return a.num * b.den < b.num * a.den; }
+
+    friend std::ostream& operator<<(std::ostream& os, const Rational& r) {
+        os << r.num;
+        if (!r.isInteger())
+            os << '/' << r.den;
+        return os;
+    }
+
+private:
+    BigInt num;
+    BigInt den;
+
+    void normalize() {
+        if (num.isZero()) {
+            den = BigInt(1);
+            return;
+        }
+        if (den.isNegative()) {
+            num = -num;
+            den = -den;
+        }
+        if (isInteger())
+            return;
+        BigInt g = BigInt::gcd(num, den);
+        if (g != BigInt(1)) {
+            num /= g;
+            den /= g;
+        }
+    }
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of workers with one task deque each. A worker pops its own
+// deque LIFO (the task it just spawned is likely hot in cache) and, when it
+// runs dry, steals the oldest task from another worker. Tasks submitted from
+// outside the pool are spread round-robin.
+class TaskScheduler {
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct Worker {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> pending{ 0 };
+    std::atomic<size_t> nextQueue{ 0 };
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    static int& currentIndex() {
+        thread_local int index = -1;
+        return index;
+    }
+
+    static const TaskScheduler*& currentPool() {
+        thread_local const TaskScheduler* pool = nullptr;
+        return pool;
+    }
+
+    bool popLocal(size_t self, Task& out) {
+        Worker& w = *workers[self];
+        std::lock_guard<std::mutex> guard(w.lock);
+        if (w.tasks.empty())
+            return false;
+        out = std::move(w.tasks.back());
+        w.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t self, Task& out) {
+        for (size_t k = 1; k < workers.size(); ++k) {
+            Worker& victim = *workers[(self + k) % workers.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                out = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(size_t self) {
+        currentIndex() = static_cast<int>(self);
+        currentPool() = this;
+        for (;;) {
+            Task task;
+            if (popLocal(self, task) || steal(self, task)) {
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                try {
+                    task();
+                }
+                catch (...) {
+                    // Tasks report their own failures; a throwing task must
+                    // not take the worker down with it.
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> guard(sleepLock);
+            wake.wait(guard, [this] { return stopping || pending.load() > 0; });
+            if (stopping && pending.load() == 0)
+                return;
+        }
+    }
+
+public:
+    explicit TaskScheduler(unsigned threadCount = std::thread::hardware_concurrency()) {
+        if (threadCount == 0)
+            threadCount = 1;
+        for (unsigned i = 0; i < threadCount; ++i)
+            workers.push_back(std::make_unique<Worker>());
+        threads.reserve(threadCount);
+        for (unsigned i = 0; i < threadCount; ++i)
+            threads.emplace_back(&TaskScheduler::run, this, i);
+    }
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // Runs every task already submitted, then joins the workers.
+    ~TaskScheduler() {
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads)
+            t.join();
+    }
+
+    // From a worker of this pool the task goes to that worker's own deque.
+    void submit(Task task) {
+        size_t target = workerIndex() >= 0
+            ? static_cast<size_t>(workerIndex())
+            : nextQueue.fetch_add(1, std::memory_order_relaxed) % workers.size();
+        pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> guard(workers[target]->lock);
+            workers[target]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+        }
+        wake.notify_one();
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // Index of the calling worker in this pool, or -1 on any other thread.
+    int workerIndex() const {
+        return currentPool() == this ? currentIndex() : -1;
+    }
+};
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <stdexcept>
+#include "polinom.h"
+
+// Binary layout of one polynomial:
+//   tag byte (CoeffEncoding), [quantum: 8 bytes if Quantized], varint term count,
+//   then per term: varint degree (first term) or varint delta to the previous
+//   degree (degrees are strictly decreasing), followed by the coefficient.
+//   Quantized coefficients that do not fit fall back to a raw double per term.
+enum class CoeffEncoding : uint8_t {
+    Double = 0,     // raw IEEE-754 binary64, lossless
+    Float = 1,      // IEEE-754 binary32
+    Quantized = 2   // zigzag varint of round(coeff / quantum)
+};
+
+// A Quantized term whose scaled coefficient is NaN, infinite or outside the
+// int64 range is written as this zigzag value followed by the raw double.
+// llround never yields it for in-range input, so it cannot be ambiguous.
+constexpr int64_t kQuantizedEscape = std::numeric_limits<int64_t>::min();
+
+struct SerializeOptions {
+    CoeffEncoding encoding = CoeffEncoding::Double;
+    double quantum = 1e-6;
+};
+
+class ByteWriter {
+private:
+    std::vector<uint8_t>& out;
+
+public:
+    explicit ByteWriter(std::vector<uint8_t>& buffer) : out(buffer) {}
+
+    void putByte(uint8_t b) { out.push_back(b); }
+
+    void putVarint(uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    void putZigzag(int64_t v) {
+        putVarint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+    }
+
+    void putFixed64(uint64_t v) {
+        for (int i = 0; i < 8; ++i)
+            out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+
+    void putFixed32(uint32_t v) {
+        for (int i = 0; i < 4; ++i)
+            out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+
+    void putDouble(double d) {
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        putFixed64(bits);
+    }
+
+    void putFloat(float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        putFixed32(bits);
+    }
+
+    size_t size() const { return out.size(); }
+};
+
+class ByteReader {
+private:
+    const uint8_t* data;
+    size_t length;
+    size_t pos = 0;
+
+    void require(size_t n) const {
+        if (length - pos < n)
+            throw std::runtime_error("Truncated polinom buffer");
+    }
+
+public:
+    ByteReader(const uint8_t* bytes, size_t size) : data(bytes), length(size) {}
+    explicit ByteReader(const std::vector<uint8_t>& buffer) : data(buffer.data()), length(buffer.size()) {}
+
+    uint8_t getByte() {
+        require(1);
+        return data[pos++];
+    }
+
+    uint64_t getVarint() {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = getByte();
+            result |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                return result;
+        }
+        throw std::runtime_error("Malformed varint in polinom buffer");
+    }
+
+    int64_t getZigzag() {
+        uint64_t v = getVarint();
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    uint64_t getFixed64() {
+        require(8);
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i)
+            v |= static_cast<uint64_t>(data[pos + i]) << (8 * i);
+        pos += 8;
+        return v;
+    }
+
+    uint32_t getFixed32() {
+        require(4);
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i)
+            v |= static_cast<uint32_t>(data[pos + i]) << (8 * i);
+        pos += 4;
+        return v;
+    }
+
+    double getDouble() {
+        uint64_t bits = getFixed64();
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+        return d;
+    }
+
+    float getFloat() {
+        uint32_t bits = getFixed32();
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    void skip(size_t n) {
+        require(n);
+        pos += n;
+    }
+
+    bool atEnd() const { return pos == length; }
+    size_t position() const { return pos; }
+    size_t remaining() const { return length - pos; }
+};
+
+// Appends any number of polynomials to one buffer.
+class PolinomEncoder {
+private:
+    ByteWriter writer;
+    SerializeOptions options;
+
+public:
+    explicit PolinomEncoder(std::vector<uint8_t>& out, SerializeOptions opts = SerializeOptions())
+        : writer(out), options(opts) {
+        if (options.encoding == CoeffEncoding::Quantized &&
+            !(options.quantum > 0.0 && std::isfinite(options.quantum)))
+            throw std::invalid_argument("Quantum must be positive and finite");
+    }
+
+    void write(const Polinom& p) {
+        const auto& monoms = p.getMonoms();
+        writer.putByte(static_cast<uint8_t>(options.encoding));
+        if (options.encoding == CoeffEncoding::Quantized)
+            writer.putDouble(options.quantum);
+        writer.putVarint(monoms.size());
+        int prev = 0;
+        for (size_t i = 0; i < monoms.size(); ++i) {
+            const Monom& m = monoms[i];
+            writer.putVarint(static_cast<uint64_t>(i == 0 ? m.degree : prev - m.degree));
+            prev = m.degree;
+            switch (options.encoding) {
+            case CoeffEncoding::Double:
+                writer.putDouble(m.coeff);
+                break;
+            case CoeffEncoding::Float:
+                writer.putFloat(static_cast<float>(m.coeff));
+                break;
+            case CoeffEncoding::Quantized:
+                putQuantized(m.coeff);
+                break;
+            }
+        }
+    }
+
+private:
+    void putQuantized(double coeff) {
+        // 2^63 is exact in a double; the strict bounds keep llround defined
+        // and away from kQuantizedEscape. NaN fails both comparisons.
+        const double limit = 9223372036854775808.0;
+        double scaled = coeff / options.quantum;
+        if (scaled > -limit && scaled < limit) {
+            writer.putZigzag(std::llround(scaled));
+            return;
+        }
+        writer.putZigzag(kQuantizedEscape);
+        writer.putDouble(coeff);
+    }
+};
+
+// Reads polynomials back one at a time from a buffer produced by PolinomEncoder.
+class PolinomDecoder {
+private:
+    ByteReader reader;
+
+public:
+    PolinomDecoder(const uint8_t* data, size_t size) : reader(data, size) {}
+    explicit PolinomDecoder(const std::vector<uint8_t>& buffer) : reader(buffer) {}
+
+    bool done() const { return reader.atEnd(); }
+    size_t position() const { return reader.position(); }
+
+    Polinom read(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        uint8_t tag = reader.getByte();
+        if (tag > static_cast<uint8_t>(CoeffEncoding::Quantized))
+            throw std::runtime_error("Unknown coefficient encoding in polinom buffer");
+        CoeffEncoding encoding = static_cast<CoeffEncoding>(tag);
+        double quantum = 0.0;
+        if (encoding == CoeffEncoding::Quantized) {
+            quantum = reader.getDouble();
+            if (!(quantum > 0.0 && std::isfinite(quantum)))
+                throw std::runtime_error("Invalid quantum in polinom buffer");
+        }
+
+        uint64_t count = reader.getVarint();
+        if (count > reader.remaining())
+            throw std::runtime_error("Truncated polinom buffer");
+        Polinom::Terms monoms(resource);
+        monoms.reserve(static_cast<size_t>(count));
+        int64_t degree = 0;
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t key = reader.getVarint();
+            if (i == 0) {
+                degree = static_cast<int64_t>(key);
+            }
+            else {
+                if (key == 0)
+                    throw std::runtime_error("Polinom terms are not strictly ordered");
+                degree -= static_cast<int64_t>(key);
+            }
+            if (degree < 0 || degree > 999)
+                throw std::runtime_error("Degree out of range in polinom buffer");
+
+            double coeff = 0.0;
+            switch (encoding) {
+            case CoeffEncoding::Double:
+                coeff = reader.getDouble();
+                break;
+            case CoeffEncoding::Float:
+                coeff = reader.getFloat();
+                break;
+            case CoeffEncoding::Quantized: {
+                int64_t q = reader.getZigzag();
+                coeff = q == kQuantizedEscape ? reader.getDouble() : static_cast<double>(q) * quantum;
+                break;
+            }
+            }
+            monoms.emplace_back(static_cast<int>(degree), coeff);
+        }
+        return Polinom(std::move(monoms));
+    }
+};
+
+inline void serialize(const Polinom& p, std::vector<uint8_t>& out, SerializeOptions options = SerializeOptions()) {
+    PolinomEncoder(out, options).write(p);
+}
+
+inline std::vector<uint8_t> serialize(const Polinom& p, SerializeOptions options = SerializeOptions()) {
+    std::vector<uint8_t> out;
+    serialize(p, out, options);
+    return out;
+}
+
+inline Polinom deserialize(const std::vector<uint8_t>& buffer) {
+    PolinomDecoder decoder(buffer);
+    Polinom p = decoder.read();
+    if (!decoder.done())
+        throw std::runtime_error("Trailing bytes after polinom");
+    return p;
+}
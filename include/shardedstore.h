@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "polinom.h"
+
+// Named polynomials for write-heavy phases. Keys are spread over a power of
+// two number of shards, each an unordered_map behind its own mutex, so
+// writers to different shards run in parallel. Critical sections are a
+// single hash lookup, too short for a shared_mutex to pay for itself.
+//
+// Every single-key operation holds exactly one shard lock, so those
+// operations are linearizable. size() and forEach() lock the shards one
+// after another and are not an atomic view of the whole table. Use
+// PolinomStore when writes are rare and reads must never wait.
+class ShardedPolinomStore {
+private:
+    struct alignas(64) Shard {
+        mutable std::mutex lock;
+        std::unordered_map<std::string, Polinom> table;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t mask;
+
+    static size_t roundUpToPowerOfTwo(size_t n) {
+        size_t p = 1;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+    // The maps bucket on the low bits of the same hash, so pick the shard
+    // from the high bits.
+    Shard& shardFor(const std::string& name) const {
+        size_t h = std::hash<std::string>()(name);
+        h ^= h >> 32;
+        h *= 0x9e3779b97f4a7c15ull;
+        return *shards[(h >> 40) & mask];
+    }
+
+public:
+    explicit ShardedPolinomStore(size_t shardCount = 4 * std::max(1u, std::thread::hardware_concurrency())) {
+        shardCount = roundUpToPowerOfTwo(std::max<size_t>(1, shardCount));
+        mask = shardCount - 1;
+        for (size_t i = 0; i < shardCount; ++i)
+            shards.push_back(std::make_unique<Shard>());
+    }
+
+    ShardedPolinomStore(const ShardedPolinomStore&) = delete;
+    ShardedPolinomStore& operator=(const ShardedPolinomStore&) = delete;
+
+    size_t shardCount() const { return shards.size(); }
+
+    // Calls fn(const Polinom&) under the shard's lock. fn must not
+    // write to this store.
+    template<typename Fn>
+    bool read(const std::string& name, Fn&& fn) const {
+        POLINOM_METRIC_TIME(StoreLookup);
+        POLINOM_METRIC_ADD(StoreLookups, 1);
+        POLINOM_TRACE_SPAN("store_lookup");
+        Shard& s = shardFor(name);
+        std::lock_guard<std::mutex> guard(s.lock);
+        auto it = s.table.find(name);
+        if (it == s.table.end()) {
+            POLINOM_METRIC_ADD(StoreMisses, 1);
+            return false;
+        }
+        POLINOM_METRIC_ADD(StoreHits, 1);
+        fn(it->second);
+        return true;
+    }
+
+    std::optional<Polinom> find(const std::string& name) const {
+        std::optional<Polinom> result;
+        read(name, [&](const Polinom& p) { result.emplace(p); });
+        return result;
+    }
+
+    bool contains(const std::string& name) const {
+        return read(name, [](const Polinom&) {});
+    }
+
+    // Returns true if the name was new.
+    bool insertOrAssign(const std::string& name, const Polinom& value) {
+        POLINOM_METRIC_TIME(StoreWrite);
+        POLINOM_METRIC_ADD(StoreInserts, 1);
+        POLINOM_ALLOC_SCOPE(StoreInsert);
+        Polinom owned(value, std::pmr::get_default_resource());
+        Shard& s = shardFor(name);
+        std::lock_guard<std::mutex> guard(s.lock);
+        return s.table.insert_or_assign(name, std::move(owned)).second;
+    }
+
+    // Inserts only if the name is absent; returns true if it inserted.
+    bool insert(const std::string& name, const Polinom& value) {
+        POLINOM_METRIC_TIME(StoreWrite);
+        POLINOM_METRIC_ADD(StoreInserts, 1);
+        POLINOM_ALLOC_SCOPE(StoreInsert);
+        Polinom owned(value, std::pmr::get_default_resource());
+        Shard& s = shardFor(name);
+        std::lock_guard<std::mutex> guard(s.lock);
+        return s.table.emplace(name, std::move(owned)).second;
+    }
+
+    // Atomically replaces the value with fn(old). fn receives nullptr when
+    // the name is absent and must not touch this store.
+    template<typename Fn>
+    void update(const std::string& name, Fn&& fn) {
+        POLINOM_METRIC_TIME(StoreWrite);
+        POLINOM_ALLOC_SCOPE(StoreInsert);
+        Shard& s = shardFor(name);
+        std::lock_guard<std::mutex> guard(s.lock);
+        auto it = s.table.find(name);
+        if (it == s.table.end())
+            s.table.emplace(name, Polinom(fn(static_cast<const Polinom*>(nullptr)), std::pmr::get_default_resource()));
+        else
+            it->second = Polinom(fn(static_cast<const Polinom*>(&it->second)), std::pmr::get_default_resource());
+    }
+
+    bool erase(const std::string& name) {
+        POLINOM_METRIC_TIME(StoreWrite);
+        POLINOM_METRIC_ADD(StoreErases, 1);
+        Shard& s = shardFor(name);
+        std::lock_guard<std::mutex> guard(s.lock);
+        return s.table.erase(name) > 0;
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& s : shards) {
+            std::lock_guard<std::mutex> guard(s->lock);
+            total += s->table.size();
+        }
+        return total;
+    }
+
+    void forEach(const std::function<void(const std::string&, const Polinom&)>& fn) const {
+        for (const auto& s : shards) {
+            std::lock_guard<std::mutex> guard(s->lock);
+            for (const auto& entry : s->table)
+                fn(entry.first, entry.second);
+        }
+    }
+
+    void clear() {
+        for (auto& s : shards) {
+            std::lock_guard<std::mutex> guard(s->lock);
+            s->table.clear();
+        }
+    }
+};
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "metrics.h"
+
+// Contiguous vector that keeps up to N elements inside the object and spills
+// to a std::pmr::memory_resource beyond that. Restricted to trivially
+// copyable T so that growth and moves are plain memcpy.
+//
+// Spilled elements live in a reference-counted block. Copying onto the same
+// resource shares the block in O(1); any non-const access clones it first
+// (copy-on-write), so sharing is never observable. Reference counts are
+// atomic, so copies may be handed to other threads.
+//
+// Allocator semantics follow std::pmr::vector: copies are made on the
+// default resource, moves keep the source resource, assignment keeps the
+// destination resource.
+template<typename T, size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector requires a trivially copyable type");
+    static_assert(N > 0, "SmallVector inline capacity must be positive");
+
+private:
+    struct Block {
+        std::atomic<size_t> refs;
+    };
+
+    static constexpr size_t kAlign = alignof(Block) > alignof(T) ? alignof(Block) : alignof(T);
+    static constexpr size_t kHeader = (sizeof(Block) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+    T* ptr;
+    Block* block = nullptr;
+    // Set once the block has been handed to another SmallVector. Until then
+    // the block is known to be unique and is never read, so a block from a
+    // released arena can still be destroyed safely.
+    mutable std::atomic<bool> mayShare{ false };
+    size_t count = 0;
+    size_t cap = N;
+    std::pmr::memory_resource* res;
+    alignas(T) unsigned char inlineStorage[N * sizeof(T)];
+
+    T* inlineData() { return reinterpret_cast<T*>(inlineStorage); }
+    const T* inlineData() const { return reinterpret_cast<const T*>(inlineStorage); }
+
+    static T* elements(Block* b) {
+        return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(b) + kHeader);
+    }
+
+    // Moves the elements into a fresh unshared block of newCap elements.
+    void reallocate(size_t newCap) {
+        void* raw = res->allocate(kHeader + newCap * sizeof(T), kAlign);
+        POLINOM_METRIC_ADD(TermAllocations, 1);
+        POLINOM_METRIC_ADD(TermBytesAllocated, kHeader + newCap * sizeof(T));
+        Block* fresh = new (raw) Block{ {1} };
+        if (count)
+            std::memcpy(static_cast<void*>(elements(fresh)), ptr, count * sizeof(T));
+        release();
+        block = fresh;
+        ptr = elements(fresh);
+        cap = newCap;
+    }
+
+    void grow(size_t needed) {
+        reallocate(std::max(needed, cap * 2));
+    }
+
+    void release() {
+        if (block && (!mayShare.load(std::memory_order_relaxed)
+            || block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)) {
+            res->deallocate(block, kHeader + cap * sizeof(T), kAlign);
+        }
+        block = nullptr;
+        mayShare.store(false, std::memory_order_relaxed);
+        ptr = inlineData();
+        cap = N;
+    }
+
+    void makeUnique() {
+        if (isShared())
+            reallocate(cap);
+    }
+
+    void shareFrom(const SmallVector& other) {
+        other.block->refs.fetch_add(1, std::memory_order_relaxed);
+        other.mayShare.store(true, std::memory_order_relaxed);
+        mayShare.store(true, std::memory_order_relaxed);
+        block = other.block;
+        ptr = other.ptr;
+        cap = other.cap;
+        count = other.count;
+    }
+
+    bool canShare(const SmallVector& other) const {
+        return other.block && (res == other.res || *res == *other.res);
+    }
+
+    void stealFrom(SmallVector& other) {
+        if (other.block) {
+            block = other.block;
+            ptr = other.ptr;
+            cap = other.cap;
+            mayShare.store(other.mayShare.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            other.mayShare.store(false, std::memory_order_relaxed);
+            other.block = nullptr;
+            other.ptr = other.inlineData();
+            other.cap = N;
+        }
+        else {
+            ptr = inlineData();
+            cap = N;
+            if (other.count)
+                std::memcpy(static_cast<void*>(ptr), other.ptr, other.count * sizeof(T));
+        }
+        count = other.count;
+        other.count = 0;
+    }
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    explicit SmallVector(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : ptr(inlineData()), res(resource) {}
+
+    SmallVector(const SmallVector& other, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : ptr(inlineData()), res(resource) {
+        if (canShare(other))
+            shareFrom(other);
+        else
+            assign(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector&& other) noexcept : ptr(inlineData()), res(other.res) {
+        stealFrom(other);
+    }
+
+    ~SmallVector() { release(); }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this == &other)
+            return *this;
+        if (canShare(other)) {
+            release();
+            shareFrom(other);
+        }
+        else {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) {
+        if (this == &other)
+            return *this;
+        if (res == other.res || *res == *other.res) {
+            release();
+            stealFrom(other);
+        }
+        else {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    template<typename It>
+    void assign(It first, It last) {
+        clear();
+        size_t n = static_cast<size_t>(std::distance(first, last));
+        reserve(n);
+        std::copy(first, last, ptr);
+        count = n;
+    }
+
+    std::pmr::memory_resource* resource() const { return res; }
+    bool isInline() const { return block == nullptr; }
+    bool isShared() const {
+        return block && mayShare.load(std::memory_order_relaxed)
+            && block->refs.load(std::memory_order_acquire) > 1;
+    }
+    static constexpr size_t inlineCapacity() { return N; }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+    bool empty() const { return count == 0; }
+
+    const T* data() const { return ptr; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+    const T& front() const { return ptr[0]; }
+    const T& back() const { return ptr[count - 1]; }
+
+    const T& at(size_t i) const {
+        if (i >= count)
+            throw std::out_of_range("SmallVector index out of range");
+        return ptr[i];
+    }
+
+    // Non-const access detaches shared storage first.
+    T* data() { makeUnique(); return ptr; }
+    T* begin() { makeUnique(); return ptr; }
+    T* end() { makeUnique(); return ptr + count; }
+    T& operator[](size_t i) { makeUnique(); return ptr[i]; }
+    T& front() { makeUnique(); return ptr[0]; }
+    T& back() { makeUnique(); return ptr[count - 1]; }
+
+    T& at(size_t i) {
+        if (i >= count)
+            throw std::out_of_range("SmallVector index out of range");
+        makeUnique();
+        return ptr[i];
+    }
+
+    void reserve(size_t n) {
+        if (n > cap)
+            grow(n);
+    }
+
+    void push_back(const T& value) {
+        if (count == cap) {
+            T copy = value;
+            grow(count + 1);
+            ptr[count++] = copy;
+            return;
+        }
+        makeUnique();
+        ptr[count++] = value;
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        T value(std::forward<Args>(args)...);
+        push_back(value);
+        return back();
+    }
+
+    void pop_back() {
+        makeUnique();
+        --count;
+    }
+
+    void resize(size_t n) {
+        reserve(n);
+        makeUnique();
+        for (size_t i = count; i < n; ++i)
+            ptr[i] = T();
+        count = n;
+    }
+
+    void clear() {
+        if (isShared())
+            release();
+        count = 0;
+    }
+};
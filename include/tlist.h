@@ -1,47 +1,237 @@
 ﻿#include <iostream>
 #include <stdexcept>
+#include <cstddef>
 #include <deque>
-
-
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <vector>
+#include "nodepool.h"
+
+
+// Unrolled linked list: each node holds up to kNodeCapacity elements in
+// place (about four cache lines' worth), so a scan touches one allocation
+// per block of elements instead of one per element.
+//
+// Nodes are doubly linked for iteration. A directory of node pointers in
+// list order, with a Fenwick tree over their element counts, finds the node
+// holding any index in O(log n). operator[], insert and erase by position
+// therefore cost O(log n + kNodeCapacity). When a node splits or disappears
+// the directory and Fenwick tree are rebuilt in O(n / kNodeCapacity); that
+// happens at most once per kNodeCapacity / 2 inserts or erases into a node.
+// Adding or dropping the last node only touches the Fenwick tail.
+//
+// Nodes come from a per-list NodePool, and clear() returns its chunks in
+// one go after destroying the elements.
 template<typename T>
 class List {
+    static constexpr size_t kNodeBytes = 256;
+    static constexpr size_t kNodeCapacity = kNodeBytes / sizeof(T) > 8 ? kNodeBytes / sizeof(T) : 8;
+
     struct Node {
-        T data;
-        Node* next;
+        Node* prev = nullptr;
+        Node* next = nullptr;
+        size_t count = 0;
+        alignas(T) unsigned char storage[sizeof(T) * kNodeCapacity];
+
+        T* slot(size_t i) {
+            return std::launder(reinterpret_cast<T*>(storage + i * sizeof(T)));
+        }
+        T& at(size_t i) {
+            return *slot(i);
+        }
+
+        // Opens a gap at `offset` (count < kNodeCapacity) and constructs
+        // the element there.
+        template<typename... Args>
+        T& emplaceAt(size_t offset, Args&&... args) {
+            if (offset == count) {
+                new (storage + count * sizeof(T)) T(std::forward<Args>(args)...);
+            }
+            else {
+                T value(std::forward<Args>(args)...);
+                new (storage + count * sizeof(T)) T(std::move(at(count - 1)));
+                for (size_t i = count - 1; i > offset; --i)
+                    at(i) = std::move(at(i - 1));
+                at(offset) = std::move(value);
+            }
+            ++count;
+            return at(offset);
+        }
+
+        void eraseAt(size_t offset) {
+            for (size_t i = offset; i + 1 < count; ++i)
+                at(i) = std::move(at(i + 1));
+            slot(count - 1)->~T();
+            --count;
+        }
+
+        // Moves elements [from, count) to the front of the empty node `to`.
+        void moveTail(size_t from, Node* to) {
+            for (size_t i = from; i < count; ++i) {
+                new (to->storage + (i - from) * sizeof(T)) T(std::move(at(i)));
+                slot(i)->~T();
+            }
+            to->count = count - from;
+            count = from;
+        }
 
-        Node(T val) : data(val), next(nullptr) {}
+        // Moves every element of `other` to the end of this node.
+        void absorb(Node* other) {
+            for (size_t i = 0; i < other->count; ++i) {
+                new (storage + count * sizeof(T)) T(std::move(other->at(i)));
+                ++count;
+            }
+        }
+
+        ~Node() {
+            for (size_t i = 0; i < count; ++i)
+                slot(i)->~T();
+        }
     };
 
 private:
-    Node* head;
-    Node* tail;
+    TypedNodePool<Node> pool{ 4 };
+    std::vector<Node*> nodes;      // in list order
+    std::vector<size_t> fenwick;   // 1-based over nodes[i]->count
     size_t list_size;
 
-    Node* get_node(size_t index) const {
+    void fenwickAdd(size_t index, size_t delta) {
+        for (size_t i = index + 1; i < fenwick.size(); i += i & (0 - i))
+            fenwick[i] += delta;
+    }
+
+    void rebuildIndex() {
+        fenwick.assign(nodes.size() + 1, 0);
+        for (size_t i = 1; i <= nodes.size(); ++i) {
+            fenwick[i] += nodes[i - 1]->count;
+            size_t parent = i + (i & (0 - i));
+            if (parent <= nodes.size())
+                fenwick[parent] += fenwick[i];
+        }
+    }
+
+    // Index of the node holding element `index` and the offset inside it.
+    std::pair<size_t, size_t> locate(size_t index) const {
+        size_t pos = 0;
+        size_t step = 1;
+        while (step * 2 <= nodes.size())
+            step *= 2;
+        for (; step > 0; step /= 2) {
+            if (pos + step <= nodes.size() && fenwick[pos + step] <= index) {
+                pos += step;
+                index -= fenwick[pos];
+            }
+        }
+        return { pos, index };
+    }
+
+    Node* get_node(size_t index, size_t& offset) const {
         if (index >= list_size) {
             throw std::out_of_range("Index out of range");
         }
-        Node* current = head;
-        for (size_t i = 0; i < index; ++i) {
-            current = current->next;
+        auto [n, off] = locate(index);
+        offset = off;
+        return nodes[n];
+    }
+
+    // Inserts a fresh empty node into the chain and the directory at `at`.
+    Node* insertNode(size_t at) {
+        Node* node = pool.create();
+        node->prev = at > 0 ? nodes[at - 1] : nullptr;
+        node->next = at < nodes.size() ? nodes[at] : nullptr;
+        if (node->prev) node->prev->next = node;
+        if (node->next) node->next->prev = node;
+        nodes.insert(nodes.begin() + at, node);
+        return node;
+    }
+
+    void removeNode(size_t at) {
+        Node* node = nodes[at];
+        if (node->prev) node->prev->next = node->next;
+        if (node->next) node->next->prev = node->prev;
+        nodes.erase(nodes.begin() + at);
+        pool.destroy(node);
+    }
+
+    // Appends an empty node, extending the Fenwick tree in O(log n).
+    Node* pushNode() {
+        Node* node = insertNode(nodes.size());
+        size_t i = nodes.size();
+        size_t low = i & (0 - i);
+        size_t sum = 0;
+        for (size_t j = i - 1; j > i - low; j -= j & (0 - j))
+            sum += fenwick[j];
+        fenwick.push_back(sum);
+        return node;
+    }
+
+    template<typename... Args>
+    T& emplaceBack(Args&&... args) {
+        if (nodes.empty() || nodes.back()->count == kNodeCapacity)
+            pushNode();
+        Node* node = nodes.back();
+        try {
+            T& item = node->emplaceAt(node->count, std::forward<Args>(args)...);
+            fenwickAdd(nodes.size() - 1, 1);
+            ++list_size;
+            return item;
+        }
+        catch (...) {
+            if (node->count == 0) {
+                removeNode(nodes.size() - 1);
+                fenwick.pop_back();
+            }
+            throw;
         }
-        return current;
+    }
+
+    template<typename... Args>
+    T& emplaceAtIndex(size_t index, Args&&... args) {
+        if (index == list_size) {
+            return emplaceBack(std::forward<Args>(args)...);
+        }
+        auto [n, offset] = locate(index);
+        if (nodes[n]->count < kNodeCapacity) {
+            T& item = nodes[n]->emplaceAt(offset, std::forward<Args>(args)...);
+            fenwickAdd(n, 1);
+            ++list_size;
+            return item;
+        }
+        // Build the element before splitting: args may refer into the node.
+        T value(std::forward<Args>(args)...);
+        Node* upper = insertNode(n + 1);
+        nodes[n]->moveTail(kNodeCapacity / 2, upper);
+        rebuildIndex();
+        if (offset > nodes[n]->count) {
+            offset -= nodes[n]->count;
+            ++n;
+        }
+        T& item = nodes[n]->emplaceAt(offset, std::move(value));
+        fenwickAdd(n, 1);
+        ++list_size;
+        return item;
+    }
+
+    Node* front() const {
+        return nodes.empty() ? nullptr : nodes.front();
     }
 
     void clear() {
-        while (head != nullptr) {
-            Node* temp = head;
-            head = head->next;
-            delete temp;
-        }
-        head = tail = nullptr;
+        for (Node* node : nodes)
+            node->~Node();
+        pool.release();
+        nodes.clear();
+        fenwick.assign(1, 0);
         list_size = 0;
     }
 
 public:
-    List() : head(nullptr), tail(nullptr), list_size(0) {}
+    List() : fenwick(1, 0), list_size(0) {}
 
-    List(int n, T val = T()) : head(nullptr), tail(nullptr), list_size(0) {
+    List(int n, T val = T()) : fenwick(1, 0), list_size(0) {
         if (n < 0) {
             throw std::invalid_argument("List size cannot be negative");
         }
@@ -54,12 +244,10 @@ public:
         clear();
     }
 
-    List(const List& other) : head(nullptr), tail(nullptr), list_size(0) {
-        Node* current = other.head;
-        while (current != nullptr) {
-            append(current->data);
-            current = current->next;
-        }
+    List(const List& other) : fenwick(1, 0), list_size(0) {
+        for (Node* node = other.front(); node != nullptr; node = node->next)
+            for (size_t i = 0; i < node->count; ++i)
+                append(node->at(i));
     }
 
     List& operator=(const List& other) {
@@ -69,146 +257,180 @@ public:
 
         clear();
 
-        Node* current = other.head;
-        while (current != nullptr) {
-            append(current->data);
-            current = current->next;
-        }
+        for (Node* node = other.front(); node != nullptr; node = node->next)
+            for (size_t i = 0; i < node->count; ++i)
+                append(node->at(i));
 
         return *this;
     }
 
-    void append(T val) {
-        Node* new_node = new Node(val);
-        if (head == nullptr) {
-            head = tail = new_node;
+    // Takes over the nodes and their pool; `other` is left empty.
+    List(List&& other) noexcept : fenwick(1, 0), list_size(0) {
+        swap(other);
+    }
+
+    List& operator=(List&& other) noexcept {
+        if (this != &other) {
+            clear();
+            swap(other);
         }
-        else {
-            tail->next = new_node;
-            tail = new_node;
+        return *this;
+    }
+
+    void swap(List& other) noexcept {
+        pool.swap(other.pool);
+        nodes.swap(other.nodes);
+        fenwick.swap(other.fenwick);
+        std::swap(list_size, other.list_size);
+    }
+
+    void append(const T& val) {
+        emplaceBack(val);
+    }
+
+    void append(T&& val) {
+        emplaceBack(std::move(val));
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        return emplaceBack(std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    T& emplace_front(Args&&... args) {
+        return emplaceAtIndex(0, std::forward<Args>(args)...);
+    }
+
+    // Constructs the element in place before position `index`.
+    template<typename... Args>
+    T& emplace(size_t index, Args&&... args) {
+        if (index > list_size) {
+            throw std::out_of_range("Index out of range");
         }
-        ++list_size;
+        return emplaceAtIndex(index, std::forward<Args>(args)...);
     }
 
     T& operator[](size_t index) {
-        return get_node(index)->data;
+        size_t offset;
+        Node* node = get_node(index, offset);
+        return node->at(offset);
     }
 
     const T& operator[](size_t index) const {
-        return get_node(index)->data;
+        size_t offset;
+        Node* node = get_node(index, offset);
+        return node->at(offset);
     }
 
     size_t size() const {
         return list_size;
     }
 
-    void insert(T val, size_t index) {
-        if (index > list_size) {
-            throw std::out_of_range("Index out of range");
-        }
-        if (index == 0) {
-            insert_front(val);
-            return;
-        }
-        if (index == list_size) {
-            append(val);
-            return;
-        }
-        Node* prev = get_node(index - 1);
-        Node* new_node = new Node(val);
-        new_node->next = prev->next;
-        prev->next = new_node;
-        ++list_size;
+    void insert(const T& val, size_t index) {
+        emplace(index, val);
     }
 
-    void insert_front(T val) {
-        Node* new_node = new Node(val);
-        if (head == nullptr) {
-            head = tail = new_node;
-        }
-        else {
-            new_node->next = head;
-            head = new_node;
-        }
-        ++list_size;
+    void insert(T&& val, size_t index) {
+        emplace(index, std::move(val));
+    }
+
+    void insert_front(const T& val) {
+        emplaceAtIndex(0, val);
+    }
+
+    void insert_front(T&& val) {
+        emplaceAtIndex(0, std::move(val));
     }
 
     void erase(size_t index) {
         if (index >= list_size) {
             throw std::out_of_range("Index out of range");
         }
-        if (index == 0) {
-            erase_front();
-            return;
-        }
-        Node* prev = get_node(index - 1);
-        Node* to_delete = prev->next;
-        prev->next = to_delete->next;
-        if (to_delete == tail) {
-            tail = prev;
-        }
-        delete to_delete;
+        auto [n, offset] = locate(index);
+        Node* node = nodes[n];
+        node->eraseAt(offset);
         --list_size;
-
-        if (list_size == 0) {
-            head = tail = nullptr;
+        if (node->count == 0) {
+            removeNode(n);
+            // Dropping the last node undoes pushNode(), so alternating
+            // append and erase at a node boundary never rebuilds.
+            if (n == nodes.size())
+                fenwick.pop_back();
+            else
+                rebuildIndex();
+        }
+        else if (node->next && node->count + node->next->count <= kNodeCapacity / 2) {
+            size_t moved = node->next->count;
+            node->absorb(node->next);
+            removeNode(n + 1);
+            if (n + 1 == nodes.size()) {
+                fenwick.pop_back();
+                fenwickAdd(n, moved - 1);
+            }
+            else {
+                rebuildIndex();
+            }
+        }
+        else {
+            fenwickAdd(n, static_cast<size_t>(-1));
         }
     }
 
     void erase_front() {
-        if (head == nullptr) {
+        if (list_size == 0) {
             throw std::underflow_error("List is empty");
         }
-        Node* to_delete = head;
-        head = head->next;
-        if (head == nullptr) {
-            tail = nullptr;
-        }
-        delete to_delete;
-        --list_size;
+        erase(0);
     }
 
     size_t find(T val) const {
-        Node* current = head;
         size_t index = 0;
-        while (current != nullptr) {
-            if (current->data == val) {
-                return index;
+        for (Node* node = front(); node != nullptr; node = node->next) {
+            for (size_t i = 0; i < node->count; ++i, ++index) {
+                if (node->at(i) == val) {
+                    return index;
+                }
             }
-            current = current->next;
-            ++index;
         }
         throw std::logic_error("Value not found in the list");
     }
 
     T get_first() const {
-        if (head == nullptr) {
+        if (list_size == 0) {
             throw std::underflow_error("List is empty");
         }
-        return head->data;
+        return front()->at(0);
     }
 
     bool operator==(const List& other) const {
         if (list_size != other.list_size) {
             return false;
         }
-        Node* current1 = head;
-        Node* current2 = other.head;
-        while (current1 != nullptr) {
-            if (current1->data != current2->data) {
+        Node* a = front();
+        Node* b = other.front();
+        size_t i = 0, j = 0;
+        for (size_t k = 0; k < list_size; ++k) {
+            if (a->at(i) != b->at(j)) {
                 return false;
             }
-            current1 = current1->next;
-            current2 = current2->next;
+            if (++i == a->count) {
+                a = a->next;
+                i = 0;
+            }
+            if (++j == b->count) {
+                b = b->next;
+                j = 0;
+            }
         }
         return true;
     }
 
     friend std::ostream& operator<<(std::ostream& os, const List& list) {
-        Node* current = list.head;
-        while (current != nullptr) {
-            os << current->data << " ";
-            current = current->next;
+        for (Node* node = list.front(); node != nullptr; node = node->next) {
+            for (size_t i = 0; i < node->count; ++i) {
+                os << node->at(i) << " ";
+            }
         }
         return os;
     }
@@ -221,68 +443,105 @@ public:
         if (k >= list_size) {
             throw std::out_of_range("Index out of range");
         }
-        Node* first = head;
-        Node* second = head;
-        for (size_t i = 0; i < k; ++i) {
-            if (second == nullptr) {
-                throw std::out_of_range("Index out of range");
-            }
-            second = second->next;
-        }
-        while (second->next != nullptr) {
-            first = first->next;
-            second = second->next;
-        }
-        return first->data;
+        return (*this)[list_size - 1 - k];
     }
 
-    class Iterator {
-        Node* curr;
+    // Bidirectional iterator over (node, offset). The past-the-end position
+    // is one past the last element of the last node, so ++ from the last
+    // element reaches end() and -- from end() steps back into the list;
+    // an empty list's begin() and end() are both (nullptr, 0).
+    //
+    // Any insert or erase invalidates every iterator, since elements move
+    // between nodes when they split or merge.
+    template<bool IsConst>
+    class BasicIterator {
+        friend class List;
+        template<bool> friend class BasicIterator;
+
+        Node* curr = nullptr;
+        size_t offset = 0;
+
+        BasicIterator(Node* node, size_t pos) : curr(node), offset(pos) {}
 
     public:
-        Iterator(Node* node) : curr(node) {}
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        BasicIterator() = default;
 
-        Iterator& operator++() {
-            if (!curr->next) {
-                throw std::out_of_range("Out of range");
+        template<bool WasConst, typename = std::enable_if_t<IsConst && !WasConst>>
+        BasicIterator(const BasicIterator<WasConst>& other) : curr(other.curr), offset(other.offset) {}
+
+        BasicIterator& operator++() {
+            if (++offset == curr->count && curr->next) {
+                curr = curr->next;
+                offset = 0;
             }
-            curr = curr->next;
             return *this;
         }
 
-        Iterator operator++(int) {
-            if (!curr->next) {
-                throw std::out_of_range("Out of range");
+        BasicIterator operator++(int) {
+            BasicIterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        BasicIterator& operator--() {
+            if (offset == 0) {
+                curr = curr->prev;
+                offset = curr->count;
             }
-            Iterator copy = *this;
-            curr = curr->next;
+            --offset;
+            return *this;
+        }
+
+        BasicIterator operator--(int) {
+            BasicIterator copy = *this;
+            --*this;
             return copy;
         }
 
-        T& operator*() {
-            return curr->data;
+        reference operator*() const {
+            return curr->at(offset);
         }
 
-        T* operator->() {
-            return &(curr->data);
+        pointer operator->() const {
+            return &curr->at(offset);
         }
 
-        friend bool operator!=(const Iterator& it1, const Iterator& it2) {
-            return it1.curr != it2.curr;
+        friend bool operator==(const BasicIterator& it1, const BasicIterator& it2) {
+            return it1.curr == it2.curr && it1.offset == it2.offset;
         }
 
-        friend bool operator==(const Iterator& it1, const Iterator& it2) {
-            return it1.curr == it2.curr;
+        friend bool operator!=(const BasicIterator& it1, const BasicIterator& it2) {
+            return !(it1 == it2);
         }
     };
 
-    Iterator begin() {
-        return Iterator(head);
-    }
-
-    Iterator end() {
-        return Iterator(nullptr);
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using Iterator = iterator;
+
+    iterator begin() { return iterator(front(), 0); }
+    iterator end() { return nodes.empty() ? iterator() : iterator(nodes.back(), nodes.back()->count); }
+    const_iterator begin() const { return const_iterator(front(), 0); }
+    const_iterator end() const {
+        return nodes.empty() ? const_iterator() : const_iterator(nodes.back(), nodes.back()->count);
     }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator crend() const { return rend(); }
 };
 
 
@@ -302,10 +561,25 @@ public:
         }
     }
 
+    Queue(const Queue&) = default;
+    // noexcept follows std::deque: its move constructor may allocate.
+    Queue(Queue&&) = default;
+    Queue& operator=(const Queue&) = default;
+    Queue& operator=(Queue&&) = default;
+
     void enqueue(const T& val) noexcept {
         data.push_back(val);
     }
 
+    void enqueue(T&& val) {
+        data.push_back(std::move(val));
+    }
+
+    template<typename... Args>
+    T& emplace(Args&&... args) {
+        return data.emplace_back(std::forward<Args>(args)...);
+    }
+
     void dequeue() {
         if (isEmpty()) {
             throw std::underflow_error("Queue Empty");
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Scoped trace spans for finding out where a slow query spends its time:
+//
+//   tracing::enable();
+//   { POLINOM_TRACE_SPAN("parse"); ... }
+//   tracing::writeChromeTrace(file);   // open in chrome://tracing or Perfetto
+//
+// Every thread records into its own ring buffer, so recording takes no lock
+// and never blocks; a full ring overwrites its oldest spans. The buffer of a
+// thread that has exited is released once collect() has returned its spans,
+// or by clear(), so short-lived threads do not pile up rings. Export may run
+// while other threads are still recording: each slot carries a sequence
+// number and a slot caught mid-write is skipped rather than torn.
+//
+// Tracing is off by default. A disabled span costs one relaxed load and a
+// branch that is always taken the same way.
+namespace tracing {
+
+struct Event {
+    const char* name = nullptr;
+    uint32_t thread = 0;
+    int64_t arg = -1;
+    uint64_t start = 0;     // ns since the trace epoch
+    uint64_t duration = 0;  // ns
+};
+
+namespace detail {
+
+inline std::atomic<bool>& enabledFlag() {
+    static std::atomic<bool> flag{ false };
+    return flag;
+}
+
+inline std::chrono::steady_clock::time_point epoch() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return start;
+}
+
+inline uint64_t now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch()).count());
+}
+
+// Single-writer ring. Slot fields are relaxed atomics so a concurrent
+// reader is well defined; `seq` is odd while the owner is writing the slot
+// and 2 * (write number + 1) once it is complete.
+class ThreadBuffer {
+public:
+    static constexpr size_t kCapacity = size_t(1) << 14;
+
+    explicit ThreadBuffer(uint32_t id) : thread(id), slots(new Slot[kCapacity]) {}
+
+    void push(const char* name, int64_t arg, uint64_t start, uint64_t duration) {
+        uint64_t n = written.load(std::memory_order_relaxed);
+        Slot& s = slots[n & (kCapacity - 1)];
+        s.seq.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.name.store(name, std::memory_order_relaxed);
+        s.arg.store(arg, std::memory_order_relaxed);
+        s.start.store(start, std::memory_order_relaxed);
+        s.duration.store(duration, std::memory_order_relaxed);
+        s.seq.store(2 * n + 2, std::memory_order_release);
+        written.store(n + 1, std::memory_order_release);
+    }
+
+    void collect(std::vector<Event>& out) const {
+        uint64_t end = written.load(std::memory_order_acquire);
+        uint64_t begin = std::max(end, uint64_t(kCapacity)) - kCapacity;
+        begin = std::max(begin, cleared.load(std::memory_order_acquire));
+        for (uint64_t n = begin; n < end; ++n) {
+            const Slot& s = slots[n & (kCapacity - 1)];
+            if (s.seq.load(std::memory_order_acquire) != 2 * n + 2)
+                continue;
+            Event e;
+            e.name = s.name.load(std::memory_order_relaxed);
+            e.arg = s.arg.load(std::memory_order_relaxed);
+            e.start = s.start.load(std::memory_order_relaxed);
+            e.duration = s.duration.load(std::memory_order_relaxed);
+            e.thread = thread;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.seq.load(std::memory_order_relaxed) == 2 * n + 2)
+                out.push_back(e);
+        }
+    }
+
+    // Hides everything recorded so far from collect().
+    void clear() { cleared.store(written.load(std::memory_order_acquire), std::memory_order_release); }
+
+    // Set by the owning thread as it exits, after its last push.
+    void detach() { exited.store(true, std::memory_order_release); }
+    bool detached() const { return exited.load(std::memory_order_acquire); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{ 0 };
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<int64_t> arg{ -1 };
+        std::atomic<uint64_t> start{ 0 };
+        std::atomic<uint64_t> duration{ 0 };
+    };
+
+    uint32_t thread;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> written{ 0 };
+    std::atomic<uint64_t> cleared{ 0 };
+    std::atomic<bool> exited{ false };
+};
+
+// Owns every thread's buffer, so spans of threads that have exited are
+// still exported. Such a buffer is dropped once a collect() has read it
+// after the exit, or on clear().
+class Registry {
+public:
+    std::shared_ptr<ThreadBuffer> attach() {
+        std::lock_guard<std::mutex> guard(lock);
+        buffers.push_back(std::make_shared<ThreadBuffer>(++lastThread));
+        return buffers.back();
+    }
+
+    std::vector<Event> collect() {
+        std::vector<std::shared_ptr<ThreadBuffer>> all;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            all = buffers;
+        }
+        std::vector<Event> events;
+        std::vector<const ThreadBuffer*> drained;
+        for (const auto& b : all) {
+            // Check first: a buffer that was detached before the read holds
+            // no spans the read could have missed.
+            bool exited = b->detached();
+            b->collect(events);
+            if (exited)
+                drained.push_back(b.get());
+        }
+        if (!drained.empty()) {
+            std::lock_guard<std::mutex> guard(lock);
+            buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [&](const auto& b) {
+                return std::find(drained.begin(), drained.end(), b.get()) != drained.end();
+            }), buffers.end());
+        }
+        std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+            return a.start != b.start ? a.start < b.start : a.duration > b.duration;
+        });
+        return events;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> guard(lock);
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+            [](const auto& b) { return b->detached(); }), buffers.end());
+        for (const auto& b : buffers)
+            b->clear();
+    }
+
+    size_t bufferCount() const {
+        std::lock_guard<std::mutex> guard(lock);
+        return buffers.size();
+    }
+
+private:
+    mutable std::mutex lock;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint32_t lastThread = 0;
+};
+
+inline Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Marks the buffer detached when its thread exits.
+struct ThreadBufferHandle {
+    std::shared_ptr<ThreadBuffer> buffer = registry().attach();
+    ~ThreadBufferHandle() { buffer->detach(); }
+};
+
+inline ThreadBuffer& threadBuffer() {
+    thread_local ThreadBufferHandle handle;
+    return *handle.buffer;
+}
+
+}
+
+inline bool enabled() { return detail::enabledFlag().load(std::memory_order_relaxed); }
+
+inline void enable() {
+    detail::epoch();
+    detail::enabledFlag().store(true, std::memory_order_relaxed);
+}
+
+inline void disable() { detail::enabledFlag().store(false, std::memory_order_relaxed); }
+
+// Drops the spans recorded so far.
+inline void clear() { detail::registry().clear(); }
+
+// Every retained span, ordered by start time (enclosing spans first).
+inline std::vector<Event> collect() { return detail::registry().collect(); }
+
+// Records its own lifetime as a complete ("X") event. `name` must outlive
+// the export, in practice a string literal. `arg`, when not negative, is
+// exported as args.index, e.g. the DAG node a span evaluated.
+class Span {
+public:
+    explicit Span(const char* spanName, int64_t spanArg = -1) {
+        if (enabled()) {
+            name = spanName;
+            arg = spanArg;
+            start = detail::now();
+        }
+    }
+
+    ~Span() {
+        if (name)
+            detail::threadBuffer().push(name, arg, start, detail::now() - start);
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* name = nullptr;
+    int64_t arg = -1;
+    uint64_t start = 0;
+};
+
+inline void writeJsonString(std::ostream& out, const char* s) {
+    out << '"';
+    for (; *s; ++s) {
+        unsigned char c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\')
+            out << '\\' << *s;
+        else if (c < 0x20)
+            out << "\\u00" << "0123456789abcdef"[c >> 4] << "0123456789abcdef"[c & 15];
+        else
+            out << *s;
+    }
+    out << '"';
+}
+
+// Writes `events` in the Chrome trace_event JSON format. Timestamps are in
+// microseconds with nanosecond fractions.
+inline void writeChromeTrace(std::ostream& out, const std::vector<Event>& events) {
+    auto micros = [&out](uint64_t ns) {
+        out << ns / 1000 << '.' << static_cast<char>('0' + ns / 100 % 10) << static_cast<char>('0' + ns / 10 % 10)
+            << static_cast<char>('0' + ns % 10);
+    };
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+        const Event& e = events[i];
+        out << (i ? ",\n" : "\n") << "{\"name\":";
+        writeJsonString(out, e.name);
+        out << ",\"cat\":\"polinom\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread << ",\"ts\":";
+        micros(e.start);
+        out << ",\"dur\":";
+        micros(e.duration);
+        if (e.arg >= 0)
+            out << ",\"args\":{\"index\":" << e.arg << '}';
+        out << '}';
+    }
+    out << "\n]}\n";
+}
+
+inline void writeChromeTrace(std::ostream& out) { writeChromeTrace(out, collect()); }
+
+}
+
+#define POLINOM_TRACE_CONCAT_INNER(a, b) a##b
+#define POLINOM_TRACE_CONCAT(a, b) POLINOM_TRACE_CONCAT_INNER(a, b)
+#define POLINOM_TRACE_SPAN(...) ::tracing::Span POLINOM_TRACE_CONCAT(polinomTraceSpan_, __LINE__)(__VA_ARGS__)
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <memory_resource>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "metrics.h"
+
+// Operation an allocation is charged to. Nested operations keep the
+// outermost tag, so the row merges inside a multiply count as Multiply.
+enum class AllocTag : unsigned {
+    Untagged,
+    Parse,
+    Add,
+    Subtract,
+    Multiply,
+    Scale,
+    StoreInsert,
+    Count
+};
+
+inline const char* allocTagName(AllocTag tag) {
+    static const char* const names[] = { "untagged", "parse", "add", "subtract", "multiply", "scale", "store_insert" };
+    return names[static_cast<unsigned>(tag)];
+}
+
+inline AllocTag& currentAllocTag() {
+    thread_local AllocTag tag = AllocTag::Untagged;
+    return tag;
+}
+
+// Charges allocations made on this thread during its lifetime to `tag`,
+// unless an enclosing scope already set one.
+class AllocScope {
+public:
+    explicit AllocScope(AllocTag tag) : previous(currentAllocTag()) {
+        if (previous == AllocTag::Untagged)
+            currentAllocTag() = tag;
+    }
+    ~AllocScope() { currentAllocTag() = previous; }
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+    AllocTag previous;
+};
+
+// The library's operations open their scopes through this macro, which like
+// the other POLINOM_METRIC_* hooks compiles to nothing unless
+// POLINOM_METRICS=1. Without it TrackingResource still counts everything,
+// but as Untagged.
+#if POLINOM_METRICS
+#define POLINOM_ALLOC_SCOPE(tag) ::AllocScope POLINOM_METRIC_CONCAT(polinomAllocScope_, __LINE__)(::AllocTag::tag)
+#else
+#define POLINOM_ALLOC_SCOPE(tag) ((void)0)
+#endif
+
+struct AllocStats {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytesAllocated = 0;  // cumulative
+    uint64_t liveBytes = 0;
+    uint64_t peakLiveBytes = 0;
+};
+
+// Pass-through std::pmr::memory_resource that accounts every allocation to
+// the AllocTag current on the allocating thread: counts, cumulative bytes,
+// and live and peak-live bytes. A small header in front of each block
+// remembers the tag, so a block freed under another operation (or on
+// another thread) is still credited back to the one that allocated it.
+//
+// To cover everything that uses the default resource, List nodes and the
+// stores included, install it process-wide:
+//
+//   TrackingResource tracking;
+//   std::pmr::memory_resource* old = std::pmr::set_default_resource(&tracking);
+//   ... run the workload ...
+//   std::pmr::set_default_resource(old);
+//   std::cout << tracking.report();
+//
+// Blocks allocated through it must be freed before it is destroyed.
+// Thread-safe if the upstream is.
+class TrackingResource : public std::pmr::memory_resource {
+public:
+    explicit TrackingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream(upstream) {}
+
+    TrackingResource(const TrackingResource&) = delete;
+    TrackingResource& operator=(const TrackingResource&) = delete;
+
+    AllocStats stats(AllocTag tag) const {
+        const Counters& c = counters[static_cast<size_t>(tag)];
+        AllocStats s;
+        s.allocations = c.allocations.load(std::memory_order_relaxed);
+        s.deallocations = c.deallocations.load(std::memory_order_relaxed);
+        s.bytesAllocated = c.bytesAllocated.load(std::memory_order_relaxed);
+        s.liveBytes = c.liveBytes.load(std::memory_order_relaxed);
+        s.peakLiveBytes = c.peakLiveBytes.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    // Sum over all tags; the peak is the peak of the total, not the sum of
+    // the per-tag peaks.
+    AllocStats total() const {
+        AllocStats s;
+        for (size_t t = 0; t < static_cast<size_t>(AllocTag::Count); ++t) {
+            AllocStats part = stats(static_cast<AllocTag>(t));
+            s.allocations += part.allocations;
+            s.deallocations += part.deallocations;
+            s.bytesAllocated += part.bytesAllocated;
+        }
+        s.liveBytes = liveTotal.load(std::memory_order_relaxed);
+        s.peakLiveBytes = peakTotal.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    // Forgets the counts and restarts every peak at the current live bytes.
+    void resetStats() {
+        for (Counters& c : counters) {
+            c.allocations.store(0, std::memory_order_relaxed);
+            c.deallocations.store(0, std::memory_order_relaxed);
+            c.bytesAllocated.store(0, std::memory_order_relaxed);
+            c.peakLiveBytes.store(c.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        peakTotal.store(liveTotal.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    // One line per tag that allocated anything, then the total.
+    std::string report() const {
+        std::ostringstream out;
+        out << std::left << std::setw(14) << "operation" << std::right << std::setw(12) << "allocs"
+            << std::setw(12) << "frees" << std::setw(16) << "bytes" << std::setw(14) << "live"
+            << std::setw(14) << "peak live" << '\n';
+        auto row = [&out](const char* name, const AllocStats& s) {
+            out << std::left << std::setw(14) << name << std::right << std::setw(12) << s.allocations
+                << std::setw(12) << s.deallocations << std::setw(16) << s.bytesAllocated
+                << std::setw(14) << s.liveBytes << std::setw(14) << s.peakLiveBytes << '\n';
+        };
+        for (size_t t = 0; t < static_cast<size_t>(AllocTag::Count); ++t) {
+            AllocStats s = stats(static_cast<AllocTag>(t));
+            if (s.allocations || s.liveBytes)
+                row(allocTagName(static_cast<AllocTag>(t)), s);
+        }
+        row("total", total());
+        return out.str();
+    }
+
+    std::pmr::memory_resource* upstreamResource() const { return upstream; }
+
+private:
+    struct Header {
+        AllocTag tag;
+    };
+
+    struct alignas(64) Counters {
+        std::atomic<uint64_t> allocations{ 0 };
+        std::atomic<uint64_t> deallocations{ 0 };
+        std::atomic<uint64_t> bytesAllocated{ 0 };
+        std::atomic<uint64_t> liveBytes{ 0 };
+        std::atomic<uint64_t> peakLiveBytes{ 0 };
+    };
+
+    std::pmr::memory_resource* upstream;
+    Counters counters[static_cast<size_t>(AllocTag::Count)];
+    std::atomic<uint64_t> liveTotal{ 0 };
+    std::atomic<uint64_t> peakTotal{ 0 };
+
+    static size_t headerBytes(size_t alignment) {
+        return (sizeof(Header) + alignment - 1) / alignment * alignment;
+    }
+
+    static void raise(std::atomic<uint64_t>& peak, uint64_t value) {
+        uint64_t seen = peak.load(std::memory_order_relaxed);
+        while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        alignment = alignment < alignof(Header) ? alignof(Header) : alignment;
+        size_t pad = headerBytes(alignment);
+        char* raw = static_cast<char*>(upstream->allocate(bytes + pad, alignment));
+        AllocTag tag = currentAllocTag();
+        new (raw + pad - sizeof(Header)) Header{ tag };
+
+        Counters& c = counters[static_cast<size_t>(tag)];
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        c.bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+        raise(c.peakLiveBytes, c.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+        raise(peakTotal, liveTotal.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+        return raw + pad;
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        alignment = alignment < alignof(Header) ? alignof(Header) : alignment;
+        size_t pad = headerBytes(alignment);
+        char* raw = static_cast<char*>(p) - pad;
+        AllocTag tag = reinterpret_cast<Header*>(raw + pad - sizeof(Header))->tag;
+
+        Counters& c = counters[static_cast<size_t>(tag)];
+        c.deallocations.fetch_add(1, std::memory_order_relaxed);
+        c.liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        liveTotal.fetch_sub(bytes, std::memory_order_relaxed);
+        upstream->deallocate(raw, bytes + pad, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
@@ -0,0 +1,436 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "formatter.h"
+#include "polinom.h"
+#include "serialization.h"
+
+// Seeded generators for benchmark inputs: random polynomials with a
+// controlled shape, and operation traces against a polynomial store.
+// Everything is derived from one 64-bit seed through WorkloadRandom rather
+// than the <random> distributions, whose output differs between standard
+// libraries, so a seed names the same workload on every platform.
+
+// xoshiro256** seeded through splitmix64.
+class WorkloadRandom {
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    explicit WorkloadRandom(uint64_t seed) {
+        for (uint64_t& word : s) {
+            uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, 1).
+    double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    // Uniform in [0, n), without modulo bias. n must be positive.
+    uint64_t below(uint64_t n) {
+        uint64_t threshold = (0 - n) % n;
+        uint64_t x;
+        do {
+            x = next();
+        } while (x < threshold);
+        return x % n;
+    }
+};
+
+// Draws ranks 0..n-1 with P(k) proportional to 1 / (k + 1)^exponent;
+// exponent 0 is uniform, ~1 is the classic skewed key popularity.
+class ZipfSampler {
+private:
+    std::vector<double> cdf;
+
+public:
+    ZipfSampler(size_t n, double exponent) {
+        if (n == 0)
+            throw std::invalid_argument("Zipf sampler needs at least one rank");
+        cdf.resize(n);
+        double total = 0.0;
+        for (size_t k = 0; k < n; ++k)
+            cdf[k] = total += std::pow(static_cast<double>(k + 1), -exponent);
+        for (double& c : cdf)
+            c /= total;
+    }
+
+    size_t operator()(WorkloadRandom& rng) const {
+        auto it = std::upper_bound(cdf.begin(), cdf.end(), rng.uniform());
+        return it == cdf.end() ? cdf.size() - 1 : static_cast<size_t>(it - cdf.begin());
+    }
+
+    size_t size() const { return cdf.size(); }
+};
+
+enum class CoeffDistribution : uint8_t {
+    Integer,      // non-zero integers in [-coeffMax, coeffMax]
+    Uniform,      // reals in [-coeffMax, coeffMax]
+    LogUniform    // magnitudes log-uniform in [1 / coeffMax, coeffMax], random sign
+};
+
+struct PolinomSpec {
+    // Distinct monoms per polynomial, capped at the (maxPower + 1)^3
+    // available. A positive density overrides it with that fraction of the
+    // available monoms.
+    int terms = 16;
+    double density = 0.0;
+    // Every power of x, y and z is at most maxPower. Two polynomials with
+    // maxPower <= 4 can always be multiplied without degree overflow.
+    int maxPower = 9;
+    // A monom with powers (a, b, c) is picked with weight
+    // exponentDecay^(a + b + c): 1 is uniform, smaller favours low powers.
+    double exponentDecay = 1.0;
+    CoeffDistribution coefficients = CoeffDistribution::Integer;
+    double coeffMax = 10.0;
+};
+
+inline int availableMonoms(const PolinomSpec& spec) {
+    return (spec.maxPower + 1) * (spec.maxPower + 1) * (spec.maxPower + 1);
+}
+
+inline void validate(const PolinomSpec& spec) {
+    if (spec.maxPower < 0 || spec.maxPower > 9)
+        throw std::invalid_argument("maxPower must be in [0, 9]");
+    if (spec.terms < 0 || spec.density < 0.0 || spec.density > 1.0)
+        throw std::invalid_argument("Term count and density must be non-negative, density at most 1");
+    if (!(spec.exponentDecay > 0.0))
+        throw std::invalid_argument("exponentDecay must be positive");
+    if (!(spec.coeffMax >= 1.0) || (spec.coeffMax == 1.0 && spec.coefficients == CoeffDistribution::LogUniform))
+        throw std::invalid_argument("coeffMax must be at least 1 (above 1 for log-uniform)");
+}
+
+inline double generateCoefficient(const PolinomSpec& spec, WorkloadRandom& rng) {
+    switch (spec.coefficients) {
+    case CoeffDistribution::Integer: {
+        uint64_t m = static_cast<uint64_t>(spec.coeffMax);
+        uint64_t v = rng.below(2 * m);
+        return v < m ? -static_cast<double>(v + 1) : static_cast<double>(v - m + 1);
+    }
+    case CoeffDistribution::Uniform:
+        for (;;) {
+            double c = (2.0 * rng.uniform() - 1.0) * spec.coeffMax;
+            if (std::abs(c) > 1e-10)   // Polinom drops anything smaller
+                return c;
+        }
+    case CoeffDistribution::LogUniform: {
+        double logMax = std::log(spec.coeffMax);
+        double c = std::exp((2.0 * rng.uniform() - 1.0) * logMax);
+        return rng.next() & 1 ? c : -c;
+    }
+    }
+    return 0.0;
+}
+
+inline Polinom generatePolinom(const PolinomSpec& spec, WorkloadRandom& rng) {
+    validate(spec);
+    int available = availableMonoms(spec);
+    int terms = spec.density > 0.0
+        ? std::max(1, static_cast<int>(std::lround(spec.density * available)))
+        : std::min(spec.terms, available);
+
+    std::vector<int> degrees;
+    degrees.reserve(available);
+    for (int x = 0; x <= spec.maxPower; ++x)
+        for (int y = 0; y <= spec.maxPower; ++y)
+            for (int z = 0; z <= spec.maxPower; ++z)
+                degrees.push_back(x * 100 + y * 10 + z);
+
+    if (spec.exponentDecay == 1.0) {
+        // Partial Fisher-Yates: the first `terms` slots end up a uniform sample.
+        for (int i = 0; i < terms; ++i)
+            std::swap(degrees[i], degrees[i + rng.below(available - i)]);
+    }
+    else {
+        // Weighted sampling without replacement (Efraimidis-Spirakis): every
+        // monom gets the key log(u) / weight and the largest keys win.
+        std::vector<double> powerWeight(spec.maxPower + 1, 1.0);
+        for (int k = 1; k <= spec.maxPower; ++k)
+            powerWeight[k] = powerWeight[k - 1] * spec.exponentDecay;
+        std::vector<std::pair<double, int>> keyed;
+        keyed.reserve(available);
+        for (int d : degrees) {
+            double u = 1.0 - rng.uniform();   // (0, 1]
+            double weight = powerWeight[d / 100] * powerWeight[d / 10 % 10] * powerWeight[d % 10];
+            keyed.emplace_back(std::log(u) / weight, d);
+        }
+        std::partial_sort(keyed.begin(), keyed.begin() + terms, keyed.end(),
+            [](const auto& a, const auto& b) { return a.first > b.first || (a.first == b.first && a.second < b.second); });
+        for (int i = 0; i < terms; ++i)
+            degrees[i] = keyed[i].second;
+    }
+
+    std::vector<Monom> monoms;
+    monoms.reserve(terms);
+    for (int i = 0; i < terms; ++i)
+        monoms.emplace_back(degrees[i], generateCoefficient(spec, rng));
+    return Polinom(monoms);
+}
+
+inline std::vector<Polinom> generatePolinoms(const PolinomSpec& spec, size_t count, uint64_t seed) {
+    WorkloadRandom rng(seed);
+    std::vector<Polinom> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        result.push_back(generatePolinom(spec, rng));
+    return result;
+}
+
+// One operation against a store of named polynomials. Keys are indices;
+// keyName() turns them into store names.
+struct StoreOp {
+    enum class Kind : uint8_t { Insert, Lookup, Erase, Evaluate };
+
+    Kind kind = Kind::Lookup;
+    uint32_t key = 0;
+    Polinom value;            // Insert only
+    std::string expression;   // Evaluate only, over keyName() operands; the first is `key`
+};
+
+inline std::string keyName(uint32_t key) {
+    return "p" + std::to_string(key);
+}
+
+struct TraceSpec {
+    size_t operations = 10000;
+    uint32_t keys = 1024;
+    // Zipf exponent of key popularity; 0 makes every key equally likely.
+    double zipfExponent = 0.99;
+    // Percentages of the operation mix; they must add up to 100.
+    unsigned lookupPercent = 80;
+    unsigned insertPercent = 10;
+    unsigned erasePercent = 5;
+    unsigned evaluatePercent = 5;
+    // Operands per Evaluate expression. Operands are paired into products
+    // when the values' maxPower is at most 4, otherwise only summed.
+    int expressionOperands = 4;
+    PolinomSpec values{ 8, 0.0, 4 };
+};
+
+inline std::vector<StoreOp> generateTrace(const TraceSpec& spec, uint64_t seed) {
+    if (spec.lookupPercent + spec.insertPercent + spec.erasePercent + spec.evaluatePercent != 100)
+        throw std::invalid_argument("Operation mix must add up to 100");
+    if (spec.keys == 0 || spec.expressionOperands < 1)
+        throw std::invalid_argument("Trace needs at least one key and one operand");
+    validate(spec.values);
+
+    WorkloadRandom rng(seed);
+    ZipfSampler popularity(spec.keys, spec.zipfExponent);
+    bool products = spec.values.maxPower <= 4;
+    std::vector<StoreOp> trace(spec.operations);
+    for (StoreOp& op : trace) {
+        unsigned roll = static_cast<unsigned>(rng.below(100));
+        op.key = static_cast<uint32_t>(popularity(rng));
+        if (roll < spec.lookupPercent) {
+            op.kind = StoreOp::Kind::Lookup;
+        }
+        else if ((roll -= spec.lookupPercent) < spec.insertPercent) {
+            op.kind = StoreOp::Kind::Insert;
+            op.value = generatePolinom(spec.values, rng);
+        }
+        else if ((roll -= spec.insertPercent) < spec.erasePercent) {
+            op.kind = StoreOp::Kind::Erase;
+        }
+        else {
+            op.kind = StoreOp::Kind::Evaluate;
+            op.expression = keyName(op.key);
+            for (int i = 1; i < spec.expressionOperands; ++i) {
+                op.expression += products && i % 2 == 1 ? "*" : (rng.next() & 1 ? " + " : " - ");
+                op.expression += keyName(static_cast<uint32_t>(popularity(rng)));
+            }
+        }
+    }
+    return trace;
+}
+
+// Text formats, one record per line; blank lines and lines starting with
+// '#' are skipped on input.
+//   polynomials: the formatted polynomial
+//   traces:      "insert p3 = 2x+1", "lookup p3", "erase p3", "eval p3*p1 + p0"
+inline void writePolinomsText(std::ostream& out, const std::vector<Polinom>& polinoms) {
+    for (const Polinom& p : polinoms)
+        out << formatPolinom(p) << '\n';
+}
+
+inline bool workloadSkipLine(const std::string& line) {
+    size_t first = line.find_first_not_of(" \t\r");
+    return first == std::string::npos || line[first] == '#';
+}
+
+inline std::vector<Polinom> readPolinomsText(std::istream& in) {
+    std::vector<Polinom> result;
+    std::string line;
+    while (std::getline(in, line))
+        if (!workloadSkipLine(line))
+            result.emplace_back(line);
+    return result;
+}
+
+inline void writeTraceText(std::ostream& out, const std::vector<StoreOp>& trace) {
+    for (const StoreOp& op : trace) {
+        switch (op.kind) {
+        case StoreOp::Kind::Insert:
+            out << "insert " << keyName(op.key) << " = " << formatPolinom(op.value) << '\n';
+            break;
+        case StoreOp::Kind::Lookup:
+            out << "lookup " << keyName(op.key) << '\n';
+            break;
+        case StoreOp::Kind::Erase:
+            out << "erase " << keyName(op.key) << '\n';
+            break;
+        case StoreOp::Kind::Evaluate:
+            out << "eval " << op.expression << '\n';
+            break;
+        }
+    }
+}
+
+inline std::vector<StoreOp> readTraceText(std::istream& in) {
+    auto parseKey = [](const std::string& word) {
+        if (word.size() < 2 || word[0] != 'p' || word.find_first_not_of("0123456789", 1) != std::string::npos)
+            throw std::runtime_error("Bad key in trace: " + word);
+        return static_cast<uint32_t>(std::stoul(word.substr(1)));
+    };
+    std::vector<StoreOp> trace;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (workloadSkipLine(line))
+            continue;
+        size_t begin = line.find_first_not_of(" \t");
+        size_t space = line.find(' ', begin);
+        std::string verb = line.substr(begin, space - begin);
+        std::string rest = space == std::string::npos ? "" : line.substr(space + 1);
+        StoreOp op;
+        if (verb == "eval") {
+            op.kind = StoreOp::Kind::Evaluate;
+            op.expression = rest;
+            size_t digits = rest.find_first_not_of("0123456789", 1);
+            op.key = parseKey(rest.substr(0, digits));
+        }
+        else if (verb == "insert") {
+            size_t eq = rest.find('=');
+            if (eq == std::string::npos)
+                throw std::runtime_error("Expected insert name = polinom");
+            std::string name = rest.substr(0, rest.find_last_not_of(" \t", eq - 1) + 1);
+            op.kind = StoreOp::Kind::Insert;
+            op.key = parseKey(name);
+            op.value = Polinom(rest.substr(eq + 1));
+        }
+        else if (verb == "lookup" || verb == "erase") {
+            op.kind = verb == "lookup" ? StoreOp::Kind::Lookup : StoreOp::Kind::Erase;
+            op.key = parseKey(rest.substr(0, rest.find_last_not_of(" \t\r") + 1));
+        }
+        else {
+            throw std::runtime_error("Unknown trace operation: " + verb);
+        }
+        trace.push_back(std::move(op));
+    }
+    return trace;
+}
+
+// Binary formats: a four-byte magic, then
+//   polynomials: PolinomEncoder records back to back
+//   traces:      per op, a kind byte and a varint key, followed by a
+//                PolinomEncoder record (insert) or a varint length and the
+//                expression text (eval)
+inline const uint8_t kPolinomsMagic[4] = { 'P', 'W', 'P', '1' };
+inline const uint8_t kTraceMagic[4] = { 'P', 'W', 'T', '1' };
+
+inline bool hasWorkloadMagic(const std::vector<uint8_t>& buffer, const uint8_t (&magic)[4]) {
+    return buffer.size() >= 4 && std::equal(magic, magic + 4, buffer.begin());
+}
+
+inline void writePolinomsBinary(std::vector<uint8_t>& out, const std::vector<Polinom>& polinoms,
+    SerializeOptions options = SerializeOptions()) {
+    out.insert(out.end(), kPolinomsMagic, kPolinomsMagic + 4);
+    PolinomEncoder encoder(out, options);
+    for (const Polinom& p : polinoms)
+        encoder.write(p);
+}
+
+inline std::vector<Polinom> readPolinomsBinary(const std::vector<uint8_t>& buffer) {
+    if (!hasWorkloadMagic(buffer, kPolinomsMagic))
+        throw std::runtime_error("Not a binary polinom workload");
+    PolinomDecoder decoder(buffer.data() + 4, buffer.size() - 4);
+    std::vector<Polinom> result;
+    while (!decoder.done())
+        result.push_back(decoder.read());
+    return result;
+}
+
+inline void writeTraceBinary(std::vector<uint8_t>& out, const std::vector<StoreOp>& trace,
+    SerializeOptions options = SerializeOptions()) {
+    out.insert(out.end(), kTraceMagic, kTraceMagic + 4);
+    ByteWriter writer(out);
+    PolinomEncoder encoder(out, options);
+    for (const StoreOp& op : trace) {
+        writer.putByte(static_cast<uint8_t>(op.kind));
+        writer.putVarint(op.key);
+        if (op.kind == StoreOp::Kind::Insert) {
+            encoder.write(op.value);
+        }
+        else if (op.kind == StoreOp::Kind::Evaluate) {
+            writer.putVarint(op.expression.size());
+            out.insert(out.end(), op.expression.begin(), op.expression.end());
+        }
+    }
+}
+
+inline std::vector<StoreOp> readTraceBinary(const std::vector<uint8_t>& buffer) {
+    if (!hasWorkloadMagic(buffer, kTraceMagic))
+        throw std::runtime_error("Not a binary trace workload");
+    const uint8_t* data = buffer.data() + 4;
+    size_t size = buffer.size() - 4;
+    ByteReader reader(data, size);
+    std::vector<StoreOp> trace;
+    while (!reader.atEnd()) {
+        StoreOp op;
+        uint8_t kind = reader.getByte();
+        if (kind > static_cast<uint8_t>(StoreOp::Kind::Evaluate))
+            throw std::runtime_error("Unknown operation in binary trace");
+        op.kind = static_cast<StoreOp::Kind>(kind);
+        uint64_t key = reader.getVarint();
+        if (key > UINT32_MAX)
+            throw std::runtime_error("Key out of range in binary trace");
+        op.key = static_cast<uint32_t>(key);
+        if (op.kind == StoreOp::Kind::Insert) {
+            PolinomDecoder decoder(data + reader.position(), reader.remaining());
+            op.value = decoder.read();
+            reader.skip(decoder.position());
+        }
+        else if (op.kind == StoreOp::Kind::Evaluate) {
+            uint64_t length = reader.getVarint();
+            if (length > reader.remaining())
+                throw std::runtime_error("Truncated binary trace");
+            op.expression.assign(reinterpret_cast<const char*>(data + reader.position()), static_cast<size_t>(length));
+            reader.skip(static_cast<size_t>(length));
+        }
+        trace.push_back(std::move(op));
+    }
+    return trace;
+}
@@ -0,0 +1,27 @@
+// Polynomial arithmetic sample: parses two polynomials in x, y, z and
+// prints their sum, difference and product.
+
+#include <iostream>
+#include <string>
+#include "formatter.h"
+#include "polinom.h"
+
+int main(int argc, char** argv)
+{
+  std::string left = argc > 1 ? argv[1] : "3x^2y + 2z - 1";
+  std::string right = argc > 2 ? argv[2] : "x - 4yz + 1";
+
+  try {
+    Polinom a(left), b(right);
+    std::cout << "a     = " << formatPolinom(a) << std::endl;
+    std::cout << "b     = " << formatPolinom(b) << std::endl;
+    std::cout << "a + b = " << formatPolinom(a + b) << std::endl;
+    std::cout << "a - b = " << formatPolinom(a - b) << std::endl;
+    std::cout << "a * b = " << formatPolinom(a * b) << std::endl;
+  }
+  catch (const std::exception& e) {
+    std::cerr << "error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
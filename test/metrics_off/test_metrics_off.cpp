@@ -0,0 +1,48 @@
+// Built into its own binary with POLINOM_METRICS left at its default of 0,
+// the configuration that ships: the macros compile away, while the
+// exporting API still links and reports zeros.
+#include "metrics.h"
+#include "polinom.h"
+#include "polinomstore.h"
+#include "expression.h"
+#include <gtest.h>
+
+static_assert(POLINOM_METRICS == 0, "this target must build with metrics off");
+
+TEST(MetricsOff, OperationsLeaveSnapshotZero) {
+    metrics::reset();
+    Polinom a("z^2+z+1"), b("z-2");
+    Polinom sum = a + b;
+    Polinom product = a * b;
+    Polinom scaled = a * 2.0;
+    PolinomStore store;
+    store.insertOrAssign("p", product);
+    EXPECT_TRUE(store.find("p").has_value());
+    EXPECT_FALSE(store.contains("q"));
+    EXPECT_EQ(sum, Polinom("z^2+2z-1"));
+
+    metrics::Snapshot s = metrics::snapshot();
+    for (uint64_t c : s.counters)
+        EXPECT_EQ(c, 0u);
+    for (uint64_t calls : s.multiplyByPairs)
+        EXPECT_EQ(calls, 0u);
+    for (const metrics::HistogramSnapshot& h : s.latency)
+        EXPECT_EQ(h.count, 0u);
+}
+
+TEST(MetricsOff, ExportsReportDisabled) {
+    metrics::Snapshot s = metrics::snapshot();
+    EXPECT_NE(s.toJson().find("\"enabled\": false"), std::string::npos);
+    EXPECT_EQ(s.toText().find("latency_ns"), std::string::npos);
+}
+
+TEST(MetricsOff, MacrosCompileAway) {
+    POLINOM_METRIC_ADD(Merges, 5);
+    POLINOM_METRIC_MULTIPLY(100);
+    {
+        POLINOM_METRIC_TIME(Evaluate);
+    }
+    metrics::Snapshot s = metrics::snapshot();
+    EXPECT_EQ(s[metrics::Counter::Merges], 0u);
+    EXPECT_EQ(s[metrics::Op::Evaluate].count, 0u);
+}
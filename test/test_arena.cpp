@@ -0,0 +1,96 @@
+#include "arena.h"
+#include <gtest.h>
+
+namespace {
+
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t deallocations = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t align) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}
+
+TEST(PolinomAllocator, DefaultsToDefaultResource) {
+    Polinom p("x+1");
+    EXPECT_EQ(p.getResource(), std::pmr::get_default_resource());
+}
+
+TEST(PolinomAllocator, ArithmeticUsesLeftOperandResource) {
+    CountingResource counting;
+    Polinom a("x^2+1", &counting);
+    Polinom b("y+2");
+    EXPECT_EQ((a + b).getResource(), &counting);
+    EXPECT_EQ((a - b).getResource(), &counting);
+    EXPECT_EQ((a * b).getResource(), &counting);
+    EXPECT_EQ((a * 2.0).getResource(), &counting);
+    EXPECT_EQ((b + a).getResource(), std::pmr::get_default_resource());
+}
+
+TEST(PolinomAllocator, CopyLeavesCustomResource) {
+    CountingResource counting;
+    Polinom a("x^2+1", &counting);
+    Polinom copy(a);
+    EXPECT_EQ(copy.getResource(), std::pmr::get_default_resource());
+    EXPECT_EQ(copy, a);
+
+    Polinom moved(std::move(a));
+    EXPECT_EQ(moved.getResource(), &counting);
+
+    Polinom explicitCopy(copy, &counting);
+    EXPECT_EQ(explicitCopy.getResource(), &counting);
+    EXPECT_EQ(explicitCopy, copy);
+}
+
+TEST(PolinomAllocator, AssignmentKeepsTargetResource) {
+    CountingResource counting;
+    Polinom target(&counting);
+    target = Polinom("x+y+z");
+    EXPECT_EQ(target.getResource(), &counting);
+    EXPECT_EQ(target, Polinom("x+y+z"));
+}
+
+TEST(PolinomArena, EvaluatesExpressionInsideArena) {
+    PolinomArena arena;
+    Polinom a("x^2+2x+1", arena.resource());
+    Polinom b("x-1", arena.resource());
+    Polinom result((a * b + a) * 2.0, std::pmr::get_default_resource());
+    arena.reset();
+    EXPECT_EQ(result, Polinom("2x^3+4x^2+2x"));
+}
+
+TEST(PolinomArena, WarmArenaDoesNotTouchUpstream) {
+    CountingResource upstream;
+    PolinomArena arena(16 * 1024, &upstream);
+    for (int round = 0; round < 3; ++round) {
+        Polinom a("x^3+y^2+z+1", arena.resource());
+        Polinom b("x+y+z", arena.resource());
+        for (int i = 0; i < 10; ++i)
+            a = a + b * 0.5;
+        arena.reset();
+    }
+    EXPECT_EQ(upstream.allocations, 0);
+}
+
+TEST(PolinomArena, GrowsIntoUpstreamWhenExhausted) {
+    CountingResource upstream;
+    PolinomArena arena(64, &upstream);
+    Polinom a("x^3+y^2+z+1", arena.resource());
+    Polinom b = a * a;
+    EXPECT_GT(upstream.allocations, 0);
+    arena.reset();
+    EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
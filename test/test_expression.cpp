@@ -0,0 +1,123 @@
+#include "expression.h"
+#include <gtest.h>
+
+static std::map<std::string, Polinom> sampleTable() {
+    return {
+        { "a", Polinom("x^2+y") },
+        { "b", Polinom("2z-1") },
+        { "c", Polinom("xyz+3") },
+        { "d", Polinom("x-y+z") },
+    };
+}
+
+TEST(Expression, ParsesPrecedence) {
+    auto table = sampleTable();
+    Polinom expected = table["a"] + table["b"] * table["c"];
+    EXPECT_EQ(Expression("a + b*c").evaluate(table), expected);
+}
+
+TEST(Expression, ParsesParenthesesAndUnaryMinus) {
+    auto table = sampleTable();
+    Polinom expected = (table["a"] + table["b"]) * (table["c"] * -1.0) - table["d"];
+    EXPECT_EQ(Expression("(a + b) * -c - d").evaluate(table), expected);
+}
+
+TEST(Expression, ConstantsScale) {
+    auto table = sampleTable();
+    EXPECT_EQ(Expression("2*a - a*0.5").evaluate(table), table["a"] * 1.5);
+    EXPECT_EQ(Expression("3").evaluate(table), Polinom("3"));
+}
+
+TEST(Expression, SharesCommonSubexpressions) {
+    Expression e("a*b + b*a + (a*b)*c");
+    // a, b, a*b, a*b + a*b, c, (a*b)*c, root
+    EXPECT_EQ(e.size(), 7u);
+    EXPECT_EQ(e.getNodes().back().op, ExprNode::Op::Add);
+}
+
+TEST(Expression, ChildrenPrecedeParents) {
+    Expression e("(a - b) * (c + d) - -a");
+    const auto& nodes = e.getNodes();
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        EXPECT_LT(nodes[i].lhs, static_cast<int>(i));
+        EXPECT_LT(nodes[i].rhs, static_cast<int>(i));
+    }
+}
+
+TEST(Expression, ThrowsOnSyntaxErrors) {
+    EXPECT_THROW(Expression("a +"), std::runtime_error);
+    EXPECT_THROW(Expression("(a + b"), std::runtime_error);
+    EXPECT_THROW(Expression("a $ b"), std::runtime_error);
+    EXPECT_THROW(Expression("a b"), std::runtime_error);
+}
+
+TEST(Expression, ThrowsOnUnknownPolinom) {
+    auto table = sampleTable();
+    EXPECT_THROW(Expression("a + missing").evaluate(table), std::runtime_error);
+}
+
+TEST(Expression, AcceptsCustomResolver) {
+    int calls = 0;
+    auto resolve = [&](const std::string& name) {
+        ++calls;
+        return Polinom(name == "p" ? "x+1" : "y");
+    };
+    Polinom result = Expression("p*p + q").evaluate(resolve);
+    EXPECT_EQ(result, Polinom("x^2+2x+1+y"));
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(Expression, ResultUsesDefaultResource) {
+    auto table = sampleTable();
+    Polinom result = Expression("a*b*c").evaluate(table);
+    EXPECT_EQ(result.getResource(), std::pmr::get_default_resource());
+}
+
+TEST(ExpressionParallel, MatchesSerialEvaluation) {
+    auto table = sampleTable();
+    TaskScheduler pool(4);
+    const char* sources[] = {
+        "a*b + c*d",
+        "(a + b) * (c - d) - a*a",
+        "a*b*c*d - -(a + b + c + d)",
+        "a",
+        "2*(a*b + b*a) - 0.5*c",
+    };
+    for (const char* source : sources) {
+        Expression e(source);
+        EXPECT_EQ(e.evaluate(table, pool), e.evaluate(table)) << source;
+    }
+}
+
+TEST(ExpressionParallel, RepeatedEvaluationsAreStable) {
+    auto table = sampleTable();
+    TaskScheduler pool(3);
+    Expression e("(a*b + c*d) * (a - d) + b*c");
+    Polinom expected = e.evaluate(table);
+    for (int i = 0; i < 50; ++i)
+        EXPECT_EQ(e.evaluate(table, pool), expected);
+}
+
+TEST(ExpressionParallel, PropagatesExceptions) {
+    auto table = sampleTable();
+    TaskScheduler pool(2);
+    EXPECT_THROW(Expression("a*b + missing").evaluate(table, pool), std::runtime_error);
+    // Degree overflow inside a worker surfaces on the caller as well.
+    table["big"] = Polinom("x^9");
+    EXPECT_THROW(Expression("big*a").evaluate(table, pool), std::runtime_error);
+    EXPECT_EQ(Expression("a*b").evaluate(table, pool), table["a"] * table["b"]);
+}
+
+TEST(ExpressionParallel, FallsBackToSerialOnWorkerThread) {
+    auto table = sampleTable();
+    TaskScheduler pool(1);
+    std::atomic<bool> done{ false };
+    Polinom inside;
+    pool.submit([&] {
+        inside = Expression("a*b").evaluate(table, pool);
+        done = true;
+    });
+    while (!done)
+        std::this_thread::yield();
+    EXPECT_EQ(inside, table["a"] * table["b"]);
+}
@@ -0,0 +1,89 @@
+#include "fft.h"
+#include "test_operands.h"
+#include <gtest.h>
+#include <random>
+
+static std::vector<double> schoolbook(const std::vector<double>& a, const std::vector<double>& b) {
+    std::vector<double> out(a.size() + b.size() - 1, 0.0);
+    schoolbookMultiply(a.data(), a.size(), b.data(), b.size(), out.data());
+    return out;
+}
+
+TEST(Fft, IntegerConvolutionIsExact) {
+    std::mt19937 rng(11);
+    const size_t lengths[][2] = { { 1, 1 }, { 2, 3 }, { 17, 5 }, { 256, 256 }, { 1000, 999 }, { 4000, 3000 } };
+    for (const auto& len : lengths) {
+        std::vector<double> a(len[0]), b(len[1]);
+        for (double& v : a)
+            v = static_cast<double>(rng() % 200001) - 100000.0;
+        for (double& v : b)
+            v = static_cast<double>(rng() % 2001) - 1000.0;
+        FftConvolution conv = fftConvolve(a, b);
+        EXPECT_EQ(conv.error, 0.0) << len[0] << " x " << len[1];
+        EXPECT_EQ(conv.values, schoolbook(a, b)) << len[0] << " x " << len[1];
+    }
+}
+
+TEST(Fft, DyadicFractionsAreExact) {
+    std::vector<double> a = { 0.5, -0.25, 3.125, 0.0, 7.0 }, b = { 1.5, 0.0625, -2.0 };
+    FftConvolution conv = fftConvolve(a, b);
+    EXPECT_EQ(conv.error, 0.0);
+    EXPECT_EQ(conv.values, schoolbook(a, b));
+}
+
+TEST(Fft, ErrorEstimateBoundsTheActualError) {
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> coeff(-1.0, 1.0);
+    for (size_t n : { 10, 300, 2000 }) {
+        std::vector<double> a(n), b(n + 7);
+        for (double& v : a)
+            v = coeff(rng);
+        for (double& v : b)
+            v = coeff(rng) * 1e3;
+        FftConvolution conv = fftConvolve(a, b);
+        std::vector<double> expected = schoolbook(a, b);
+        double worst = 0;
+        for (size_t i = 0; i < expected.size(); ++i)
+            worst = std::max(worst, std::fabs(conv.values[i] - expected[i]));
+        EXPECT_GT(conv.error, 0.0);
+        // The schoolbook reference carries its own rounding, n ulps at most.
+        EXPECT_LE(worst, conv.error + 1e3 * n * std::numeric_limits<double>::epsilon()) << n;
+        EXPECT_LT(conv.error, 1e-3) << n;
+    }
+}
+
+TEST(Fft, MultiplyMatchesPolinomMultiply) {
+    for (unsigned seed = 1; seed < 12; ++seed) {
+        Polinom a = randomOperand(seed, static_cast<int>(seed) * 9, 4, 1.0);
+        Polinom b = randomOperand(seed + 50, 40, 5, 0.5);
+        FftProduct product = multiplyFft(a, b);
+        EXPECT_FALSE(product.fellBack);
+        EXPECT_EQ(product.error, 0.0);
+        EXPECT_EQ(product.product, a * b);
+    }
+    EXPECT_EQ(multiplyFft(Polinom("x+1"), Polinom("x-1")).product, Polinom("x^2-1"));
+}
+
+TEST(Fft, FallsBackWhenTheEstimateExceedsTheTolerance) {
+    Polinom a = randomOperand(3, 50, 4, 0.1), b = randomOperand(4, 50, 4, 0.3);
+    FftProduct loose = multiplyFft(a, b);
+    EXPECT_FALSE(loose.fellBack);
+    EXPECT_GT(loose.error, 0.0);
+    EXPECT_EQ(loose.product, a * b);
+
+    FftProduct strict = multiplyFft(a, b, 0.0);
+    EXPECT_TRUE(strict.fellBack);
+    EXPECT_EQ(strict.error, loose.error);
+    EXPECT_EQ(strict.product, a * b);
+}
+
+TEST(Fft, MultiplyHandlesEdgeCases) {
+    EXPECT_TRUE(multiplyFft(Polinom(), Polinom("x")).product.empty());
+    EXPECT_TRUE(fftConvolve({}, { 1.0 }).values.empty());
+    EXPECT_ANY_THROW(multiplyFft(Polinom("z^7"), Polinom("z^3")));
+    EXPECT_EQ(multiplyFft(Polinom("3"), Polinom("2z^9")).product, Polinom("6z^9"));
+    EXPECT_TRUE(multiplyFft(Polinom("x-x"), Polinom("y")).product.empty());
+    std::pmr::monotonic_buffer_resource arena;
+    FftProduct p = multiplyFft(randomOperand(3, 60, 4, 1.0), randomOperand(4, 60, 4, 1.0), 1e-10, &arena);
+    EXPECT_EQ(p.product.getResource(), &arena);
+}
@@ -0,0 +1,89 @@
+#include "formatter.h"
+#include <gtest.h>
+#include <cstring>
+#include <map>
+#include <random>
+#include <sstream>
+
+TEST(Formatter, MatchesStreamOutputForSimpleCoefficients) {
+    Polinom p("2x^6y^7z^8-3x^5y^4z^3+xyz-z+4");
+    std::ostringstream os;
+    os << p;
+    EXPECT_EQ(formatPolinom(p), os.str());
+}
+
+TEST(Formatter, FormatsZeroPolinom) {
+    EXPECT_EQ(formatPolinom(Polinom()), "0");
+}
+
+TEST(Formatter, FormatsConstantOne) {
+    EXPECT_EQ(formatPolinom(Polinom("1")), "1");
+    EXPECT_EQ(formatPolinom(Polinom("-1")), "-1");
+}
+
+TEST(Formatter, UsesShortestRoundTripRepresentation) {
+    EXPECT_EQ(formatPolinom(Polinom("0.1x")), "0.1x");
+    EXPECT_EQ(formatPolinom(Polinom("3.14159265358979x^2")), "3.14159265358979x^2");
+}
+
+TEST(Formatter, FixedPrecision) {
+    FormatOptions opts;
+    opts.precision = 2;
+    EXPECT_EQ(formatPolinom(Polinom("3.14159x^2-2.5"), opts), "3.14x^2-2.50");
+}
+
+TEST(Formatter, RoundTripWithParserIsExact) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> degree(0, 999);
+    std::uniform_real_distribution<double> coeff(-1e6, 1e6);
+    for (int iter = 0; iter < 200; ++iter) {
+        std::vector<Monom> monoms;
+        for (int i = 0; i < 20; ++i)
+            monoms.emplace_back(degree(rng), coeff(rng) / (i + 1));
+        Polinom p(std::move(monoms));
+        Polinom q(formatPolinom(p));
+        ASSERT_EQ(p.size(), q.size());
+        for (size_t i = 0; i < p.size(); ++i) {
+            EXPECT_EQ(p.getMonoms()[i].degree, q.getMonoms()[i].degree);
+            EXPECT_EQ(p.getMonoms()[i].coeff, q.getMonoms()[i].coeff);
+        }
+    }
+}
+
+TEST(Formatter, RoundTripsExtremeMagnitudes) {
+    std::vector<Monom> monoms = { Monom(999, 1e300), Monom(5, 2.5e-9), Monom(0, -123456789.125) };
+    Polinom p(monoms);
+    std::string text = formatPolinom(p);
+    Polinom q(text);
+    ASSERT_EQ(q.size(), 3);
+    EXPECT_EQ(q.getMonoms()[0].coeff, 1e300);
+    EXPECT_EQ(q.getMonoms()[1].coeff, 2.5e-9);
+    EXPECT_EQ(q.getMonoms()[2].coeff, -123456789.125);
+}
+
+TEST(Formatter, ReportsSmallBuffer) {
+    Polinom p("2x^6y^7z^8+3x^5y^4z^3");
+    char buf[8];
+    std::to_chars_result r = formatPolinom(buf, buf + sizeof(buf), p);
+    EXPECT_EQ(r.ec, std::errc::value_too_large);
+}
+
+TEST(Formatter, WritesIntoCallerBuffer) {
+    Polinom p("x^2+1");
+    char buf[32];
+    std::to_chars_result r = formatPolinom(buf, buf + sizeof(buf), p);
+    ASSERT_EQ(r.ec, std::errc());
+    EXPECT_EQ(std::string(buf, r.ptr), "x^2+1");
+}
+
+TEST(Formatter, BatchesWholeTable) {
+    std::map<std::string, Polinom> table;
+    table["a"] = Polinom("x+1");
+    table["b"] = Polinom("-y^2");
+    PolinomFormatter f;
+    f.appendTable(table);
+    std::ostringstream os;
+    f.flush(os);
+    EXPECT_EQ(os.str(), "a = x+1\nb = -y^2\n");
+    EXPECT_EQ(f.size(), 0);
+}
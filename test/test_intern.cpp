@@ -0,0 +1,119 @@
+#include "intern.h"
+#include <gtest.h>
+#include <thread>
+
+static Polinom makeLongPolinom(double scale) {
+    std::vector<Monom> terms;
+    for (int d = 0; d < 50; ++d)
+        terms.emplace_back(d * 7 % 1000, scale * (d + 1));
+    return Polinom(terms);
+}
+
+TEST(PolinomCopyOnWrite, CopySharesSpilledTerms) {
+    Polinom a = makeLongPolinom(1.0);
+    Polinom b(a);
+    EXPECT_TRUE(b.sharesTermsWith(a));
+    EXPECT_TRUE(a.getMonoms().isShared());
+    Polinom c;
+    c = a;
+    EXPECT_TRUE(c.sharesTermsWith(a));
+}
+
+TEST(PolinomCopyOnWrite, InlineCopiesDoNotShare) {
+    Polinom a("x+1");
+    Polinom b(a);
+    EXPECT_FALSE(b.sharesTermsWith(a));
+    EXPECT_EQ(a, b);
+}
+
+TEST(PolinomCopyOnWrite, CopyFromOtherResourceDoesNotShare) {
+    std::pmr::monotonic_buffer_resource arena;
+    Polinom a(makeLongPolinom(1.0), &arena);
+    Polinom b(a);
+    EXPECT_FALSE(b.sharesTermsWith(a));
+    EXPECT_EQ(a, b);
+}
+
+TEST(PolinomCopyOnWrite, MutationDetachesSharedTerms) {
+    Polinom a = makeLongPolinom(1.0);
+    Polinom b(a);
+    b = b * 2.0 + a;
+    EXPECT_FALSE(b.sharesTermsWith(a));
+    EXPECT_FALSE(a.getMonoms().isShared());
+    EXPECT_EQ(b, makeLongPolinom(3.0));
+    EXPECT_EQ(a, makeLongPolinom(1.0));
+}
+
+TEST(SmallVectorCopyOnWrite, WriteThroughCopyLeavesOriginal) {
+    SmallVector<int, 2> v;
+    for (int i = 0; i < 10; ++i)
+        v.push_back(i);
+    SmallVector<int, 2> w(v);
+    EXPECT_TRUE(w.isShared());
+    w[0] = 42;
+    EXPECT_FALSE(w.isShared());
+    EXPECT_FALSE(v.isShared());
+    EXPECT_EQ(v[0], 0);
+    EXPECT_EQ(w[0], 42);
+    w.push_back(10);
+    EXPECT_EQ(v.size(), 10);
+}
+
+TEST(SmallVectorCopyOnWrite, ClearDropsShare) {
+    SmallVector<int, 2> v;
+    for (int i = 0; i < 10; ++i)
+        v.push_back(i);
+    SmallVector<int, 2> w(v);
+    w.clear();
+    EXPECT_TRUE(w.empty());
+    EXPECT_FALSE(v.isShared());
+    EXPECT_EQ(v.size(), 10);
+}
+
+TEST(SmallVectorCopyOnWrite, SharedCopiesAcrossThreads) {
+    SmallVector<int, 2> v;
+    for (int i = 0; i < 100; ++i)
+        v.push_back(i);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&v] {
+            for (int i = 0; i < 10000; ++i) {
+                SmallVector<int, 2> copy(v);
+                if (i % 7 == 0)
+                    copy[0] = i;
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    EXPECT_FALSE(v.isShared());
+    EXPECT_EQ(v[0], 0);
+}
+
+TEST(PolinomHash, IdenticalPolinomsHashEqual) {
+    EXPECT_EQ(Polinom("x^2+3y-1").hash(), Polinom("3y+x^2-1").hash());
+    EXPECT_NE(Polinom("x^2+3y-1").hash(), Polinom("x^2+3y-2").hash());
+    EXPECT_TRUE(Polinom("x^2+3y-1").identical(Polinom("3y-1+x^2")));
+    EXPECT_FALSE(Polinom("x").identical(Polinom("x+1")));
+}
+
+TEST(PolinomInterner, DuplicatesShareOneBody) {
+    PolinomInterner interner;
+    Polinom a = interner.intern(makeLongPolinom(1.0));
+    Polinom b = interner.intern(makeLongPolinom(1.0));
+    Polinom c = interner.intern(makeLongPolinom(2.0));
+    EXPECT_TRUE(a.sharesTermsWith(b));
+    EXPECT_FALSE(a.sharesTermsWith(c));
+    EXPECT_EQ(interner.size(), 2);
+    EXPECT_TRUE(interner.contains(makeLongPolinom(2.0)));
+    EXPECT_FALSE(interner.contains(makeLongPolinom(4.0)));
+}
+
+TEST(PolinomInterner, CanonicalisesInlinePolinoms) {
+    PolinomInterner interner;
+    interner.intern(Polinom("x+1"));
+    interner.intern(Polinom("1+x"));
+    EXPECT_EQ(interner.size(), 1);
+    interner.clear();
+    EXPECT_EQ(interner.size(), 0);
+}
@@ -0,0 +1,82 @@
+#include "kronecker.h"
+#include "test_operands.h"
+#include <gtest.h>
+#include <random>
+
+TEST(Kronecker, LayoutPacksInMonomOrder) {
+    Polinom a("x^2y^3+z"), b("x^4z^5+y");
+    KroneckerLayout layout = KroneckerLayout::forProduct(a, b);
+    EXPECT_EQ(layout.base[0], 7);
+    EXPECT_EQ(layout.base[1], 5);
+    EXPECT_EQ(layout.base[2], 7);
+    for (int x = 0; x < 7; ++x)
+        for (int y = 0; y < 5; ++y)
+            for (int z = 0; z < 7; ++z) {
+                int degree = x * 100 + y * 10 + z;
+                EXPECT_EQ(layout.unpack(layout.pack(degree)), degree);
+            }
+    EXPECT_LT(layout.pack(14), layout.pack(20));
+    EXPECT_LT(layout.pack(246), layout.pack(300));
+}
+
+TEST(Kronecker, LayoutRejectsOverflow) {
+    EXPECT_ANY_THROW(KroneckerLayout::forProduct(Polinom("x^5"), Polinom("x^5")));
+    EXPECT_NO_THROW(KroneckerLayout::forProduct(Polinom("x^5"), Polinom("x^4")));
+}
+
+TEST(Kronecker, KaratsubaMatchesSchoolbook) {
+    std::mt19937 rng(7);
+    const size_t lengths[][2] = { { 1, 1 }, { 31, 31 }, { 32, 32 }, { 33, 40 }, { 64, 64 }, { 100, 37 },
+        { 257, 255 }, { 500, 33 }, { 1000, 1000 } };
+    for (const auto& len : lengths) {
+        std::vector<double> a(len[0]), b(len[1]);
+        for (double& v : a)
+            v = static_cast<double>(rng() % 21) - 10.0;
+        for (double& v : b)
+            v = static_cast<double>(rng() % 21) - 10.0;
+        std::vector<double> expected(a.size() + b.size() - 1, 0.0), actual(expected.size(), 0.0);
+        schoolbookMultiply(a.data(), a.size(), b.data(), b.size(), expected.data());
+        karatsubaMultiply(a.data(), a.size(), b.data(), b.size(), actual.data());
+        // Integer inputs keep every intermediate exact.
+        EXPECT_EQ(actual, expected) << len[0] << " x " << len[1];
+    }
+}
+
+TEST(Kronecker, MultiplyMatchesPolinomMultiply) {
+    for (unsigned seed = 1; seed < 15; ++seed) {
+        Polinom a = randomOperand(seed, static_cast<int>(seed) * 9, 4);
+        Polinom b = randomOperand(seed + 100, 40, 5);
+        EXPECT_EQ(multiplyKronecker(a, b), a * b);
+        EXPECT_EQ(multiplyKronecker(b, a), a * b);
+    }
+    EXPECT_EQ(multiplyKronecker(Polinom("x+1"), Polinom("x-1")), Polinom("x^2-1"));
+    EXPECT_EQ(multiplyKronecker(Polinom("3"), Polinom("2z^9")), Polinom("6z^9"));
+}
+
+TEST(Kronecker, LargeNonIntegerCoefficientsGainNoTerms) {
+    // Integer operands multiply exactly, so their product gives the true
+    // support; the scaled operands have coefficients up to about 1e6.
+    const double sa = 48611.37, sb = 7919.13;
+    for (unsigned seed = 1; seed < 20; ++seed) {
+        Polinom ia = randomOperand(seed, 20 + static_cast<int>(seed), 4);
+        Polinom ib = randomOperand(seed + 50, 60, 4);
+        Polinom exact = ia * ib;
+        Polinom actual = multiplyKronecker(ia * sa, ib * sb);
+        ASSERT_EQ(actual.size(), exact.size()) << "seed " << seed;
+        for (size_t i = 0; i < exact.size(); ++i) {
+            const Monom& e = exact.getMonoms()[i];
+            const Monom& m = actual.getMonoms()[i];
+            EXPECT_EQ(m.degree, e.degree);
+            EXPECT_NEAR(m.coeff, e.coeff * sa * sb, std::fabs(e.coeff * sa * sb) * 1e-9);
+        }
+    }
+}
+
+TEST(Kronecker, MultiplyHandlesEdgeCases) {
+    EXPECT_TRUE(multiplyKronecker(Polinom(), Polinom("x")).empty());
+    EXPECT_TRUE(multiplyKronecker(Polinom("x"), Polinom()).empty());
+    EXPECT_ANY_THROW(multiplyKronecker(Polinom("y^5"), Polinom("y^5")));
+    std::pmr::monotonic_buffer_resource arena;
+    Polinom p = multiplyKronecker(randomOperand(3, 60, 4), randomOperand(4, 60, 4), &arena);
+    EXPECT_EQ(p.getResource(), &arena);
+}
@@ -0,0 +1,153 @@
+#include "metrics.h"
+#include "polinomstore.h"
+#include "shardedstore.h"
+#include "expression.h"
+#include "nodepool.h"
+#include <gtest.h>
+
+TEST(Metrics, HistogramBucketsAreContiguous) {
+    for (size_t b = 1; b < metrics::Histogram::kBuckets; ++b)
+        EXPECT_EQ(metrics::Histogram::lowerBound(b), metrics::Histogram::upperBound(b - 1) + 1);
+    for (uint64_t v : { 0ull, 1ull, 15ull, 16ull, 17ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, ~0ull }) {
+        size_t b = metrics::Histogram::bucketOf(v);
+        EXPECT_LE(metrics::Histogram::lowerBound(b), v);
+        EXPECT_GE(metrics::Histogram::upperBound(b), v);
+    }
+    EXPECT_EQ(metrics::Histogram::bucketOf(~0ull), metrics::Histogram::kBuckets - 1);
+}
+
+TEST(Metrics, HistogramPercentilesAreWithinBucketPrecision) {
+    metrics::Histogram h;
+    for (uint64_t v = 1; v <= 10000; ++v)
+        h.record(v);
+    metrics::HistogramSnapshot s = h.snapshot();
+    EXPECT_EQ(s.count, 10000u);
+    EXPECT_EQ(s.min, 1u);
+    EXPECT_EQ(s.max, 10000u);
+    EXPECT_DOUBLE_EQ(s.mean, 5000.5);
+    EXPECT_NEAR(double(s.p50), 5000.0, 5000.0 / 16);
+    EXPECT_NEAR(double(s.p99), 9900.0, 9900.0 / 16);
+    EXPECT_LE(s.p999, s.max);
+    EXPECT_LE(s.p50, s.p90);
+    EXPECT_LE(s.p90, s.p99);
+
+    h.reset();
+    EXPECT_EQ(h.count(), 0u);
+    EXPECT_EQ(h.percentile(0.5), 0u);
+}
+
+#if POLINOM_METRICS
+
+TEST(Metrics, CountsPolinomOperations) {
+    Polinom a("z^2+z+1"), b("z-2");
+    metrics::reset();
+
+    Polinom sum = a + b;
+    Polinom diff = a - b;
+    Polinom product = a * b;
+    Polinom scaled = a * 2.0;
+    Polinom parsed("3x^2y^2z^2");
+
+    metrics::Snapshot s = metrics::snapshot();
+    EXPECT_EQ(s[metrics::Counter::Merges], 2u);
+    EXPECT_EQ(s[metrics::Op::Add].count, 1u);
+    EXPECT_EQ(s[metrics::Op::Subtract].count, 1u);
+    EXPECT_EQ(s[metrics::Op::Multiply].count, 1u);
+    EXPECT_EQ(s[metrics::Op::Scale].count, 1u);
+    EXPECT_EQ(s[metrics::Op::Parse].count, 1u);
+    // 5 + 5 merged, 3 * 2 pairs, 3 scaled, 1 parsed.
+    EXPECT_EQ(s[metrics::Counter::MonomsProcessed], 5u + 5u + 6u + 3u + 1u);
+    // Six pairs land in the [4, 8) bucket.
+    EXPECT_EQ(s.multiplyByPairs[2], 1u);
+}
+
+TEST(Metrics, CountsTermAllocations) {
+    metrics::reset();
+    Polinom small("x+y+z");
+    EXPECT_EQ(metrics::snapshot()[metrics::Counter::TermAllocations], 0u);
+
+    std::string big;
+    for (int d = 0; d < 100; ++d)
+        big += "+" + std::to_string(d + 1) + "x^" + std::to_string(d / 100) + "y^" + std::to_string(d / 10 % 10)
+            + "z^" + std::to_string(d % 10);
+    Polinom large(big);
+    metrics::Snapshot s = metrics::snapshot();
+    EXPECT_GT(s[metrics::Counter::TermAllocations], 0u);
+    EXPECT_GE(s[metrics::Counter::TermBytesAllocated], 100 * sizeof(Monom));
+}
+
+TEST(Metrics, CountsPoolChunks) {
+    metrics::reset();
+    NodePool pool(32, 8, 4);
+    for (int i = 0; i < 4; ++i)
+        pool.allocate();
+    EXPECT_EQ(metrics::snapshot()[metrics::Counter::PoolChunks], 1u);
+    pool.allocate();
+    EXPECT_EQ(metrics::snapshot()[metrics::Counter::PoolChunks], 2u);
+}
+
+TEST(Metrics, CountsStoreHitsAndMisses) {
+    PolinomStore store;
+    ShardedPolinomStore sharded;
+    metrics::reset();
+
+    store.insertOrAssign("p", Polinom("x"));
+    sharded.insert("q", Polinom("y"));
+    EXPECT_TRUE(store.contains("p"));
+    EXPECT_FALSE(store.contains("q"));
+    EXPECT_TRUE(sharded.find("q").has_value());
+    EXPECT_FALSE(sharded.find("p").has_value());
+    EXPECT_TRUE(store.erase("p"));
+
+    metrics::Snapshot s = metrics::snapshot();
+    EXPECT_EQ(s[metrics::Counter::StoreInserts], 2u);
+    EXPECT_EQ(s[metrics::Counter::StoreLookups], 4u);
+    EXPECT_EQ(s[metrics::Counter::StoreHits], 2u);
+    EXPECT_EQ(s[metrics::Counter::StoreMisses], 2u);
+    EXPECT_EQ(s[metrics::Counter::StoreErases], 1u);
+    EXPECT_EQ(s[metrics::Op::StoreLookup].count, 4u);
+    EXPECT_EQ(s[metrics::Op::StoreWrite].count, 3u);
+}
+
+TEST(Metrics, TimesExpressionEvaluation) {
+    std::map<std::string, Polinom> table{ { "a", Polinom("z+1") }, { "b", Polinom("z-1") } };
+    Expression e("a*b+a");
+    metrics::reset();
+    e.evaluate(table);
+    metrics::Snapshot s = metrics::snapshot();
+    EXPECT_EQ(s[metrics::Op::Evaluate].count, 1u);
+    EXPECT_EQ(s[metrics::Op::Multiply].count, 1u);
+    EXPECT_EQ(s[metrics::Op::Add].count, 1u);
+}
+
+TEST(Metrics, ExportsTextAndJson) {
+    metrics::reset();
+    Polinom p = Polinom("z+1") * Polinom("z^2+1");
+    metrics::Snapshot s = metrics::snapshot();
+
+    std::string text = s.toText();
+    EXPECT_NE(text.find("merges 0\n"), std::string::npos);
+    EXPECT_NE(text.find("multiply_calls pairs>=4 1\n"), std::string::npos);
+    EXPECT_NE(text.find("latency_ns multiply count=1"), std::string::npos);
+
+    std::string json = s.toJson();
+    EXPECT_NE(json.find("\"enabled\": true"), std::string::npos);
+    EXPECT_NE(json.find("\"monoms_processed\": "), std::string::npos);
+    EXPECT_NE(json.find("{ \"min_pairs\": 4, \"calls\": 1 }"), std::string::npos);
+    EXPECT_NE(json.find("\"multiply\": { \"count\": 1,"), std::string::npos);
+    EXPECT_EQ(json.find("\"store_lookup\""), std::string::npos);
+}
+
+TEST(Metrics, ResetClearsEverything) {
+    Polinom p = Polinom("x") + Polinom("y");
+    metrics::reset();
+    metrics::Snapshot s = metrics::snapshot();
+    for (uint64_t c : s.counters)
+        EXPECT_EQ(c, 0u);
+    for (uint64_t c : s.multiplyByPairs)
+        EXPECT_EQ(c, 0u);
+    for (const auto& h : s.latency)
+        EXPECT_EQ(h.count, 0u);
+}
+
+#endif
@@ -0,0 +1,140 @@
+#include "modint.h"
+#include "polinom.h"
+#include "test_operands.h"
+#include <gtest.h>
+#include <random>
+#include <sstream>
+
+using M = ModInt61;
+using ModPolinom = BasicPolinom<M>;
+static constexpr uint64_t kMod = M::modulus;
+
+// Reference arithmetic by shift and add, so it needs no 128-bit type and
+// shares nothing with the Montgomery code under test. Inputs are below
+// kMod < 2^62, so sums never overflow.
+static uint64_t addMod(uint64_t a, uint64_t b) {
+    uint64_t s = a + b;
+    return s >= kMod ? s - kMod : s;
+}
+
+static uint64_t mulMod(uint64_t a, uint64_t b) {
+    uint64_t r = 0;
+    for (a %= kMod; b; b >>= 1) {
+        if (b & 1)
+            r = addMod(r, a);
+        a = addMod(a, a);
+    }
+    return r;
+}
+
+// The shared double operand with its integer coefficients spread over the
+// whole ring, so products wrap around the modulus.
+static ModPolinom randomModOperand(uint64_t seed, int terms, int maxPower) {
+    const M spread(1234567890123456789);
+    Polinom source = randomOperand(seed, terms, maxPower);
+    std::vector<BasicMonom<M>> monoms;
+    for (const Monom& m : source.getMonoms())
+        monoms.emplace_back(m.degree, M(static_cast<int64_t>(m.coeff)) * spread);
+    return ModPolinom(monoms);
+}
+
+TEST(ModInt, ArithmeticMatchesWideReference) {
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < 1000; ++i) {
+        uint64_t a = rng() % kMod, b = rng() % kMod;
+        M x(static_cast<int64_t>(a)), y(static_cast<int64_t>(b));
+        EXPECT_EQ(x.get(), a);
+        EXPECT_EQ((x + y).get(), addMod(a, b));
+        EXPECT_EQ((x - y).get(), addMod(a, kMod - b));
+        EXPECT_EQ((x * y).get(), mulMod(a, b));
+    }
+}
+
+TEST(ModInt, NegativeValuesReduceIntoRange) {
+    EXPECT_EQ(M(-1).get(), kMod - 1);
+    EXPECT_EQ(M(-1).signedValue(), -1);
+    EXPECT_EQ(M(-static_cast<int64_t>(kMod)).get(), 0u);
+    EXPECT_EQ(M(INT64_MIN).get(), (kMod * 8 - (uint64_t(1) << 63)) % kMod);
+    EXPECT_TRUE(M(-5).isNegative());
+    EXPECT_FALSE(M(5).isNegative());
+    EXPECT_EQ(-M(5), M(-5));
+    EXPECT_EQ(M(3) - M(5), M(-2));
+}
+
+TEST(ModInt, InverseAndDivision) {
+    for (int64_t v : { int64_t(1), int64_t(2), int64_t(12345), int64_t(-7), int64_t(kMod - 1) }) {
+        EXPECT_EQ(M(v) * M(v).inverse(), M(1));
+        EXPECT_EQ(M(v) / M(v), M(1));
+    }
+    EXPECT_EQ(M(2).pow(61), M(1));
+    EXPECT_THROW(M(0).inverse(), std::domain_error);
+}
+
+TEST(ModInt, ParseAndPrintRoundTrip) {
+    size_t end = 0;
+    M parsed = M::parse("2305843009213693953x", 0, end);  // 2^61 + 1
+    EXPECT_EQ(end, 19u);
+    EXPECT_EQ(parsed, M(2));
+    EXPECT_THROW(M::parse("x", 0, end), std::invalid_argument);
+
+    std::ostringstream os;
+    os << M(-42) << ' ' << M(42);
+    EXPECT_EQ(os.str(), "-42 42");
+}
+
+TEST(ModInt, AccumulatorReducesOnceAtTheEnd) {
+    std::mt19937_64 rng(11);
+    ModAccumulator<kMod> acc{};
+    M expected;
+    for (int i = 0; i < 10000; ++i) {
+        M a(static_cast<int64_t>(rng() % kMod)), b(static_cast<int64_t>(rng() % kMod));
+        acc.add(a, b);
+        expected += a * b;
+    }
+    EXPECT_EQ(acc.reduce(), expected);
+
+    ModAccumulator<kMod> other{};
+    other.add(M(-1), M(1));
+    acc.merge(other);
+    EXPECT_EQ(acc.reduce(), expected - M(1));
+}
+
+TEST(ModPolinom, ParsesAndPrintsExactly) {
+    ModPolinom p("3x^2y - 2z + 5");
+    std::ostringstream os;
+    os << p * ModPolinom("x - 1");
+    EXPECT_EQ(os.str(), "3x^3y-3x^2y-2xz+5x+2z-5");
+    EXPECT_TRUE((p - p).empty());
+}
+
+TEST(ModPolinom, CoefficientsWrapAroundExactly) {
+    // 2^61 - 2 is -1 mod p, so the x terms cancel to an exact zero.
+    ModPolinom sum = ModPolinom("2305843009213693950x + 1") + ModPolinom("x");
+    EXPECT_EQ(sum, ModPolinom("1"));
+    EXPECT_TRUE((ModPolinom("x^2 + 1") - ModPolinom("x^2 + 1")).empty());
+}
+
+TEST(ModPolinom, AllKernelsAgree) {
+    using Strategy = ModPolinom::MultiplyStrategy;
+    for (unsigned seed = 0; seed < 8; ++seed) {
+        ModPolinom a = randomModOperand(seed, 40, 4), b = randomModOperand(seed + 100, 40, 4);
+        ModPolinom dense = a.multiply(b, std::pmr::get_default_resource(), Strategy::Dense);
+        EXPECT_EQ(a.multiply(b, std::pmr::get_default_resource(), Strategy::Heap), dense);
+        EXPECT_EQ(a.multiply(b, std::pmr::get_default_resource(), Strategy::Hash), dense);
+        EXPECT_EQ(a * b, dense);
+        EXPECT_EQ(a.multiplyParallel(b, 4, std::pmr::get_default_resource()), dense);
+    }
+}
+
+TEST(ModPolinom, ProductMatchesWideReference) {
+    ModPolinom a = randomModOperand(1, 30, 3), b = randomModOperand(2, 30, 3);
+    std::vector<uint64_t> expected(1000, 0);
+    for (const auto& x : a.getMonoms())
+        for (const auto& y : b.getMonoms()) {
+            uint64_t& slot = expected[static_cast<size_t>(x.degree + y.degree)];
+            slot = addMod(slot, mulMod(x.coeff.get(), y.coeff.get()));
+        }
+    ModPolinom product = a * b;
+    for (const auto& m : product.getMonoms())
+        EXPECT_EQ(m.coeff.get(), expected[static_cast<size_t>(m.degree)]);
+}
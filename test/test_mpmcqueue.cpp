@@ -0,0 +1,249 @@
+#include "mpmcqueue.h"
+#include <gtest.h>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+TEST(MPMCQueue, RejectsCapacityThatIsNotPowerOfTwo) {
+    EXPECT_THROW(MPMCQueue<int>(0), std::invalid_argument);
+    EXPECT_THROW(MPMCQueue<int>(6), std::invalid_argument);
+    EXPECT_NO_THROW(MPMCQueue<int>(8));
+}
+
+TEST(MPMCQueue, IsFifoAndBounded) {
+    MPMCQueue<int> q(4);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(q.tryPush(i));
+    EXPECT_FALSE(q.tryPush(99));
+    EXPECT_EQ(q.sizeApprox(), 4u);
+    int v = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(q.tryPop(v));
+        EXPECT_EQ(v, i);
+    }
+    EXPECT_FALSE(q.tryPop(v));
+}
+
+TEST(MPMCQueue, WrapsAroundManyTimes) {
+    MPMCQueue<int> q(2);
+    int v = 0;
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(q.tryPush(i));
+        ASSERT_TRUE(q.tryPop(v));
+        EXPECT_EQ(v, i);
+    }
+}
+
+TEST(MPMCQueue, BatchesTransferPartially) {
+    MPMCQueue<int> q(8);
+    std::vector<int> in(10);
+    std::iota(in.begin(), in.end(), 0);
+    EXPECT_EQ(q.tryPushBatch(in.begin(), in.size()), 8u);
+    std::vector<int> out;
+    EXPECT_EQ(q.tryPopBatch(std::back_inserter(out), 3), 3u);
+    EXPECT_EQ(q.tryPopBatch(std::back_inserter(out), 100), 5u);
+    EXPECT_EQ(out, std::vector<int>(in.begin(), in.begin() + 8));
+    EXPECT_EQ(q.tryPopBatch(std::back_inserter(out), 1), 0u);
+}
+
+TEST(MPMCQueue, DestroysRemainingItems) {
+    auto tracker = std::make_shared<int>(0);
+    {
+        MPMCQueue<std::shared_ptr<int>> q(4);
+        q.tryPush(tracker);
+        q.tryPush(tracker);
+        EXPECT_EQ(tracker.use_count(), 3);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+}
+
+namespace {
+
+// Copying or moving a negative value throws, as an allocation might.
+struct Fragile {
+    int value = 0;
+    Fragile() = default;
+    explicit Fragile(int v) : value(v) {}
+    Fragile(const Fragile& o) : value(o.value) { check(); }
+    Fragile(Fragile&& o) : value(o.value) { check(); }
+    Fragile& operator=(const Fragile&) = default;
+    Fragile& operator=(Fragile&&) = default;
+    void check() const {
+        if (value < 0)
+            throw std::runtime_error("copy failed");
+    }
+};
+
+}
+
+TEST(MPMCQueue, ThrowingConstructionDoesNotStallConsumers) {
+    MPMCQueue<Fragile> q(4);
+    EXPECT_THROW(q.tryPush(Fragile(-1)), std::runtime_error);
+    EXPECT_TRUE(q.tryPush(Fragile(1)));
+    Fragile out;
+    ASSERT_TRUE(q.tryPop(out));
+    EXPECT_EQ(out.value, 1);
+    EXPECT_FALSE(q.tryPop(out));
+
+    std::vector<Fragile> in;
+    in.reserve(4);
+    for (int v : { 2, 3, -4, 5 })
+        in.emplace_back(v);
+    EXPECT_THROW(q.tryPushBatch(in.begin(), in.size()), std::runtime_error);
+    std::vector<Fragile> got;
+    EXPECT_EQ(q.tryPopBatch(std::back_inserter(got), 8), 2u);
+    ASSERT_EQ(got.size(), 2u);
+    EXPECT_EQ(got[0].value, 2);
+    EXPECT_EQ(got[1].value, 3);
+    EXPECT_EQ(q.tryPopBatch(std::back_inserter(got), 8), 0u);
+
+    // Every cell has wrapped at least once and the queue still works.
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(q.tryPush(Fragile(i)));
+        ASSERT_TRUE(q.tryPop(out));
+        EXPECT_EQ(out.value, i);
+    }
+}
+
+TEST(BlockingQueue, PopSkipsItemWhoseConstructionThrew) {
+    BlockingQueue<Fragile> q(2);
+    std::thread producer([&] {
+        EXPECT_THROW(q.push(Fragile(-1)), std::runtime_error);
+        q.push(Fragile(7));
+        q.close();
+    });
+    Fragile out;
+    ASSERT_TRUE(q.pop(out));
+    EXPECT_EQ(out.value, 7);
+    EXPECT_FALSE(q.pop(out));
+    producer.join();
+}
+
+TEST(MPMCQueue, ConcurrentProducersAndConsumersLoseNothing) {
+    MPMCQueue<long> q(64);
+    const int producers = 4, consumers = 4, perProducer = 20000;
+    std::atomic<long> sum{ 0 };
+    std::atomic<int> popped{ 0 };
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < perProducer; ++i) {
+                long value = static_cast<long>(p) * perProducer + i;
+                while (!q.tryPush(value))
+                    std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            long v;
+            while (popped.load() < producers * perProducer) {
+                if (q.tryPop(v)) {
+                    sum += v;
+                    popped++;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    long n = static_cast<long>(producers) * perProducer;
+    EXPECT_EQ(popped.load(), n);
+    EXPECT_EQ(sum.load(), n * (n - 1) / 2);
+}
+
+TEST(BlockingQueue, PopWaitsForPush) {
+    BlockingQueue<int> q(2);
+    std::thread producer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        q.push(7);
+    });
+    int v = 0;
+    EXPECT_TRUE(q.pop(v));
+    EXPECT_EQ(v, 7);
+    producer.join();
+}
+
+TEST(BlockingQueue, PushWaitsForSpace) {
+    BlockingQueue<int> q(2);
+    q.push(1);
+    q.push(2);
+    std::thread consumer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        int v;
+        q.pop(v);
+    });
+    EXPECT_TRUE(q.push(3));
+    consumer.join();
+    EXPECT_EQ(q.sizeApprox(), 2u);
+}
+
+TEST(BlockingQueue, CloseDrainsThenStops) {
+    BlockingQueue<int> q(4);
+    q.push(1);
+    q.push(2);
+    q.close();
+    EXPECT_FALSE(q.push(3));
+    int v;
+    EXPECT_TRUE(q.pop(v));
+    EXPECT_TRUE(q.pop(v));
+    EXPECT_FALSE(q.pop(v));
+}
+
+TEST(BlockingQueue, CloseWakesBlockedConsumers) {
+    BlockingQueue<int> q(4);
+    std::vector<std::thread> consumers;
+    std::atomic<int> finished{ 0 };
+    for (int i = 0; i < 3; ++i) {
+        consumers.emplace_back([&] {
+            int v;
+            while (q.pop(v)) {}
+            finished++;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    q.close();
+    for (auto& c : consumers)
+        c.join();
+    EXPECT_EQ(finished.load(), 3);
+}
+
+TEST(BlockingQueue, BatchedTransferUnderContention) {
+    BlockingQueue<int> q(16);
+    const int producers = 3, perProducer = 10000;
+    std::atomic<long> sum{ 0 };
+    std::vector<std::thread> producerThreads, consumerThreads;
+    for (int p = 0; p < producers; ++p) {
+        producerThreads.emplace_back([&, p] {
+            std::vector<int> chunk(37);
+            for (int i = 0; i < perProducer; i += static_cast<int>(chunk.size())) {
+                size_t n = std::min(chunk.size(), static_cast<size_t>(perProducer - i));
+                for (size_t k = 0; k < n; ++k)
+                    chunk[k] = p * perProducer + i + static_cast<int>(k);
+                EXPECT_EQ(q.pushBatch(chunk.begin(), n), n);
+            }
+        });
+    }
+    for (int c = 0; c < 2; ++c) {
+        consumerThreads.emplace_back([&] {
+            std::vector<int> out;
+            while (q.popBatch(std::back_inserter(out), 8) > 0) {}
+            long local = 0;
+            for (int v : out)
+                local += v;
+            sum += local;
+        });
+    }
+    for (auto& t : producerThreads)
+        t.join();
+    q.close();
+    for (auto& t : consumerThreads)
+        t.join();
+    long n = static_cast<long>(producers) * perProducer;
+    EXPECT_EQ(sum.load(), n * (n - 1) / 2);
+}
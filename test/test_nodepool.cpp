@@ -0,0 +1,150 @@
+#include "nodepool.h"
+#include "tlist.h"
+#include <gtest.h>
+#include <cstdint>
+#include <set>
+#include <string>
+
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t bytesOutstanding = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t align) override {
+        ++allocations;
+        bytesOutstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+        ++deallocations;
+        bytesOutstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Hands out `budget` allocations, then throws bad_alloc.
+class LimitedResource : public std::pmr::memory_resource {
+public:
+    size_t budget;
+    explicit LimitedResource(size_t n) : budget(n) {}
+
+private:
+    void* do_allocate(size_t bytes, size_t align) override {
+        if (budget == 0)
+            throw std::bad_alloc();
+        --budget;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST(NodePool, BlocksAreDistinctAndAligned) {
+    NodePool pool(24, 32, 4);
+    std::set<void*> seen;
+    for (int i = 0; i < 100; ++i) {
+        void* p = pool.allocate();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 32, 0u);
+        EXPECT_TRUE(seen.insert(p).second);
+    }
+    EXPECT_EQ(pool.liveBlocks(), 100u);
+    EXPECT_EQ(pool.blockBytes(), 32u);
+}
+
+TEST(NodePool, FailedChunkAllocationLeavesCountUnchanged) {
+    LimitedResource limited(1);
+    NodePool pool(16, 8, 4, &limited);
+    for (int i = 0; i < 4; ++i)
+        pool.allocate();
+    EXPECT_THROW(pool.allocate(), std::bad_alloc);
+    EXPECT_EQ(pool.liveBlocks(), 4u);
+    EXPECT_EQ(pool.chunkCount(), 1u);
+    limited.budget = 1;
+    pool.allocate();
+    EXPECT_EQ(pool.liveBlocks(), 5u);
+}
+
+TEST(NodePool, ReusesFreedBlocks) {
+    NodePool pool(16, 8, 4);
+    void* a = pool.allocate();
+    void* b = pool.allocate();
+    pool.deallocate(a);
+    EXPECT_EQ(pool.allocate(), a);
+    pool.deallocate(b);
+    EXPECT_EQ(pool.allocate(), b);
+    EXPECT_EQ(pool.chunkCount(), 1u);
+}
+
+TEST(NodePool, ChunksGrowGeometrically) {
+    CountingResource upstream;
+    NodePool pool(16, 8, 4, &upstream);
+    for (int i = 0; i < 4 + 8 + 16; ++i)
+        pool.allocate();
+    EXPECT_EQ(pool.chunkCount(), 3u);
+    EXPECT_EQ(upstream.allocations, 3u);
+    pool.allocate();
+    EXPECT_EQ(pool.chunkCount(), 4u);
+}
+
+TEST(NodePool, ReleaseReturnsEveryChunk) {
+    CountingResource upstream;
+    {
+        NodePool pool(64, 16, 2, &upstream);
+        for (int i = 0; i < 1000; ++i)
+            pool.allocate();
+        pool.release();
+        EXPECT_EQ(upstream.bytesOutstanding, 0u);
+        EXPECT_EQ(pool.liveBlocks(), 0u);
+        pool.allocate();
+    }
+    EXPECT_EQ(upstream.bytesOutstanding, 0u);
+    EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(NodePool, TypedPoolConstructsAndDestroys) {
+    TypedNodePool<std::string> pool(2);
+    std::string* a = pool.create(50, 'a');
+    std::string* b = pool.create("short");
+    EXPECT_EQ(*a, std::string(50, 'a'));
+    EXPECT_EQ(*b, "short");
+    EXPECT_EQ(pool.liveNodes(), 2u);
+    pool.destroy(a);
+    pool.destroy(b);
+    EXPECT_EQ(pool.liveNodes(), 0u);
+}
+
+TEST(NodePool, SwapExchangesChunks) {
+    CountingResource upstream;
+    NodePool a(16, 8, 4, &upstream), b(16, 8, 4, &upstream);
+    void* p = a.allocate();
+    a.swap(b);
+    EXPECT_EQ(a.chunkCount(), 0u);
+    EXPECT_EQ(b.chunkCount(), 1u);
+    b.deallocate(p);
+    EXPECT_EQ(b.allocate(), p);
+}
+
+TEST(NodePool, ListAllocatesFarFewerTimesThanNodes) {
+    CountingResource counting;
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(&counting);
+    {
+        List<int> l;
+        for (int i = 0; i < 100000; ++i)
+            l.append(i);
+        // One node per 64 ints in chunks of up to 4096 nodes, plus the
+        // directory vectors' growth.
+        EXPECT_LT(counting.allocations, 20u);
+        EXPECT_EQ(l[99999], 99999);
+    }
+    std::pmr::set_default_resource(previous);
+    EXPECT_EQ(counting.bytesOutstanding, 0u);
+}
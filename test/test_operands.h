@@ -0,0 +1,16 @@
+#pragma once
+
+#include "workload.h"
+
+// Seeded multiplication operand shared by the kernel tests: `terms` distinct
+// monoms with every power at most maxPower and integer coefficients in
+// [-20, 20], all multiplied by `step`.
+inline Polinom randomOperand(uint64_t seed, int terms, int maxPower, double step = 1.0) {
+    PolinomSpec spec;
+    spec.terms = terms;
+    spec.maxPower = maxPower;
+    spec.coeffMax = 20.0;
+    WorkloadRandom rng(seed);
+    Polinom p = generatePolinom(spec, rng);
+    return step == 1.0 ? p : p * step;
+}
@@ -0,0 +1,164 @@
+#include "pipeline.h"
+#include <gtest.h>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+static std::string runPipeline(const std::string& expression, const std::string& input, PipelineConfig cfg,
+    PipelineStats* statsOut = nullptr) {
+    PolinomPipeline pipeline{ Expression(expression), cfg };
+    std::istringstream in(input);
+    std::ostringstream out;
+    PipelineStats stats = pipeline.run(in, out);
+    if (statsOut)
+        *statsOut = stats;
+    return out.str();
+}
+
+TEST(PolinomPipeline, ParsesDefinitions) {
+    auto table = PolinomPipeline::parseDefinitions(" a = x+1 ;b=  2y ; ");
+    ASSERT_EQ(table.size(), 2u);
+    EXPECT_EQ(table["a"], Polinom("x+1"));
+    EXPECT_EQ(table["b"], Polinom("2y"));
+    EXPECT_THROW(PolinomPipeline::parseDefinitions("a x+1"), std::runtime_error);
+    EXPECT_THROW(PolinomPipeline::parseDefinitions(" = x"), std::runtime_error);
+}
+
+TEST(PolinomPipeline, EvaluatesEachLine) {
+    std::string out = runPipeline("a*b + c", "a = x+1; b = y; c = 2\na = x; b = x; c = -x^2\n", PipelineConfig());
+    EXPECT_EQ(out, formatPolinom(Polinom("xy+y+2")) + "\n0\n");
+}
+
+TEST(PolinomPipeline, KeepsInputOrderWithManyThreads) {
+    std::ostringstream input, expected;
+    for (int i = 0; i < 500; ++i) {
+        input << "a = " << i << "x + 1; b = y - " << (i % 7) << "\n";
+        Polinom a(std::to_string(i) + "x+1"), b("y-" + std::to_string(i % 7));
+        expected << formatPolinom(a * b - a) << "\n";
+    }
+    PipelineConfig cfg;
+    cfg.parseThreads = 3;
+    cfg.computeThreads = 4;
+    cfg.formatThreads = 2;
+    cfg.queueCapacity = 8;
+    PipelineStats stats;
+    EXPECT_EQ(runPipeline("a*b - a", input.str(), cfg, &stats), expected.str());
+    EXPECT_EQ(stats.lines, 500u);
+    ASSERT_EQ(stats.stages.size(), 3u);
+    for (const auto& stage : stats.stages) {
+        EXPECT_EQ(stage.items, 500u) << stage.name;
+        EXPECT_LE(stage.maxQueueDepth, 8u) << stage.name;
+    }
+    EXPECT_EQ(stats.stages[1].threads, 4u);
+}
+
+TEST(PolinomPipeline, ReportsErrorsPerLine) {
+    PipelineStats stats;
+    std::string out = runPipeline("a + b", "a = x; b = y\na = x^12; b = 1\na = x\nnonsense\n", PipelineConfig(), &stats);
+    std::istringstream lines(out);
+    std::string line;
+    std::vector<std::string> got;
+    while (std::getline(lines, line))
+        got.push_back(line);
+    ASSERT_EQ(got.size(), 4u);
+    EXPECT_EQ(got[0], formatPolinom(Polinom("x+y")));
+    EXPECT_EQ(got[1].rfind("error: ", 0), 0u);
+    EXPECT_EQ(got[2], "error: Unknown polinom: b");
+    EXPECT_EQ(got[3], "error: Expected name = polinom");
+    EXPECT_EQ(stats.stages[0].errors, 2u);
+    EXPECT_EQ(stats.stages[1].errors, 1u);
+}
+
+TEST(PolinomPipeline, EmptyInputProducesNothing) {
+    PipelineStats stats;
+    EXPECT_EQ(runPipeline("a", "", PipelineConfig(), &stats), "");
+    EXPECT_EQ(stats.lines, 0u);
+}
+
+TEST(Pipeline, SlowLineDoesNotLetReaderRunAhead) {
+    std::ostringstream input;
+    input << "slow\n";
+    for (int i = 1; i < 2000; ++i)
+        input << i << "\n";
+    std::atomic<uint64_t> parsedLines{ 0 };
+    uint64_t parsedWhileStalled = 0;
+    PipelineConfig cfg;
+    cfg.computeThreads = 4;
+    cfg.queueCapacity = 4;
+    cfg.maxInFlight = 32;
+    Pipeline<std::string, std::string> pipeline(cfg,
+        [&](const std::string& line) {
+            parsedLines.fetch_add(1);
+            return line;
+        },
+        [&](std::string& line) {
+            if (line == "slow") {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                parsedWhileStalled = parsedLines.load();
+            }
+            return line;
+        },
+        [](const std::string& line) { return line; });
+    std::istringstream in(input.str());
+    std::ostringstream out;
+    PipelineStats stats = pipeline.run(in, out);
+    EXPECT_EQ(out.str(), input.str());
+    EXPECT_EQ(stats.lines, 2000u);
+    EXPECT_LE(parsedWhileStalled, cfg.maxInFlight);
+}
+
+TEST(Pipeline, ReportsNonStandardExceptionsPerLine) {
+    Pipeline<std::string, std::string> pipeline(PipelineConfig(),
+        [](const std::string& line) { return line; },
+        [](std::string& line) -> std::string {
+            if (line == "bad")
+                throw 42;
+            return line;
+        },
+        [](const std::string& line) { return line; });
+    std::istringstream in("ok\nbad\nok\n");
+    std::ostringstream out;
+    PipelineStats stats = pipeline.run(in, out);
+    EXPECT_EQ(out.str(), "ok\nerror: unknown exception\nok\n");
+    EXPECT_EQ(stats.stages[1].errors, 1u);
+}
+
+namespace {
+
+// Accepts `room` characters, then reports every write as failed.
+class FullBuffer : public std::streambuf {
+    size_t room;
+
+public:
+    explicit FullBuffer(size_t n) : room(n) {}
+
+protected:
+    int_type overflow(int_type c) override {
+        if (room == 0)
+            return traits_type::eof();
+        --room;
+        return traits_type::not_eof(c);
+    }
+};
+
+}
+
+TEST(Pipeline, FailedOutputStopsWorkersAndPropagates) {
+    std::ostringstream input;
+    for (int i = 0; i < 5000; ++i)
+        input << i << "\n";
+    PipelineConfig cfg;
+    cfg.parseThreads = 2;
+    cfg.computeThreads = 2;
+    cfg.queueCapacity = 4;
+    Pipeline<std::string, std::string> pipeline(cfg,
+        [](const std::string& line) { return line; },
+        [](std::string& line) { return line; },
+        [](const std::string& line) { return line; });
+    std::istringstream in(input.str());
+    FullBuffer buffer(100);
+    std::ostream out(&buffer);
+    out.exceptions(std::ios::badbit);
+    EXPECT_THROW(pipeline.run(in, out), std::ios_base::failure);
+}
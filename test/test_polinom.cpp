@@ -1,4 +1,5 @@
 #include "polinom.h"
+#include "test_operands.h"
 #include <gtest.h>
 
 TEST(Monom, CanCreateWithUnaryMinus) {
@@ -186,4 +187,87 @@ TEST(Monom, Abc) {
     int degree = 111;
     EXPECT_EQ(p.degree, degree);
 
-}
\ No newline at end of file
+}
+
+TEST(Monom, ThrowsOnDegreeOverflowWithoutCarryIntoNextVariable) {
+    Monom m1("y^5");
+    Monom m2("y^5");
+    EXPECT_ANY_THROW(m1 * m2);
+}
+
+TEST(Polinom, ThrowsOnDegreeOverflowInProduct) {
+    Polinom p1("y^5z+1");
+    Polinom p2("y^5+x");
+    EXPECT_ANY_THROW(p1 * p2);
+}
+
+static Polinom naiveProduct(const Polinom& a, const Polinom& b) {
+    std::vector<Monom> products;
+    for (const auto& m1 : a.getMonoms())
+        for (const auto& m2 : b.getMonoms())
+            products.push_back(m1 * m2);
+    return Polinom(products);
+}
+
+TEST(Polinom, MultiplicationMatchesNaiveProduct) {
+    for (unsigned seed = 1; seed < 20; ++seed) {
+        Polinom a = randomOperand(seed, static_cast<int>(seed) * 7, 4, 0.5);
+        Polinom b = randomOperand(seed * 31, 40, 4, 0.5);
+        EXPECT_EQ(a * b, naiveProduct(a, b));
+    }
+}
+
+TEST(Polinom, SparseMultiplicationMatchesNaiveProduct) {
+    Polinom a("x^4y^4z^4+1");
+    Polinom b("x^5y^5z^5+z");
+    EXPECT_EQ(a * b, naiveProduct(a, b));
+}
+
+TEST(Polinom, EveryMultiplyStrategyMatchesNaiveProduct) {
+    const Polinom::MultiplyStrategy strategies[] = { Polinom::MultiplyStrategy::Auto,
+        Polinom::MultiplyStrategy::Dense, Polinom::MultiplyStrategy::Heap, Polinom::MultiplyStrategy::Hash };
+    for (unsigned seed = 1; seed < 12; ++seed) {
+        Polinom a = randomOperand(seed, static_cast<int>(seed) * 11, 4, 0.5);
+        Polinom b = randomOperand(seed * 17, static_cast<int>(seed % 4) + 1, 4, 0.5);
+        Polinom expected = naiveProduct(a, b);
+        for (auto strategy : strategies) {
+            EXPECT_EQ(a.multiply(b, a.getResource(), strategy), expected);
+            EXPECT_EQ(b.multiply(a, a.getResource(), strategy), expected);
+        }
+    }
+    Polinom p("x+1"), q("x-1");
+    for (auto strategy : strategies) {
+        EXPECT_EQ(p.multiply(q, p.getResource(), strategy), Polinom("x^2-1"));
+        EXPECT_EQ(Polinom("3").multiply(Polinom("2z"), p.getResource(), strategy), Polinom("6z"));
+        EXPECT_TRUE(p.multiply(Polinom(), p.getResource(), strategy).empty());
+        EXPECT_ANY_THROW(Polinom("x^5").multiply(Polinom("x^5"), p.getResource(), strategy));
+    }
+}
+
+TEST(Polinom, MultiplyCostModelPicksByShape) {
+    using S = Polinom::MultiplyStrategy;
+    EXPECT_EQ(Polinom::chooseMultiplyStrategy(125, 216, 1000, 1000), S::Dense);
+    EXPECT_EQ(Polinom::chooseMultiplyStrategy(64, 64, 900, 729), S::Dense);
+    EXPECT_EQ(Polinom::chooseMultiplyStrategy(2, 2, 900, 729), S::Heap);
+    EXPECT_EQ(Polinom::chooseMultiplyStrategy(1, 40, 900, 729), S::Heap);
+    // Many colliding products spread over a degree range far wider than
+    // the dense accumulator covers.
+    EXPECT_EQ(Polinom::chooseMultiplyStrategy(300, 300, 1000000, 1000), S::Hash);
+    EXPECT_EQ(Polinom::chooseMultiplyStrategy(300, 300, 10000000, 10000000), S::Heap);
+}
+
+TEST(Polinom, ParallelMultiplicationMatchesSerial) {
+    Polinom a = randomOperand(5, 120, 4, 0.5);
+    Polinom b = randomOperand(9, 120, 4, 0.5);
+    Polinom expected = naiveProduct(a, b);
+    for (unsigned threads = 1; threads <= 8; ++threads)
+        EXPECT_EQ(a.multiplyParallel(b, threads), expected);
+}
+
+TEST(Polinom, ParallelMultiplicationHandlesEdgeCases) {
+    Polinom a("x+1");
+    EXPECT_TRUE(a.multiplyParallel(Polinom(), 4).empty());
+    EXPECT_EQ(a.multiplyParallel(a, 16), Polinom("x^2+2x+1"));
+    EXPECT_EQ(a.multiplyParallel(a, 0), Polinom("x^2+2x+1"));
+    EXPECT_ANY_THROW(Polinom("x^5").multiplyParallel(Polinom("x^5"), 2));
+}
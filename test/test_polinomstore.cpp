@@ -0,0 +1,109 @@
+#include "polinomstore.h"
+#include <gtest.h>
+#include <atomic>
+#include <thread>
+
+TEST(PolinomStore, InsertFindErase) {
+    PolinomStore store;
+    EXPECT_EQ(store.size(), 0u);
+    EXPECT_TRUE(store.insertOrAssign("a", Polinom("x+1")));
+    EXPECT_FALSE(store.insertOrAssign("a", Polinom("y")));
+    ASSERT_TRUE(store.find("a").has_value());
+    EXPECT_EQ(*store.find("a"), Polinom("y"));
+    EXPECT_FALSE(store.find("b").has_value());
+    EXPECT_TRUE(store.contains("a"));
+    EXPECT_TRUE(store.erase("a"));
+    EXPECT_FALSE(store.erase("a"));
+    EXPECT_FALSE(store.contains("a"));
+}
+
+TEST(PolinomStore, ReadRunsCallbackInPlace) {
+    PolinomStore store;
+    store.insertOrAssign("p", Polinom("x^2+2xy+z"));
+    size_t terms = 0;
+    EXPECT_TRUE(store.read("p", [&](const Polinom& p) { terms = p.size(); }));
+    EXPECT_EQ(terms, 3u);
+    EXPECT_FALSE(store.read("q", [&](const Polinom&) { terms = 0; }));
+    EXPECT_EQ(terms, 3u);
+}
+
+TEST(PolinomStore, StoredValueIsIndependentOfSource) {
+    PolinomStore store;
+    std::pmr::monotonic_buffer_resource arena;
+    {
+        Polinom p("x+y+z", &arena);
+        store.insertOrAssign("p", p);
+    }
+    arena.release();
+    EXPECT_EQ(*store.find("p"), Polinom("x+y+z"));
+}
+
+TEST(PolinomStore, ForEachSeesEveryEntry) {
+    PolinomStore store;
+    for (int i = 0; i < 10; ++i)
+        store.insertOrAssign("p" + std::to_string(i), Polinom(std::vector<Monom>{ Monom(i, 1.0) }));
+    size_t seen = 0;
+    store.forEach([&](const std::string&, const Polinom& p) { seen += p.size(); });
+    EXPECT_EQ(seen, 10u);
+    store.clear();
+    EXPECT_EQ(store.size(), 0u);
+}
+
+// Every entry holds 20 terms with one shared coefficient and writers replace
+// whole values, so a reader seeing mixed coefficients saw a torn update.
+TEST(PolinomStore, StressReadersSeeConsistentValues) {
+    auto makeValue = [](int version) {
+        std::vector<Monom> monoms;
+        for (int d = 0; d < 20; ++d)
+            monoms.emplace_back(d * 37 % 1000, static_cast<double>(version));
+        return Polinom(monoms);
+    };
+    const int keys = 16;
+    PolinomStore store;
+    for (int k = 0; k < keys; ++k)
+        store.insertOrAssign("k" + std::to_string(k), makeValue(1));
+
+    std::atomic<bool> stop{ false };
+    std::atomic<int> badReads{ 0 };
+    std::atomic<long> reads{ 0 };
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 6; ++t) {
+        readers.emplace_back([&, t] {
+            int k = t;
+            while (!stop.load()) {
+                std::string name = "k" + std::to_string(k++ % keys);
+                bool found = store.read(name, [&](const Polinom& p) {
+                    const auto& terms = p.getMonoms();
+                    if (terms.size() != 20) {
+                        badReads++;
+                        return;
+                    }
+                    for (const auto& m : terms)
+                        if (m.coeff != terms.front().coeff)
+                            badReads++;
+                });
+                if (!found)
+                    badReads++;
+                std::optional<Polinom> copy = store.find(name);
+                if (!copy || copy->size() != 20)
+                    badReads++;
+                reads++;
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 2; ++w) {
+        writers.emplace_back([&, w] {
+            for (int version = 2; version < 200; ++version)
+                store.insertOrAssign("k" + std::to_string((version + w) % keys), makeValue(version));
+        });
+    }
+    for (auto& t : writers)
+        t.join();
+    stop = true;
+    for (auto& t : readers)
+        t.join();
+    EXPECT_EQ(badReads.load(), 0);
+    EXPECT_GT(reads.load(), 0);
+    EXPECT_EQ(store.size(), static_cast<size_t>(keys));
+}
@@ -0,0 +1,130 @@
+#include "rational.h"
+#include "polinom.h"
+#include <gtest.h>
+#include <random>
+#include <sstream>
+
+using RationalPolinom = BasicPolinom<Rational>;
+
+static std::string str(const RationalPolinom& p) {
+    std::ostringstream os;
+    os << p;
+    return os.str();
+}
+
+TEST(BigInt, StringRoundTrip) {
+    for (std::string text : { "0", "7", "-7", "4294967296", "-18446744073709551616",
+             "123456789012345678901234567890123456789" })
+        EXPECT_EQ(BigInt::fromString(text).toString(), text);
+    EXPECT_EQ(BigInt(INT64_MIN).toString(), "-9223372036854775808");
+    EXPECT_THROW(BigInt::fromString("12a"), std::invalid_argument);
+}
+
+TEST(BigInt, SmallArithmeticMatchesInt64) {
+    std::mt19937_64 rng(5);
+    for (int i = 0; i < 2000; ++i) {
+        int64_t a = static_cast<int64_t>(rng() % 2000001) - 1000000;
+        int64_t b = static_cast<int64_t>(rng() % 2001) - 1000;
+        if (b == 0)
+            b = 1;
+        EXPECT_EQ(BigInt(a) + BigInt(b), BigInt(a + b));
+        EXPECT_EQ(BigInt(a) - BigInt(b), BigInt(a - b));
+        EXPECT_EQ(BigInt(a) * BigInt(b), BigInt(a * b));
+        EXPECT_EQ(BigInt(a) / BigInt(b), BigInt(a / b));
+        EXPECT_EQ(BigInt(a) % BigInt(b), BigInt(a % b));
+        EXPECT_EQ(BigInt(a) < BigInt(b), a < b);
+    }
+}
+
+TEST(BigInt, LongDivisionRoundTrips) {
+    std::mt19937_64 rng(9);
+    auto random = [&rng](int digits) {
+        std::string text(1, static_cast<char>('1' + rng() % 9));
+        for (int i = 1; i < digits; ++i)
+            text += static_cast<char>('0' + rng() % 10);
+        return BigInt::fromString(text);
+    };
+    for (int i = 0; i < 200; ++i) {
+        BigInt a = random(10 + static_cast<int>(rng() % 60)), b = random(10 + static_cast<int>(rng() % 30));
+        if (rng() & 1)
+            a = -a;
+        auto [q, r] = BigInt::divMod(a, b);
+        EXPECT_EQ(q * b + r, a);
+        EXPECT_LT(r.abs(), b);
+        EXPECT_TRUE(r.isZero() || r.isNegative() == a.isNegative());
+        EXPECT_EQ((a * b) / b, a);
+    }
+    EXPECT_THROW(BigInt(1) / BigInt(0), std::domain_error);
+}
+
+TEST(BigInt, Gcd) {
+    EXPECT_EQ(BigInt::gcd(BigInt(12), BigInt(-18)), BigInt(6));
+    EXPECT_EQ(BigInt::gcd(BigInt(0), BigInt(5)), BigInt(5));
+    BigInt p = BigInt::fromString("1000000007"), q = BigInt::fromString("998244353");
+    BigInt big = BigInt::fromString("123456789123456789");
+    EXPECT_EQ(BigInt::gcd(big * p, big * q), big);
+}
+
+TEST(Rational, NormalizesToLowestTerms) {
+    Rational r(BigInt(6), BigInt(-8));
+    EXPECT_EQ(r.numerator(), BigInt(-3));
+    EXPECT_EQ(r.denominator(), BigInt(4));
+    EXPECT_EQ(Rational(BigInt(0), BigInt(-5)), Rational(0));
+    EXPECT_EQ(Rational(1) / Rational(3) + Rational(1) / Rational(6), Rational(BigInt(1), BigInt(2)));
+    EXPECT_EQ(Rational(BigInt(2), BigInt(3)) * Rational(BigInt(3), BigInt(2)), Rational(1));
+    EXPECT_THROW(Rational(BigInt(1), BigInt(0)), std::domain_error);
+    EXPECT_THROW(Rational(1) / Rational(0), std::domain_error);
+}
+
+TEST(Rational, ParsesFractionsAndDecimals) {
+    size_t end = 0;
+    EXPECT_EQ(Rational::parse("3/4x", 0, end), Rational(BigInt(3), BigInt(4)));
+    EXPECT_EQ(end, 3u);
+    EXPECT_EQ(Rational::parse("0.25", 0, end), Rational(BigInt(1), BigInt(4)));
+    EXPECT_EQ(Rational::parse(".5y", 0, end), Rational(BigInt(1), BigInt(2)));
+    EXPECT_EQ(end, 2u);
+    EXPECT_EQ(Rational::parse("1.5/7", 0, end), Rational(BigInt(3), BigInt(14)));
+    EXPECT_THROW(Rational::parse("1/0", 0, end), std::domain_error);
+    EXPECT_THROW(Rational::parse("x", 0, end), std::invalid_argument);
+
+    std::ostringstream os;
+    os << Rational(BigInt(-3), BigInt(4)) << ' ' << Rational(5);
+    EXPECT_EQ(os.str(), "-3/4 5");
+}
+
+TEST(RationalPolinom, ArithmeticIsExact) {
+    RationalPolinom p("1/3x + 1/2");
+    EXPECT_EQ(str(p * p), "1/9x^2+1/3x+1/4");
+    EXPECT_EQ(str(RationalPolinom("0.1x") + RationalPolinom("0.2x")), "3/10x");
+    EXPECT_TRUE((RationalPolinom("0.1x") * RationalPolinom("3") - RationalPolinom("0.3x")).empty());
+}
+
+TEST(RationalPolinom, KeepsCoefficientsDoubleWouldDrop) {
+    // 1e-12 is below the double epsilon and would vanish.
+    RationalPolinom tiny("0.000000000001x");
+    EXPECT_EQ(tiny.size(), 1u);
+    EXPECT_EQ(str(tiny * RationalPolinom("1000000000000")), "x");
+}
+
+TEST(RationalPolinom, AllKernelsAgree) {
+    using Strategy = RationalPolinom::MultiplyStrategy;
+    std::mt19937 rng(3);
+    auto operand = [&rng]() {
+        std::vector<BasicMonom<Rational>> monoms;
+        for (int i = 0; i < 25; ++i)
+            monoms.emplace_back(static_cast<int>(rng() % 4) * 100 + static_cast<int>(rng() % 4) * 10
+                    + static_cast<int>(rng() % 4),
+                Rational(BigInt(static_cast<int64_t>(rng() % 21) - 10), BigInt(static_cast<int64_t>(rng() % 6) + 1)));
+        return RationalPolinom(monoms);
+    };
+    for (int i = 0; i < 4; ++i) {
+        RationalPolinom a = operand(), b = operand();
+        RationalPolinom dense = a.multiply(b, std::pmr::get_default_resource(), Strategy::Dense);
+        EXPECT_EQ(a.multiply(b, std::pmr::get_default_resource(), Strategy::Heap), dense);
+        EXPECT_EQ(a.multiply(b, std::pmr::get_default_resource(), Strategy::Hash), dense);
+        EXPECT_EQ(a.multiplyParallel(b, 3, std::pmr::get_default_resource()), dense);
+        RationalPolinom copy = a;
+        EXPECT_FALSE(copy.sharesTermsWith(a));
+        EXPECT_EQ(copy, a);
+    }
+}
@@ -0,0 +1,67 @@
+#include "scheduler.h"
+#include <gtest.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+static void waitFor(std::atomic<int>& counter, int expected) {
+    while (counter.load() < expected)
+        std::this_thread::yield();
+}
+
+TEST(TaskScheduler, RunsAllSubmittedTasks) {
+    TaskScheduler pool(4);
+    std::atomic<int> done{ 0 };
+    for (int i = 0; i < 1000; ++i)
+        pool.submit([&] { done.fetch_add(1); });
+    waitFor(done, 1000);
+    EXPECT_EQ(done.load(), 1000);
+}
+
+TEST(TaskScheduler, TasksCanSpawnTasks) {
+    TaskScheduler pool(3);
+    std::atomic<int> done{ 0 };
+    for (int i = 0; i < 10; ++i) {
+        pool.submit([&] {
+            for (int j = 0; j < 10; ++j)
+                pool.submit([&] { done.fetch_add(1); });
+        });
+    }
+    waitFor(done, 100);
+    EXPECT_EQ(done.load(), 100);
+}
+
+TEST(TaskScheduler, WorkerIndexIsSetOnlyInsidePool) {
+    TaskScheduler pool(2);
+    EXPECT_EQ(pool.workerIndex(), -1);
+    std::atomic<int> index{ -2 };
+    std::atomic<int> done{ 0 };
+    pool.submit([&] { index = pool.workerIndex(); done = 1; });
+    waitFor(done, 1);
+    EXPECT_GE(index.load(), 0);
+    EXPECT_LT(index.load(), 2);
+}
+
+TEST(TaskScheduler, ThrowingTaskDoesNotStopWorker) {
+    TaskScheduler pool(1);
+    std::atomic<int> done{ 0 };
+    pool.submit([] { throw std::runtime_error("boom"); });
+    pool.submit([&] { done = 1; });
+    waitFor(done, 1);
+    EXPECT_EQ(done.load(), 1);
+}
+
+TEST(TaskScheduler, DestructorDrainsPendingTasks) {
+    std::atomic<int> done{ 0 };
+    {
+        TaskScheduler pool(2);
+        for (int i = 0; i < 200; ++i)
+            pool.submit([&] { done.fetch_add(1); });
+    }
+    EXPECT_EQ(done.load(), 200);
+}
+
+TEST(TaskScheduler, ZeroThreadsMeansOne) {
+    TaskScheduler pool(0);
+    EXPECT_EQ(pool.size(), 1u);
+}
@@ -0,0 +1,172 @@
+#include "serialization.h"
+#include <gtest.h>
+#include <limits>
+#include <sstream>
+
+TEST(Serialization, RoundTripIsExact) {
+    Polinom p("2.5x^6y^7z^8-3.14159x^5y^4z^3+0.1xyz-7");
+    EXPECT_EQ(deserialize(serialize(p)), p);
+    EXPECT_EQ(deserialize(serialize(p)).getMonoms()[1].coeff, p.getMonoms()[1].coeff);
+}
+
+TEST(Serialization, RoundTripEmpty) {
+    Polinom p;
+    std::vector<uint8_t> buf = serialize(p);
+    EXPECT_EQ(buf.size(), 2);
+    EXPECT_TRUE(deserialize(buf).empty());
+}
+
+TEST(Serialization, FloatEncodingIsApproximate) {
+    Polinom p("0.1x^2+1.5y");
+    SerializeOptions opts;
+    opts.encoding = CoeffEncoding::Float;
+    Polinom q = deserialize(serialize(p, opts));
+    ASSERT_EQ(q.size(), 2);
+    EXPECT_NEAR(q.getMonoms()[0].coeff, 0.1, 1e-7);
+    EXPECT_EQ(q.getMonoms()[1].coeff, 1.5);
+    EXPECT_LT(serialize(p, opts).size(), serialize(p).size());
+}
+
+TEST(Serialization, QuantizedEncodingRoundsToQuantum) {
+    Polinom p("1.234x^9y^9z^9-0.5z+2");
+    SerializeOptions opts;
+    opts.encoding = CoeffEncoding::Quantized;
+    opts.quantum = 0.01;
+    Polinom q = deserialize(serialize(p, opts));
+    ASSERT_EQ(q.size(), 3);
+    EXPECT_NEAR(q.getMonoms()[0].coeff, 1.23, 1e-12);
+    EXPECT_NEAR(q.getMonoms()[1].coeff, -0.5, 1e-12);
+    EXPECT_EQ(q.getMonoms()[0].degree, 999);
+}
+
+TEST(Serialization, QuantizedDropsTermsBelowQuantum) {
+    Polinom p("0.001x+4");
+    SerializeOptions opts;
+    opts.encoding = CoeffEncoding::Quantized;
+    opts.quantum = 0.1;
+    EXPECT_EQ(deserialize(serialize(p, opts)), Polinom("4"));
+}
+
+TEST(Serialization, RejectsNonPositiveQuantum) {
+    std::vector<uint8_t> buf;
+    SerializeOptions opts;
+    opts.encoding = CoeffEncoding::Quantized;
+    opts.quantum = 0.0;
+    EXPECT_THROW(PolinomEncoder(buf, opts), std::invalid_argument);
+}
+
+TEST(Serialization, RejectsNonFiniteQuantum) {
+    std::vector<uint8_t> buf;
+    SerializeOptions opts;
+    opts.encoding = CoeffEncoding::Quantized;
+    opts.quantum = std::numeric_limits<double>::infinity();
+    EXPECT_THROW(PolinomEncoder(buf, opts), std::invalid_argument);
+}
+
+TEST(Serialization, QuantizedKeepsOutOfRangeTermsLossless) {
+    Polinom::Terms terms;
+    terms.emplace_back(900, 1e300);
+    terms.emplace_back(5, 2.5);
+    terms.emplace_back(0, -std::numeric_limits<double>::infinity());
+    Polinom p(std::move(terms));
+    SerializeOptions opts;
+    opts.encoding = CoeffEncoding::Quantized;
+    opts.quantum = 1e-6;
+    Polinom q = deserialize(serialize(p, opts));
+    ASSERT_EQ(q.size(), 3);
+    EXPECT_EQ(q.getMonoms()[0].coeff, 1e300);
+    EXPECT_NEAR(q.getMonoms()[1].coeff, 2.5, 1e-12);
+    EXPECT_EQ(q.getMonoms()[2].coeff, -std::numeric_limits<double>::infinity());
+}
+
+TEST(Serialization, ThrowsOnInvalidDecodedQuantum) {
+    for (double quantum : { 0.0, -1.0, std::numeric_limits<double>::infinity(),
+                            std::numeric_limits<double>::quiet_NaN() }) {
+        std::vector<uint8_t> buf;
+        ByteWriter w(buf);
+        w.putByte(static_cast<uint8_t>(CoeffEncoding::Quantized));
+        w.putDouble(quantum);
+        w.putVarint(0);
+        EXPECT_THROW(deserialize(buf), std::runtime_error);
+    }
+}
+
+TEST(Serialization, StreamsSeveralPolinoms) {
+    Polinom a("x^2+1"), b("-3y^4z"), c;
+    std::vector<uint8_t> buf;
+    PolinomEncoder enc(buf);
+    enc.write(a);
+    enc.write(b);
+    enc.write(c);
+
+    PolinomDecoder dec(buf);
+    EXPECT_EQ(dec.read(), a);
+    EXPECT_EQ(dec.read(), b);
+    EXPECT_EQ(dec.read(), c);
+    EXPECT_TRUE(dec.done());
+}
+
+TEST(Serialization, ThrowsOnTruncatedBuffer) {
+    std::vector<uint8_t> buf = serialize(Polinom("x^2+1"));
+    buf.pop_back();
+    EXPECT_THROW(deserialize(buf), std::runtime_error);
+}
+
+TEST(Serialization, ThrowsOnTrailingBytes) {
+    std::vector<uint8_t> buf = serialize(Polinom("x^2+1"));
+    buf.push_back(0);
+    EXPECT_THROW(deserialize(buf), std::runtime_error);
+}
+
+TEST(Serialization, ThrowsOnZeroDelta) {
+    std::vector<uint8_t> buf;
+    ByteWriter w(buf);
+    w.putByte(0);
+    w.putVarint(2);
+    w.putVarint(5);
+    w.putDouble(1.0);
+    w.putVarint(0);
+    w.putDouble(1.0);
+    EXPECT_THROW(deserialize(buf), std::runtime_error);
+}
+
+TEST(Serialization, ThrowsOnInvalidDegree) {
+    std::vector<uint8_t> buf;
+    ByteWriter w(buf);
+    w.putByte(0);
+    w.putVarint(1);
+    w.putVarint(1000);
+    w.putDouble(1.0);
+    EXPECT_THROW(deserialize(buf), std::runtime_error);
+}
+
+TEST(Serialization, IsSmallerThanText) {
+    Polinom p("2x^6y^7z^8+3x^5y^4z^3+x^5y^4z^2+4x^2+17xyz+5");
+    std::ostringstream os;
+    os << p;
+    SerializeOptions opts;
+    opts.encoding = CoeffEncoding::Quantized;
+    opts.quantum = 1.0;
+    EXPECT_LT(serialize(p, opts).size(), os.str().size());
+    opts.encoding = CoeffEncoding::Float;
+    EXPECT_LT(serialize(p, opts).size(), os.str().size());
+}
+
+TEST(Serialization, VarintRoundTrip) {
+    std::vector<uint8_t> buf;
+    ByteWriter w(buf);
+    w.putVarint(0);
+    w.putVarint(127);
+    w.putVarint(128);
+    w.putVarint(UINT64_MAX);
+    w.putZigzag(-1);
+    w.putZigzag(INT64_MIN);
+    ByteReader r(buf);
+    EXPECT_EQ(r.getVarint(), 0u);
+    EXPECT_EQ(r.getVarint(), 127u);
+    EXPECT_EQ(r.getVarint(), 128u);
+    EXPECT_EQ(r.getVarint(), UINT64_MAX);
+    EXPECT_EQ(r.getZigzag(), -1);
+    EXPECT_EQ(r.getZigzag(), INT64_MIN);
+    EXPECT_TRUE(r.atEnd());
+}
@@ -0,0 +1,76 @@
+#include "shardedstore.h"
+#include <gtest.h>
+#include <atomic>
+#include <thread>
+
+TEST(ShardedPolinomStore, RoundsShardCountToPowerOfTwo) {
+    EXPECT_EQ(ShardedPolinomStore(5).shardCount(), 8u);
+    EXPECT_EQ(ShardedPolinomStore(0).shardCount(), 1u);
+    EXPECT_EQ(ShardedPolinomStore(16).shardCount(), 16u);
+}
+
+TEST(ShardedPolinomStore, InsertFindErase) {
+    ShardedPolinomStore store(4);
+    EXPECT_TRUE(store.insertOrAssign("a", Polinom("x+1")));
+    EXPECT_FALSE(store.insertOrAssign("a", Polinom("y")));
+    EXPECT_FALSE(store.insert("a", Polinom("z")));
+    EXPECT_TRUE(store.insert("b", Polinom("z")));
+    EXPECT_EQ(*store.find("a"), Polinom("y"));
+    EXPECT_EQ(*store.find("b"), Polinom("z"));
+    EXPECT_FALSE(store.find("c").has_value());
+    EXPECT_EQ(store.size(), 2u);
+    EXPECT_TRUE(store.erase("a"));
+    EXPECT_FALSE(store.erase("a"));
+    EXPECT_FALSE(store.contains("a"));
+    store.clear();
+    EXPECT_EQ(store.size(), 0u);
+}
+
+TEST(ShardedPolinomStore, UpdateSeesPreviousValue) {
+    ShardedPolinomStore store(2);
+    auto addX = [](const Polinom* old) { return old ? *old + Polinom("x") : Polinom("x"); };
+    store.update("p", addX);
+    store.update("p", addX);
+    EXPECT_EQ(*store.find("p"), Polinom("2x"));
+}
+
+TEST(ShardedPolinomStore, ForEachVisitsAllShards) {
+    ShardedPolinomStore store(8);
+    for (int i = 0; i < 100; ++i)
+        store.insertOrAssign("p" + std::to_string(i), Polinom(std::vector<Monom>{ Monom(i, 1.0) }));
+    size_t seen = 0;
+    store.forEach([&](const std::string&, const Polinom&) { ++seen; });
+    EXPECT_EQ(seen, 100u);
+}
+
+TEST(ShardedPolinomStore, ConcurrentWritersKeepDistinctKeys) {
+    ShardedPolinomStore store(16);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 8; ++t) {
+        writers.emplace_back([&, t] {
+            for (int i = 0; i < 500; ++i)
+                store.insertOrAssign("t" + std::to_string(t) + "_" + std::to_string(i),
+                    Polinom(std::vector<Monom>{ Monom(i % 1000, t + 1.0) }));
+        });
+    }
+    for (auto& w : writers)
+        w.join();
+    EXPECT_EQ(store.size(), 4000u);
+    EXPECT_EQ(*store.find("t3_42"), Polinom(std::vector<Monom>{ Monom(42, 4.0) }));
+}
+
+TEST(ShardedPolinomStore, ConcurrentUpdatesAreAtomic) {
+    ShardedPolinomStore store(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 250; ++i)
+                store.update("counter", [](const Polinom* old) {
+                    return old ? *old + Polinom("1") : Polinom("1");
+                });
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    EXPECT_EQ(*store.find("counter"), Polinom("2000"));
+}
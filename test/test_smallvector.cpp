@@ -0,0 +1,120 @@
+#include "smallvector.h"
+#include "polinom.h"
+#include <gtest.h>
+
+namespace {
+
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t align) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}
+
+TEST(SmallVector, StaysInlineUpToCapacity) {
+    CountingResource counting;
+    SmallVector<int, 4> v(&counting);
+    for (int i = 0; i < 4; ++i)
+        v.push_back(i);
+    EXPECT_TRUE(v.isInline());
+    EXPECT_EQ(counting.allocations, 0);
+    EXPECT_EQ(v.size(), 4);
+    EXPECT_EQ(v[3], 3);
+}
+
+TEST(SmallVector, SpillsToResourceWhenFull) {
+    CountingResource counting;
+    SmallVector<int, 4> v(&counting);
+    for (int i = 0; i < 5; ++i)
+        v.push_back(i);
+    EXPECT_FALSE(v.isInline());
+    EXPECT_EQ(counting.allocations, 1);
+    for (int i = 0; i < 5; ++i)
+        EXPECT_EQ(v[i], i);
+}
+
+TEST(SmallVector, PushBackOfOwnElementSurvivesGrowth) {
+    SmallVector<int, 2> v;
+    v.push_back(7);
+    v.push_back(8);
+    v.push_back(v[0]);
+    EXPECT_EQ(v[2], 7);
+}
+
+TEST(SmallVector, MoveStealsHeapBuffer) {
+    CountingResource counting;
+    SmallVector<int, 2> v(&counting);
+    for (int i = 0; i < 10; ++i)
+        v.push_back(i);
+    const int* data = v.data();
+    SmallVector<int, 2> w(std::move(v));
+    EXPECT_EQ(w.data(), data);
+    EXPECT_EQ(w.resource(), &counting);
+    EXPECT_TRUE(v.empty());
+    EXPECT_TRUE(v.isInline());
+}
+
+TEST(SmallVector, MoveOfInlineCopiesElements) {
+    SmallVector<int, 4> v;
+    v.push_back(1);
+    v.push_back(2);
+    SmallVector<int, 4> w(std::move(v));
+    EXPECT_TRUE(w.isInline());
+    EXPECT_EQ(w.size(), 2);
+    EXPECT_EQ(w[1], 2);
+}
+
+TEST(SmallVector, CopyUsesDefaultResource) {
+    CountingResource counting;
+    SmallVector<int, 2> v(&counting);
+    for (int i = 0; i < 10; ++i)
+        v.push_back(i);
+    SmallVector<int, 2> w(v);
+    EXPECT_EQ(w.resource(), std::pmr::get_default_resource());
+    EXPECT_NE(w.data(), v.data());
+    EXPECT_EQ(w[9], 9);
+}
+
+TEST(SmallVector, ResizeAndAt) {
+    SmallVector<int, 2> v;
+    v.resize(5);
+    EXPECT_EQ(v.size(), 5);
+    EXPECT_EQ(v.at(4), 0);
+    EXPECT_THROW(v.at(5), std::out_of_range);
+    v.resize(1);
+    EXPECT_EQ(v.size(), 1);
+}
+
+TEST(PolinomSmallBuffer, ShortPolinomDoesNotAllocate) {
+    CountingResource counting;
+    Polinom a("x^2+2xy+y^2", &counting);
+    Polinom b("x-y", &counting);
+    Polinom c = a * b + a;
+    EXPECT_EQ(counting.allocations, 0);
+    EXPECT_TRUE(c.getMonoms().isInline());
+    EXPECT_EQ(c, Polinom("x^3+x^2y-xy^2-y^3+x^2+2xy+y^2"));
+}
+
+TEST(PolinomSmallBuffer, LongPolinomSpills) {
+    CountingResource counting;
+    std::vector<Monom> terms;
+    for (int d = 0; d < static_cast<int>(Polinom::Terms::inlineCapacity()) + 1; ++d)
+        terms.emplace_back(d, 1.0);
+    Polinom p(terms, &counting);
+    EXPECT_FALSE(p.getMonoms().isInline());
+    EXPECT_GT(counting.allocations, 0);
+    Polinom moved(std::move(p));
+    EXPECT_EQ(moved.size(), Polinom::Terms::inlineCapacity() + 1);
+}
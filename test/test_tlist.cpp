@@ -1,5 +1,14 @@
 #include "tlist.h"
 #include <gtest.h>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#if __has_include(<execution>)
+#include <execution>
+#endif
 
 //LIST TESTS
 
@@ -364,3 +373,305 @@ TEST(QueueTest, CanHandleMultipleOperations) {
 
 
 
+
+//UNROLLED LIST TESTS
+
+template<typename T>
+static void expectSameAs(List<T>& l, const std::vector<T>& model) {
+    ASSERT_EQ(l.size(), model.size());
+    for (size_t i = 0; i < model.size(); ++i)
+        ASSERT_EQ(l[i], model[i]) << "at " << i;
+    size_t i = 0;
+    if (!model.empty()) {
+        for (auto it = l.begin();; ++it, ++i) {
+            ASSERT_EQ(*it, model[i]);
+            if (i + 1 == model.size())
+                break;
+        }
+    }
+}
+
+TEST(tListUnrolled, indexing_spans_many_nodes) {
+    List<int> l;
+    std::vector<int> model;
+    for (int i = 0; i < 5000; ++i) {
+        l.append(i);
+        model.push_back(i);
+    }
+    expectSameAs(l, model);
+    EXPECT_EQ(l.find(4321), 4321u);
+    EXPECT_EQ(l.find_kth_from_end(0), 4999);
+    EXPECT_EQ(l.find_kth_from_end(4999), 0);
+}
+
+TEST(tListUnrolled, insert_front_repeatedly) {
+    List<int> l;
+    std::vector<int> model;
+    for (int i = 0; i < 2000; ++i) {
+        l.insert_front(i);
+        model.insert(model.begin(), i);
+    }
+    expectSameAs(l, model);
+}
+
+TEST(tListUnrolled, random_inserts_and_erases_match_vector) {
+    std::mt19937 rng(7);
+    List<int> l;
+    std::vector<int> model;
+    for (int step = 0; step < 20000; ++step) {
+        bool grow = model.size() < 50 || rng() % 3 != 0;
+        if (grow) {
+            size_t at = rng() % (model.size() + 1);
+            l.insert(step, at);
+            model.insert(model.begin() + at, step);
+        }
+        else {
+            size_t at = rng() % model.size();
+            l.erase(at);
+            model.erase(model.begin() + at);
+        }
+    }
+    expectSameAs(l, model);
+    while (!model.empty()) {
+        size_t at = rng() % model.size();
+        l.erase(at);
+        model.erase(model.begin() + at);
+    }
+    EXPECT_EQ(l.size(), 0u);
+    ASSERT_ANY_THROW(l.erase_front());
+    l.append(1);
+    EXPECT_EQ(l.get_first(), 1);
+}
+
+TEST(tListUnrolled, append_and_erase_at_node_boundary) {
+    List<int> l;
+    std::vector<int> model;
+    // 64 ints fill a node, so the list ends exactly on a node boundary.
+    for (int i = 0; i < 64 * 40; ++i) {
+        l.append(i);
+        model.push_back(i);
+    }
+    for (int step = 0; step < 500; ++step) {
+        l.append(-step);
+        l.erase(l.size() - 1);
+        l.erase(l.size() - 1);
+        model.pop_back();
+    }
+    expectSameAs(l, model);
+    while (model.size() > 10) {
+        l.erase(model.size() / 2);
+        model.erase(model.begin() + model.size() / 2);
+        l.erase(l.size() - 1);
+        model.pop_back();
+    }
+    expectSameAs(l, model);
+}
+
+TEST(tListUnrolled, holds_non_trivial_elements) {
+    List<std::string> l;
+    std::vector<std::string> model;
+    for (int i = 0; i < 300; ++i) {
+        std::string s(40, static_cast<char>('a' + i % 26));
+        size_t at = (i * 7) % (model.size() + 1);
+        l.insert(s, at);
+        model.insert(model.begin() + at, s);
+    }
+    for (int i = 0; i < 150; ++i) {
+        l.erase(i % l.size());
+        model.erase(model.begin() + i % model.size());
+    }
+    expectSameAs(l, model);
+    List<std::string> copy(l);
+    EXPECT_TRUE(copy == l);
+    copy[10] = "changed";
+    EXPECT_FALSE(copy == l);
+    copy = l;
+    EXPECT_TRUE(copy == l);
+}
+
+//MOVE AND EMPLACE TESTS
+
+struct CopyCounter {
+    static int copies;
+    static int moves;
+    int value;
+
+    CopyCounter(int v = 0) : value(v) {}
+    CopyCounter(int a, int b) : value(a * 100 + b) {}
+    CopyCounter(const CopyCounter& other) : value(other.value) { ++copies; }
+    CopyCounter(CopyCounter&& other) noexcept : value(other.value) { ++moves; }
+    CopyCounter& operator=(const CopyCounter& other) { value = other.value; ++copies; return *this; }
+    CopyCounter& operator=(CopyCounter&& other) noexcept { value = other.value; ++moves; return *this; }
+    bool operator==(const CopyCounter& other) const { return value == other.value; }
+    bool operator!=(const CopyCounter& other) const { return value != other.value; }
+
+    static void reset() { copies = moves = 0; }
+};
+int CopyCounter::copies = 0;
+int CopyCounter::moves = 0;
+
+TEST(tListMove, emplace_back_constructs_in_place) {
+    List<CopyCounter> l;
+    CopyCounter::reset();
+    CopyCounter& made = l.emplace_back(3, 4);
+    EXPECT_EQ(made.value, 304);
+    EXPECT_EQ(CopyCounter::copies, 0);
+    EXPECT_EQ(CopyCounter::moves, 0);
+    l.emplace_front(1, 2);
+    EXPECT_EQ(l[0].value, 102);
+    EXPECT_EQ(l[1].value, 304);
+    EXPECT_EQ(CopyCounter::copies, 0);
+}
+
+TEST(tListMove, append_and_insert_move_rvalues) {
+    List<CopyCounter> l;
+    CopyCounter::reset();
+    l.append(CopyCounter(1));
+    l.insert(CopyCounter(2), 0);
+    l.insert_front(CopyCounter(3));
+    EXPECT_EQ(CopyCounter::copies, 0);
+    CopyCounter keep(4);
+    l.append(keep);
+    EXPECT_EQ(CopyCounter::copies, 1);
+    EXPECT_EQ(l[0].value, 3);
+    EXPECT_EQ(l[3].value, 4);
+}
+
+TEST(tListMove, move_constructor_steals_nodes) {
+    List<int> source;
+    for (int i = 0; i < 1000; ++i)
+        source.append(i);
+    List<int> target(std::move(source));
+    EXPECT_EQ(target.size(), 1000u);
+    EXPECT_EQ(target[999], 999);
+    EXPECT_EQ(source.size(), 0u);
+    source.append(7);
+    EXPECT_EQ(source[0], 7);
+}
+
+TEST(tListMove, move_assignment_replaces_contents) {
+    List<std::string> a, b;
+    for (int i = 0; i < 100; ++i) {
+        a.append(std::string(30, 'a'));
+        b.append(std::string(30, 'b'));
+    }
+    b.append("last");
+    a = std::move(b);
+    EXPECT_EQ(a.size(), 101u);
+    EXPECT_EQ(a[100], "last");
+    EXPECT_EQ(b.size(), 0u);
+}
+
+TEST(tListMove, insert_of_own_element_survives_split) {
+    List<std::string> l;
+    for (int i = 0; i < 8; ++i)
+        l.append(std::string(20, static_cast<char>('a' + i)));
+    l.insert(l[6], 1);
+    EXPECT_EQ(l.size(), 9u);
+    EXPECT_EQ(l[1], std::string(20, 'g'));
+    EXPECT_EQ(l[7], std::string(20, 'g'));
+}
+
+TEST(QueueMove, enqueue_moves_and_emplaces) {
+    Queue<CopyCounter> q;
+    CopyCounter::reset();
+    q.enqueue(CopyCounter(1));
+    q.emplace(2, 3);
+    EXPECT_EQ(CopyCounter::copies, 0);
+    EXPECT_EQ(q.front().value, 1);
+    q.dequeue();
+    EXPECT_EQ(q.front().value, 203);
+}
+
+TEST(QueueMove, move_construction_empties_source) {
+    Queue<std::string> a;
+    a.enqueue("x");
+    a.enqueue("y");
+    Queue<std::string> b(std::move(a));
+    EXPECT_EQ(b.getSize(), 2u);
+    a = std::move(b);
+    EXPECT_EQ(a.front(), "x");
+}
+
+static_assert(std::is_nothrow_move_constructible_v<Queue<int>> == std::is_nothrow_move_constructible_v<std::deque<int>>,
+    "Queue must not promise more than std::deque");
+
+// STANDARD ITERATOR TESTS
+
+static_assert(std::is_same_v<std::iterator_traits<List<int>::iterator>::iterator_category,
+    std::bidirectional_iterator_tag>);
+static_assert(std::is_same_v<std::iterator_traits<List<int>::const_iterator>::reference, const int&>);
+static_assert(std::is_convertible_v<List<int>::iterator, List<int>::const_iterator>);
+static_assert(!std::is_convertible_v<List<int>::const_iterator, List<int>::iterator>);
+
+TEST(tListStdIterator, range_for_reaches_end) {
+    List<int> l;
+    for (int i = 0; i < 1000; ++i)
+        l.append(i);
+    int expected = 0;
+    for (int& x : l)
+        EXPECT_EQ(x, expected++);
+    EXPECT_EQ(expected, 1000);
+    EXPECT_EQ(std::distance(l.begin(), l.end()), 1000);
+}
+
+TEST(tListStdIterator, empty_list_begin_equals_end) {
+    List<int> l;
+    EXPECT_TRUE(l.begin() == l.end());
+    EXPECT_TRUE(l.cbegin() == l.cend());
+    EXPECT_TRUE(l.rbegin() == l.rend());
+}
+
+TEST(tListStdIterator, decrement_walks_back_across_nodes) {
+    List<int> l;
+    for (int i = 0; i < 500; ++i)
+        l.append(i);
+    auto it = l.end();
+    for (int i = 499; i >= 0; --i)
+        EXPECT_EQ(*--it, i);
+    EXPECT_TRUE(it == l.begin());
+    EXPECT_EQ(*std::prev(l.end()), 499);
+}
+
+TEST(tListStdIterator, const_iteration_and_conversion) {
+    List<int> l;
+    for (int i = 0; i < 300; ++i)
+        l.append(i);
+    const List<int>& c = l;
+    EXPECT_EQ(std::accumulate(c.begin(), c.end(), 0), 299 * 300 / 2);
+    List<int>::const_iterator it = l.begin();
+    EXPECT_TRUE(it == c.begin());
+    EXPECT_TRUE(std::next(it, 300) == c.cend());
+}
+
+TEST(tListStdIterator, works_with_algorithms) {
+    List<int> l;
+    for (int i = 0; i < 200; ++i)
+        l.append(i);
+    auto found = std::find(l.begin(), l.end(), 150);
+    ASSERT_TRUE(found != l.end());
+    EXPECT_EQ(std::distance(l.begin(), found), 150);
+    std::reverse(l.begin(), l.end());
+    EXPECT_EQ(l[0], 199);
+    EXPECT_EQ(l[199], 0);
+    std::vector<int> back(l.rbegin(), l.rend());
+    for (int i = 0; i < 200; ++i)
+        EXPECT_EQ(back[i], i);
+    EXPECT_TRUE(std::find(l.begin(), l.end(), 1000) == l.end());
+}
+
+TEST(tListStdIterator, for_each_with_execution_policy) {
+    List<std::string> l;
+    for (int i = 0; i < 400; ++i)
+        l.append(std::to_string(i));
+    auto twice = [](std::string& s) { s += s; };
+#if defined(__cpp_lib_execution) && defined(POLINOM_HAS_PARALLEL_STL)
+    std::for_each(std::execution::par, l.begin(), l.end(), twice);
+    const List<std::string>& c = l;
+    auto even = [](const std::string& s) { return s.size() % 2 == 0; };
+    EXPECT_EQ(std::count_if(std::execution::par, c.begin(), c.end(), even), 400);
+#else
+    std::for_each(l.begin(), l.end(), twice);
+#endif
+    EXPECT_EQ(l[123], "123123");
+}
@@ -0,0 +1,185 @@
+#include "trace.h"
+#include "expression.h"
+#include "formatter.h"
+#include "polinomstore.h"
+#include <gtest.h>
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+// Enables tracing for one test and leaves it disabled afterwards.
+struct TraceSession {
+    TraceSession() {
+        tracing::clear();
+        tracing::enable();
+    }
+    ~TraceSession() { tracing::disable(); }
+};
+
+size_t countNamed(const std::vector<tracing::Event>& events, const std::string& name) {
+    size_t n = 0;
+    for (const auto& e : events)
+        n += name == e.name;
+    return n;
+}
+
+}
+
+TEST(Trace, DisabledRecordsNothing) {
+    tracing::disable();
+    tracing::clear();
+    {
+        tracing::Span span("ignored");
+        Polinom p("x+1");
+    }
+    EXPECT_TRUE(tracing::collect().empty());
+}
+
+TEST(Trace, SpansNestInStartOrder) {
+    std::vector<tracing::Event> events;
+    {
+        TraceSession session;
+        {
+            POLINOM_TRACE_SPAN("outer");
+            POLINOM_TRACE_SPAN("inner", 7);
+        }
+        events = tracing::collect();
+    }
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_STREQ(events[0].name, "outer");
+    EXPECT_STREQ(events[1].name, "inner");
+    EXPECT_EQ(events[0].arg, -1);
+    EXPECT_EQ(events[1].arg, 7);
+    EXPECT_EQ(events[0].thread, events[1].thread);
+    EXPECT_LE(events[0].start, events[1].start);
+    EXPECT_GE(events[0].start + events[0].duration, events[1].start + events[1].duration);
+}
+
+TEST(Trace, RecordsParseEvaluateLookupAndFormat) {
+    PolinomStore store;
+    store.insertOrAssign("a", Polinom("x+1"));
+    std::vector<tracing::Event> events;
+    size_t nodes = 0;
+    {
+        TraceSession session;
+        Expression e("a*a + 2*a");
+        nodes = e.size();
+        Polinom result = e.evaluate([&](const std::string& name) { return *store.find(name); });
+        formatPolinom(result);
+        events = tracing::collect();
+    }
+    EXPECT_EQ(countNamed(events, "parse_expression"), 1u);
+    EXPECT_EQ(countNamed(events, "evaluate"), 1u);
+    EXPECT_EQ(countNamed(events, "eval_node"), nodes);
+    EXPECT_EQ(countNamed(events, "store_lookup"), 1u);
+    EXPECT_EQ(countNamed(events, "format"), 1u);
+}
+
+TEST(Trace, ParallelEvaluationRecordsPlanAndNodesOnWorkers) {
+    std::map<std::string, Polinom> table{ { "a", Polinom("x+1") }, { "b", Polinom("y-1") } };
+    Expression e("a*b + (a-b)*(a+b)");
+    TaskScheduler pool(2);
+    std::vector<tracing::Event> events;
+    {
+        TraceSession session;
+        e.evaluate(table, pool);
+        events = tracing::collect();
+    }
+    EXPECT_EQ(countNamed(events, "plan"), 1u);
+    EXPECT_EQ(countNamed(events, "eval_node"), e.size());
+    uint32_t caller = 0;
+    for (const auto& ev : events)
+        if (std::string(ev.name) == "plan")
+            caller = ev.thread;
+    std::vector<bool> seen(e.size(), false);
+    for (const auto& ev : events) {
+        if (std::string(ev.name) != "eval_node")
+            continue;
+        EXPECT_NE(ev.thread, caller);
+        ASSERT_GE(ev.arg, 0);
+        ASSERT_LT(static_cast<size_t>(ev.arg), e.size());
+        seen[static_cast<size_t>(ev.arg)] = true;
+    }
+    EXPECT_EQ(std::count(seen.begin(), seen.end(), true), static_cast<long>(e.size()));
+}
+
+TEST(Trace, FullRingKeepsNewestSpans) {
+    const size_t extra = 10;
+    std::vector<tracing::Event> events;
+    {
+        TraceSession session;
+        std::thread([&] {
+            for (size_t i = 0; i < tracing::detail::ThreadBuffer::kCapacity + extra; ++i)
+                tracing::Span span("ring", static_cast<int64_t>(i));
+        }).join();
+        events = tracing::collect();
+    }
+    ASSERT_EQ(countNamed(events, "ring"), tracing::detail::ThreadBuffer::kCapacity);
+    int64_t lowest = INT64_MAX;
+    for (const auto& e : events)
+        lowest = std::min(lowest, e.arg);
+    EXPECT_EQ(lowest, static_cast<int64_t>(extra));
+}
+
+TEST(Trace, ExitedThreadBuffersAreReleased) {
+    TraceSession session;
+    size_t before = tracing::detail::registry().bufferCount();
+    for (int round = 0; round < 4; ++round) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t)
+            threads.emplace_back([] { POLINOM_TRACE_SPAN("short_lived"); });
+        for (auto& t : threads)
+            t.join();
+    }
+    EXPECT_GE(tracing::detail::registry().bufferCount(), before + 32);
+    EXPECT_EQ(countNamed(tracing::collect(), "short_lived"), 32u);
+    EXPECT_LE(tracing::detail::registry().bufferCount(), before);
+    EXPECT_EQ(countNamed(tracing::collect(), "short_lived"), 0u);
+
+    std::thread([] { POLINOM_TRACE_SPAN("short_lived"); }).join();
+    tracing::clear();
+    EXPECT_LE(tracing::detail::registry().bufferCount(), before);
+}
+
+TEST(Trace, CollectWhileRecordingSeesOnlyCompleteSpans) {
+    std::atomic<bool> stop{ false };
+    TraceSession session;
+    std::thread writer([&] {
+        int64_t i = 0;
+        while (!stop.load())
+            tracing::Span span("busy", i++);
+    });
+    for (int round = 0; round < 50; ++round) {
+        for (const auto& e : tracing::collect()) {
+            ASSERT_NE(e.name, nullptr);
+            EXPECT_STREQ(e.name, "busy");
+            EXPECT_GE(e.arg, 0);
+        }
+    }
+    stop = true;
+    writer.join();
+}
+
+TEST(Trace, WritesChromeTraceJson) {
+    std::vector<tracing::Event> events(2);
+    events[0].name = "quote\"d";
+    events[0].thread = 3;
+    events[0].start = 1234567;
+    events[0].duration = 5;
+    events[1].name = "node";
+    events[1].thread = 4;
+    events[1].arg = 12;
+    events[1].start = 2000;
+    events[1].duration = 1000;
+
+    std::ostringstream out;
+    tracing::writeChromeTrace(out, events);
+    std::string json = out.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("{\"name\":\"quote\\\"d\",\"cat\":\"polinom\",\"ph\":\"X\",\"pid\":1,\"tid\":3,"
+        "\"ts\":1234.567,\"dur\":0.005}"), std::string::npos);
+    EXPECT_NE(json.find("\"tid\":4,\"ts\":2.000,\"dur\":1.000,\"args\":{\"index\":12}}"), std::string::npos);
+    EXPECT_NE(json.find("\n]}"), std::string::npos);
+}
@@ -0,0 +1,169 @@
+#include "tracking.h"
+#include "polinomstore.h"
+#include "shardedstore.h"
+#include "tlist.h"
+#include <gtest.h>
+#include <thread>
+
+namespace {
+
+// Term list long enough to spill out of the inline storage.
+std::string longPolinom(int terms) {
+    std::string text;
+    for (int d = 0; d < terms; ++d)
+        text += "+" + std::to_string(d + 1) + "x^" + std::to_string(d / 100) + "y^" + std::to_string(d / 10 % 10)
+            + "z^" + std::to_string(d % 10);
+    return text;
+}
+
+// Installs a TrackingResource as the default resource for one scope.
+struct DefaultTracking {
+    TrackingResource tracking;
+    std::pmr::memory_resource* previous;
+
+    DefaultTracking() : previous(std::pmr::set_default_resource(&tracking)) {}
+    ~DefaultTracking() { std::pmr::set_default_resource(previous); }
+};
+
+}
+
+TEST(TrackingResource, CountsAndForwardsToUpstream) {
+    std::pmr::monotonic_buffer_resource upstream;
+    TrackingResource tracking(&upstream);
+    void* a = tracking.allocate(100, 8);
+    void* b = tracking.allocate(40, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0u);
+
+    AllocStats s = tracking.stats(AllocTag::Untagged);
+    EXPECT_EQ(s.allocations, 2u);
+    EXPECT_EQ(s.bytesAllocated, 140u);
+    EXPECT_EQ(s.liveBytes, 140u);
+    tracking.deallocate(a, 100, 8);
+    s = tracking.stats(AllocTag::Untagged);
+    EXPECT_EQ(s.deallocations, 1u);
+    EXPECT_EQ(s.liveBytes, 40u);
+    EXPECT_EQ(s.peakLiveBytes, 140u);
+    tracking.deallocate(b, 40, 64);
+    EXPECT_EQ(tracking.total().liveBytes, 0u);
+    EXPECT_EQ(tracking.total().peakLiveBytes, 140u);
+    EXPECT_EQ(tracking.upstreamResource(), &upstream);
+}
+
+TEST(TrackingResource, FreesAreCreditedToTheAllocatingTag) {
+    TrackingResource tracking;
+    void* p;
+    {
+        AllocScope scope(AllocTag::Parse);
+        p = tracking.allocate(64, 8);
+    }
+    {
+        AllocScope scope(AllocTag::Add);
+        tracking.deallocate(p, 64, 8);
+    }
+    EXPECT_EQ(tracking.stats(AllocTag::Parse).deallocations, 1u);
+    EXPECT_EQ(tracking.stats(AllocTag::Parse).liveBytes, 0u);
+    EXPECT_EQ(tracking.stats(AllocTag::Add).deallocations, 0u);
+}
+
+TEST(TrackingResource, OutermostScopeWins) {
+    EXPECT_EQ(currentAllocTag(), AllocTag::Untagged);
+    {
+        AllocScope outer(AllocTag::Multiply);
+        AllocScope inner(AllocTag::Add);
+        EXPECT_EQ(currentAllocTag(), AllocTag::Multiply);
+    }
+    EXPECT_EQ(currentAllocTag(), AllocTag::Untagged);
+}
+
+TEST(TrackingResource, ResetStatsRestartsPeaks) {
+    TrackingResource tracking;
+    void* big = tracking.allocate(1000, 8);
+    tracking.deallocate(big, 1000, 8);
+    void* small = tracking.allocate(10, 8);
+    tracking.resetStats();
+    AllocStats s = tracking.total();
+    EXPECT_EQ(s.allocations, 0u);
+    EXPECT_EQ(s.bytesAllocated, 0u);
+    EXPECT_EQ(s.liveBytes, 10u);
+    EXPECT_EQ(s.peakLiveBytes, 10u);
+    tracking.deallocate(small, 10, 8);
+}
+
+TEST(TrackingResource, CountsListNodesThroughTheDefaultResource) {
+    DefaultTracking scope;
+    {
+        List<int> list;
+        for (int i = 0; i < 1000; ++i)
+            list.append(i);
+        EXPECT_GT(scope.tracking.total().allocations, 0u);
+    }
+    EXPECT_EQ(scope.tracking.total().liveBytes, 0u);
+}
+
+TEST(TrackingResource, ConcurrentUseBalances) {
+    TrackingResource tracking;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&tracking] {
+            AllocScope scope(AllocTag::StoreInsert);
+            for (int i = 0; i < 1000; ++i)
+                tracking.deallocate(tracking.allocate(32, 8), 32, 8);
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    AllocStats s = tracking.stats(AllocTag::StoreInsert);
+    EXPECT_EQ(s.allocations, 4000u);
+    EXPECT_EQ(s.deallocations, 4000u);
+    EXPECT_EQ(s.liveBytes, 0u);
+    EXPECT_LE(s.peakLiveBytes, 4 * 32u);
+}
+
+#if POLINOM_METRICS
+
+TEST(TrackingResource, AttributesPolinomOperations) {
+    std::string text = longPolinom(60);
+    DefaultTracking scope;
+    {
+        Polinom a(text);
+        Polinom b = a + a;
+        Polinom c = a - Polinom("x");
+        Polinom d = a * Polinom("1+x+x^2+x^3+x^4+y+y^2+y^3+y^4");
+        Polinom e = a * 3.0;
+        EXPECT_GT(scope.tracking.stats(AllocTag::Parse).allocations, 0u);
+        EXPECT_GT(scope.tracking.stats(AllocTag::Add).allocations, 0u);
+        EXPECT_GT(scope.tracking.stats(AllocTag::Subtract).allocations, 0u);
+        EXPECT_GT(scope.tracking.stats(AllocTag::Multiply).allocations, 0u);
+        EXPECT_GT(scope.tracking.stats(AllocTag::Scale).allocations, 0u);
+        EXPECT_EQ(scope.tracking.stats(AllocTag::Add).liveBytes,
+            scope.tracking.stats(AllocTag::Add).bytesAllocated);
+    }
+    for (unsigned t = 0; t < static_cast<unsigned>(AllocTag::Count); ++t)
+        EXPECT_EQ(scope.tracking.stats(static_cast<AllocTag>(t)).liveBytes, 0u) << allocTagName(static_cast<AllocTag>(t));
+}
+
+TEST(TrackingResource, AttributesStoreInserts) {
+    Polinom value(longPolinom(40));
+    DefaultTracking scope;
+    {
+        ShardedPolinomStore sharded(2);
+        sharded.insert("a", value);
+        PolinomStore store;
+        store.insertOrAssign("a", value);
+        EXPECT_GT(scope.tracking.stats(AllocTag::StoreInsert).allocations, 1u);
+        EXPECT_GE(scope.tracking.stats(AllocTag::StoreInsert).peakLiveBytes, 2 * 40 * sizeof(Monom));
+    }
+    EXPECT_EQ(scope.tracking.stats(AllocTag::StoreInsert).liveBytes, 0u);
+}
+
+TEST(TrackingResource, ReportListsActiveTags) {
+    DefaultTracking scope;
+    Polinom a(longPolinom(30));
+    std::string report = scope.tracking.report();
+    EXPECT_EQ(report.rfind("operation", 0), 0u);
+    EXPECT_NE(report.find("\nparse "), std::string::npos);
+    EXPECT_NE(report.find("\ntotal "), std::string::npos);
+    EXPECT_EQ(report.find("\nmultiply "), std::string::npos);
+}
+
+#endif
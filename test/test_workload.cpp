@@ -0,0 +1,189 @@
+#include "workload.h"
+#include "expression.h"
+#include <gtest.h>
+#include <sstream>
+
+static int maxPowerOf(const Polinom& p) {
+    int result = 0;
+    for (const Monom& m : p.getMonoms())
+        result = std::max({ result, m.degree / 100, m.degree / 10 % 10, m.degree % 10 });
+    return result;
+}
+
+TEST(Workload, RandomIsReproducible) {
+    WorkloadRandom a(123), b(123), c(124);
+    bool differs = false;
+    for (int i = 0; i < 100; ++i) {
+        uint64_t x = a.next();
+        EXPECT_EQ(x, b.next());
+        differs |= x != c.next();
+    }
+    EXPECT_TRUE(differs);
+    WorkloadRandom r(5);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_LT(r.below(7), 7u);
+        double u = r.uniform();
+        EXPECT_GE(u, 0.0);
+        EXPECT_LT(u, 1.0);
+    }
+}
+
+TEST(Workload, SameSeedSamePolinoms) {
+    PolinomSpec spec;
+    spec.coefficients = CoeffDistribution::Uniform;
+    auto a = generatePolinoms(spec, 20, 9), b = generatePolinoms(spec, 20, 9);
+    for (size_t i = 0; i < a.size(); ++i)
+        EXPECT_TRUE(a[i].identical(b[i]));
+    EXPECT_FALSE(a[0].identical(generatePolinoms(spec, 1, 10)[0]));
+}
+
+TEST(Workload, TermCountDensityAndMaxPower) {
+    WorkloadRandom rng(1);
+    PolinomSpec spec;
+    spec.terms = 40;
+    spec.maxPower = 3;
+    Polinom p = generatePolinom(spec, rng);
+    EXPECT_EQ(p.size(), 40u);
+    EXPECT_LE(maxPowerOf(p), 3);
+
+    spec.terms = 1000;
+    EXPECT_EQ(generatePolinom(spec, rng).size(), 64u);
+
+    spec.density = 0.5;
+    EXPECT_EQ(generatePolinom(spec, rng).size(), 32u);
+}
+
+TEST(Workload, ExponentDecayFavoursLowPowers) {
+    PolinomSpec uniform, skewed;
+    uniform.terms = skewed.terms = 50;
+    skewed.exponentDecay = 0.3;
+    auto totalDegree = [](const std::vector<Polinom>& ps) {
+        long total = 0;
+        for (const Polinom& p : ps)
+            for (const Monom& m : p.getMonoms())
+                total += m.degree / 100 + m.degree / 10 % 10 + m.degree % 10;
+        return total;
+    };
+    EXPECT_LT(totalDegree(generatePolinoms(skewed, 20, 3)) * 2, totalDegree(generatePolinoms(uniform, 20, 3)));
+}
+
+TEST(Workload, CoefficientDistributions) {
+    WorkloadRandom rng(8);
+    PolinomSpec spec;
+    spec.coeffMax = 5;
+    Polinom integers = generatePolinom(spec, rng);
+    for (const Monom& m : integers.getMonoms()) {
+        EXPECT_EQ(m.coeff, std::round(m.coeff));
+        EXPECT_GE(std::abs(m.coeff), 1.0);
+        EXPECT_LE(std::abs(m.coeff), 5.0);
+    }
+    spec.coefficients = CoeffDistribution::LogUniform;
+    spec.coeffMax = 1000;
+    Polinom logUniform = generatePolinom(spec, rng);
+    for (const Monom& m : logUniform.getMonoms()) {
+        EXPECT_GE(std::abs(m.coeff), 1e-3);
+        EXPECT_LE(std::abs(m.coeff), 1e3);
+    }
+    spec.coeffMax = 0.5;
+    EXPECT_THROW(generatePolinom(spec, rng), std::invalid_argument);
+}
+
+TEST(Workload, ZipfSkewsTowardsLowRanks) {
+    WorkloadRandom rng(2);
+    ZipfSampler zipf(1000, 1.0), flat(1000, 0.0);
+    int hotZipf = 0, hotFlat = 0;
+    for (int i = 0; i < 20000; ++i) {
+        hotZipf += zipf(rng) < 10;
+        hotFlat += flat(rng) < 10;
+    }
+    // The top 1% of keys draws ~39% of a Zipf(1) sample and ~1% of a flat one.
+    EXPECT_GT(hotZipf, 6000);
+    EXPECT_LT(hotFlat, 600);
+}
+
+TEST(Workload, TraceFollowsMix) {
+    TraceSpec spec;
+    spec.operations = 20000;
+    spec.keys = 64;
+    spec.lookupPercent = 50;
+    spec.insertPercent = 30;
+    spec.erasePercent = 10;
+    spec.evaluatePercent = 10;
+    std::vector<StoreOp> trace = generateTrace(spec, 11);
+    int counts[4] = {};
+    for (const StoreOp& op : trace) {
+        ++counts[static_cast<int>(op.kind)];
+        EXPECT_LT(op.key, 64u);
+        if (op.kind == StoreOp::Kind::Insert) {
+            EXPECT_EQ(op.value.size(), 8u);
+        }
+        if (op.kind == StoreOp::Kind::Evaluate) {
+            EXPECT_FALSE(Expression(op.expression).variables().empty());
+        }
+    }
+    EXPECT_NEAR(counts[0], 6000, 400);   // insert
+    EXPECT_NEAR(counts[1], 10000, 400);  // lookup
+    EXPECT_NEAR(counts[2], 2000, 300);   // erase
+    EXPECT_NEAR(counts[3], 2000, 300);   // evaluate
+
+    spec.erasePercent = 11;
+    EXPECT_THROW(generateTrace(spec, 11), std::invalid_argument);
+}
+
+static void expectSameTrace(const std::vector<StoreOp>& a, const std::vector<StoreOp>& b) {
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].kind, b[i].kind);
+        EXPECT_EQ(a[i].key, b[i].key);
+        EXPECT_TRUE(a[i].value.identical(b[i].value));
+        EXPECT_EQ(a[i].expression, b[i].expression);
+    }
+}
+
+TEST(Workload, TraceTextRoundTrip) {
+    TraceSpec spec;
+    spec.operations = 500;
+    spec.values.coefficients = CoeffDistribution::Uniform;
+    std::vector<StoreOp> trace = generateTrace(spec, 4);
+    std::stringstream text;
+    text << "# generated\n\n";
+    writeTraceText(text, trace);
+    expectSameTrace(readTraceText(text), trace);
+
+    std::istringstream bad("delete p1\n");
+    EXPECT_THROW(readTraceText(bad), std::runtime_error);
+}
+
+TEST(Workload, TraceBinaryRoundTrip) {
+    TraceSpec spec;
+    spec.operations = 500;
+    spec.values.coefficients = CoeffDistribution::LogUniform;
+    std::vector<StoreOp> trace = generateTrace(spec, 4);
+    std::vector<uint8_t> bytes;
+    writeTraceBinary(bytes, trace);
+    expectSameTrace(readTraceBinary(bytes), trace);
+
+    bytes.pop_back();
+    EXPECT_THROW(readTraceBinary(bytes), std::runtime_error);
+}
+
+TEST(Workload, PolinomFilesRoundTrip) {
+    PolinomSpec spec;
+    spec.coefficients = CoeffDistribution::Uniform;
+    std::vector<Polinom> polinoms = generatePolinoms(spec, 30, 6);
+
+    std::stringstream text;
+    writePolinomsText(text, polinoms);
+    std::vector<Polinom> fromText = readPolinomsText(text);
+    std::vector<uint8_t> bytes;
+    writePolinomsBinary(bytes, polinoms);
+    std::vector<Polinom> fromBinary = readPolinomsBinary(bytes);
+
+    ASSERT_EQ(fromText.size(), polinoms.size());
+    ASSERT_EQ(fromBinary.size(), polinoms.size());
+    for (size_t i = 0; i < polinoms.size(); ++i) {
+        EXPECT_TRUE(fromText[i].identical(polinoms[i]));
+        EXPECT_TRUE(fromBinary[i].identical(polinoms[i]));
+    }
+    EXPECT_THROW(readTraceBinary(bytes), std::runtime_error);
+}